@@ -2,27 +2,37 @@
 
 #include "app/controllers/player_controller.h"
 #include "app/controllers/game_sessions_controller.h"
+#include "app/game_state_cache.h"
+#include "app/journal.h"
 #include "app/player.h"
+#include "app/record_sink.h"
+#include "app/state_saver.h"
 #include "app/use_cases_impl.h"
 #include "datetime/ticker.h"
 #include "model/game.h"
 #include "model/game_session.h"
 #include "model/map.h"
+#include "utils/epoch.h"
 #include "utils/tagged.h"
 #include "serde/archive.h"
+#include "serde/journal.h"
+#include "serde/snapshot.h"
+#include "metrics/metrics.h"
 #include "postgres/database.h"
 
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/strand.hpp>
-#include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 
 #include <chrono>
 #include <format>
 #include <iomanip>
+#include <optional>
 #include <random>
 #include <sstream>
+#include <string_view>
 #include <unordered_map>
+#include <variant>
 #include <vector>
 #include <fstream>
 #include <filesystem>
@@ -57,12 +67,27 @@ struct LootConfig {
 struct SaveStateConfig {
     std::string state_file;
     std::chrono::milliseconds save_period{0};
+    // Периодическое сохранение записывает файл в отдельном потоке, не
+    // задерживая тик
+    bool in_background = false;
+    // Сколько снимков может ждать записи в фоновом режиме
+    size_t max_backlog = 2;
+    // Если не ноль, вход игроков, их команды и результаты тиков между
+    // снимками дописываются в журнал рядом с файлом состояния и
+    // сбрасываются на диск с этим периодом
+    std::chrono::milliseconds journal_commit_period{0};
+    // Если журнал с последнего снимка вырос на столько байт, снимок
+    // сохраняется, не дожидаясь save_period. Это ограничивает размер
+    // журнала и время его применения при запуске
+    uint64_t journal_snapshot_size = uint64_t(64) << 20;
 };
 
 struct ApplicationConfig {
     LootConfig loot;
     SaveStateConfig save_state;
     postgres::DatabaseConfig database;
+    RecordSinkConfig records;
+    unsigned threads_count = 1;
 };
 
 class Application {
@@ -70,6 +95,7 @@ class Application {
     using Strand = net::strand<net::io_context::executor_type>;
 
     using Players = std::vector<PlayerHolder>;
+    using PlayersWithTokens = std::vector<std::pair<Token, PlayerHolder>>;
     using GameSessions = std::vector<model::GameSessionHolder>;
 
     Application(
@@ -78,9 +104,16 @@ class Application {
         io_(io),
         strand_(net::make_strand(io)),
         game_(std::move(game)),
-        game_sessions_(io_, strand_, game_, config.loot.tick_period),
+        game_sessions_(
+            io_, strand_, game_, config.loot.tick_period, config.threads_count
+        ),
         config_(config),
         db_(config_.database) {
+        if (const auto& state_file = config_.save_state.state_file;
+            !state_file.empty()) {
+            fs::create_directory(fs::path(state_file).parent_path());
+            state_saver_.emplace(state_file, config_.save_state.max_backlog);
+        }
         RestoreGameState();
 
         const auto tick_period = config.loot.tick_period;
@@ -103,6 +136,10 @@ class Application {
         return game_.GetMaps();
     }
 
+    const model::Map* FindMap(std::string_view id) const {
+        return game_.FindMap(id);
+    }
+
     const model::Map* FindMap(const model::Map::Id& id) const {
         return game_.FindMap(id);
     }
@@ -111,22 +148,84 @@ class Application {
         return players_.FindPlayerBy(token) != nullptr;
     }
 
-    const Players& GetPlayers(const Token& token) {
-        return players_.GetPlayers(token);
+    // Игрок, которому выдан токен, или nullptr. Игрок может быть удалён из
+    // реестра в любой момент, поэтому запрос игрока ищет его один раз и
+    // дальше работает с полученным объектом
+    PlayerHolder FindPlayer(const Token& token) const {
+        return players_.FindPlayerBy(token);
+    }
+
+    // Strand сессии, в которой играет владелец токена, или nullptr, если
+    // такого игрока нет. Запросы игрока выполняются на этом strand
+    model::GameSession::Strand* FindPlayerStrand(const Token& token) {
+        if (auto player = players_.FindPlayerBy(token)) {
+            return &player->GetSession()->GetStrand();
+        }
+        return nullptr;
+    }
+
+    // Игроки сессии, в которой играет player
+    Players GetPlayers(const Player& player) const {
+        return players_.GetPlayers(*player.GetSession());
+    }
+
+    // Должен вызываться на strand сессии игрока
+    const model::GameSession::LostObjects&
+    GetLostObjects(const Player& player) const {
+        return player.GetSession()->GetLostObjects();
+    }
+
+    // Состояние сессии игрока, отрисованное render(players, lost_objects).
+    // Пока состояние не изменилось, игроки сессии получают одну и ту же
+    // строку. Должен вызываться на strand сессии игрока
+    template <typename Render>
+    GameStateCache::Body
+    GetGameStateBody(const Player& player, Render&& render) {
+        const model::GameSession& session = *player.GetSession();
+        return game_state_cache_.Get(session, [&] {
+            return render(GetPlayers(player), session.GetLostObjects());
+        });
+    }
+
+    // Изменения состояния сессии игрока после тика since или nullopt, если
+    // клиенту нужно полное состояние. Должен вызываться на strand сессии
+    std::optional<model::GameSession::Changes> GetGameStateChanges(
+        const Player& player, model::GameSession::Tick since
+    ) const {
+        return player.GetSession()->GetChangesSince(since);
     }
 
-    const model::GameSession::LostObjects& GetLostObjects(const Token& token) {
-        return players_.GetLostObjects(token);
+    // Должен вызываться на strand сессии игрока
+    model::GameSession::Tick GetGameStateTick(const Player& player) const {
+        return player.GetSession()->GetTick();
     }
 
     void UpdateGameState(const std::chrono::milliseconds& time_delta) {
-        game_sessions_.UpdateGameState(time_delta);
-        ProcessInactiveDogs();
+        metrics::ScopedTimer timer(tick_duration_);
+
+        ProcessRetiredDogs(game_sessions_.UpdateGameState(
+            time_delta,
+            [this](size_t, const model::GameSession& session) {
+                JournalSessionTick(session);
+            }
+        ));
+        // Удалённые из таблицы токенов игроки освобождаются через два тика,
+        // не дожидаясь, пока накопится очередь отложенных объектов
+        utils::epoch::Collect();
 
         time_without_save_ += time_delta;
-        if (time_without_save_ >= config_.save_state.save_period) {
+        if (time_without_save_ >= config_.save_state.save_period ||
+            IsJournalFull()) {
             time_without_save_ = std::chrono::milliseconds(0);
-            SaveGameState();
+            SaveGameStatePeriodically();
+        }
+
+        if (const auto age =
+                state_saver_ ? state_saver_->GetSnapshotAge() : std::nullopt) {
+            snapshot_age_.Set(
+                std::chrono::duration_cast<std::chrono::milliseconds>(*age)
+                    .count()
+            );
         }
     }
 
@@ -142,30 +241,47 @@ class Application {
         auto player = std::make_shared<Player>(
             players_.GetFreePlayerId(), std::move(data.name)
         );
-        Token token = players_.AddPlayer(player);
         auto game_session = game_sessions_.FindGameSessionBy(data.map_id);
 
         if (!game_session) {
             game_session = game_sessions_.AddGameSession(*map);
         }
 
+        // Игрок становится доступен по токену только после того, как
+        // получил сессию и собаку
         SetPlayerGameSession(player, game_session);
+        Token token = players_.AddPlayer(player);
+
+        // Собака записывается в журнал до того, как её начнёт изменять
+        // сессия
+        if (journal_) {
+            journal_->Append([&](std::string& out) {
+                serde::journal::EncodeJoin(out, token, *player);
+            });
+        }
+        net::post(
+            game_session->GetStrand(),
+            [game_session, dog = player->GetDog()] {
+                game_session->AddDog(dog);
+            }
+        );
+        game_session->MarkStateChanged();
         return JoinGameResult{
             .token = std::move(token),
             .id = player->GetId(),
         };
     }
 
-    void MovePlayer(const Token& token, model::Direction direction) {
-        PlayerHolder player = players_.FindPlayerBy(token);
-        double dog_speed = player->GetSession()->GetMap().GetDogSpeed();
-        auto& dog = player->GetDog();
-
-        dog->SetSpeed(model::Speed(dog_speed, direction));
-        dog->SetDirection(direction);
+    // Должен вызываться на strand сессии игрока. player - владелец token
+    void MovePlayer(
+        const Token& token, Player& player, model::Direction direction
+    ) {
+        SetDogDirection(player, direction);
 
-        if (direction != model::Direction::NONE) {
-            dog->SetInactiveTime(std::chrono::milliseconds(0));
+        if (journal_) {
+            journal_->Append([&](std::string& out) {
+                serde::journal::EncodeMove(out, token, direction);
+            });
         }
     }
 
@@ -173,53 +289,226 @@ class Application {
         return ticker_ != nullptr;
     }
 
+    // Останавливает io_context. Тик, который ждёт сессии, перестаёт ждать
+    // задачи, которые уже не будут выполнены
+    void Stop() {
+        io_.stop();
+        game_sessions_.Stop();
+    }
+
+    // Сохраняет состояние и дожидается записи файла. При остановке сервера
+    // так записывается последнее состояние
     void SaveGameState() {
-        using namespace serde::archive;
-        const auto& state_file = config_.save_state.state_file;
-        if (state_file.empty()) {
+        if (!state_saver_) {
             return;
         }
+        const auto captured_at = StateSaver::Clock::now();
+        const uint64_t journal_position = RotateJournal();
+        state_saver_->Write(CaptureGameState(), captured_at, journal_position);
+        DiscardJournal();
+    }
 
-        fs::create_directory(fs::path(state_file).parent_path());
-
-        const std::string output_filename = state_file + ".tmp";
+    std::vector<PlayerRecord> GetPlayerRecords(const PlayerRecordsData& data) {
+        return use_cases_.GetPlayerRecords(data.start, data.max_items);
+    }
 
-        std::ofstream output(output_filename);
-        if (!output) {
-            throw std::runtime_error("Cannot open state file");
+  private:
+    // Кодирует состояние сессий в секции снимка. Каждая сессия кодируется
+    // на своём strand, поэтому захват не ждёт записи файла
+    StateSaver::Sections CaptureGameState() {
+        metrics::ScopedTimer timer(save_state_capture_duration_);
+
+        std::unordered_map<const model::GameSession*, PlayersWithTokens>
+            session_players;
+        for (auto& [token, player] : players_.GetPlayers()) {
+            session_players[player->GetSession().get()].emplace_back(
+                std::move(token), std::move(player)
+            );
         }
 
-        boost::archive::text_oarchive oarchive{output};
+        const auto& sessions = game_sessions_.GetSessions();
+        const PlayersWithTokens no_players;
+        StateSaver::Sections sections = state_saver_->TakeBuffers();
+        sections.resize(sessions.size());
+        game_sessions_.RunOnSessions(
+            [&](size_t index, const model::GameSession& session) {
+                const auto it = session_players.find(&session);
+                auto& section = sections[index];
+                section.clear();
+                serde::snapshot::EncodeSession(
+                    section, session,
+                    it != session_players.end() ? it->second : no_players
+                );
+            }
+        );
+        return sections;
+    }
 
-        std::vector<GameSessionRepr> game_sessions;
-        for (const auto& game_session : game_sessions_.GetSessions()) {
-            game_sessions.push_back(GameSessionRepr(*game_session));
+    void SaveGameStatePeriodically() {
+        if (!state_saver_ || !config_.save_state.in_background) {
+            SaveGameState();
+            return;
         }
+        const auto captured_at = StateSaver::Clock::now();
+        const uint64_t journal_position = RotateJournal();
+        state_saver_->Enqueue(
+            CaptureGameState(), captured_at, journal_position
+        );
+        DiscardJournal();
+    }
 
-        oarchive << game_sessions;
+    // Номер последней записи журнала, учтённой в захватываемом снимке.
+    // Записи, сделанные во время захвата, могут уже быть учтены в снимке:
+    // повторное применение записей при восстановлении ничего не меняет
+    uint64_t RotateJournal() {
+        return journal_ ? journal_->Rotate() : journal_position_;
+    }
 
-        std::vector<PlayerRepr> players;
-        for (const auto& [token, player] : players_.GetPlayers()) {
-            players.push_back(PlayerRepr(*player, token));
-        }
+    // Журнал нужно сменить снимком: он слишком вырос или его записи не
+    // удалось сохранить на диск
+    bool IsJournalFull() {
+        return journal_ &&
+            (journal_->HasFailed() ||
+             journal_->GetSizeSinceRotate() >=
+                 config_.save_state.journal_snapshot_size);
+    }
 
-        oarchive << players;
-        output.close();
-        fs::rename(output_filename, state_file);
+    // Удаляет сегменты журнала, учтённые в записанном снимке. В фоновом
+    // режиме это снимок одного из прошлых периодов
+    void DiscardJournal() {
+        if (journal_) {
+            journal_->Discard(state_saver_->GetJournalPosition());
+        }
     }
 
-    std::vector<PlayerRecord> GetPlayerRecords(const PlayerRecordsData& data) {
-        return use_cases_.GetPlayerRecords(data.start, data.max_items);
+    // Записывает в журнал результат тика сессии. Вызывается на strand
+    // сессии сразу после тика
+    void JournalSessionTick(const model::GameSession& session) {
+        if (!journal_) {
+            return;
+        }
+        const auto changes = session.GetChangesSince(session.GetTick() - 1);
+        if (!changes ||
+            (changes->changed_dogs.empty() && changes->removed_dogs.empty() &&
+             changes->added_lost_objects.empty() &&
+             changes->removed_lost_objects.empty())) {
+            return;
+        }
+        journal_->Append([&](std::string& out) {
+            serde::journal::EncodeSessionTick(out, session, *changes);
+        });
     }
 
-  private:
     void RestoreGameState() {
-        using namespace serde::archive;
         const auto& state_file = config_.save_state.state_file;
         if (state_file.empty()) {
             return;
         }
 
+        uint64_t journal_position = 0;
+        if (const auto snapshot =
+                serde::snapshot::MappedSnapshot::Open(state_file)) {
+            for (const auto section : snapshot->GetSessions()) {
+                RestoreGameSession(serde::snapshot::DecodeSession(section));
+            }
+            journal_position = snapshot->GetJournalPosition();
+        } else {
+            RestoreTextArchive(state_file);
+        }
+
+        // Журнал применяется, даже если сейчас он не ведётся: в нём
+        // изменения, не попавшие в снимок
+        journal_position_ = serde::journal::ReadJournal(
+            state_file, journal_position,
+            [&](uint64_t, std::string_view data) {
+                ReplayJournalRecord(serde::journal::DecodeRecord(data));
+            }
+        );
+
+        if (const auto period = config_.save_state.journal_commit_period;
+            period.count() != 0) {
+            journal_.emplace(state_file, journal_position_ + 1, period);
+        }
+    }
+
+    void ReplayJournalRecord(serde::journal::Record&& record) {
+        using namespace serde::journal;
+
+        if (auto* join = std::get_if<JoinRecord>(&record)) {
+            // Игрок мог войти во время захвата снимка и уже быть в нём
+            if (players_.HasPlayer(join->token)) {
+                return;
+            }
+            const model::Map* map = game_.FindMap(join->map_id);
+            if (!map) {
+                throw std::runtime_error("Unknown map");
+            }
+            auto game_session = game_sessions_.FindGameSessionBy(join->map_id);
+            if (!game_session) {
+                game_session = game_sessions_.AddGameSession(*map);
+            }
+            RestorePlayer(
+                game_session, join->player_id, std::move(join->name),
+                join->token, join->dog
+            );
+        } else if (auto* move = std::get_if<MoveRecord>(&record)) {
+            if (auto player = players_.FindPlayerBy(move->token)) {
+                SetDogDirection(*player, move->direction);
+            }
+        } else {
+            auto& tick = std::get<SessionTickRecord>(record);
+            auto game_session = game_sessions_.FindGameSessionBy(tick.map_id);
+            if (!game_session) {
+                throw std::runtime_error("Cannot find game session");
+            }
+            for (const auto& lost_object : tick.added_lost_objects) {
+                model::LostObject::ReserveId(lost_object.GetId());
+            }
+            players_.RemovePlayersByDogs(game_session->ApplyChanges(
+                tick.changed_dogs, tick.removed_dogs, tick.added_lost_objects,
+                tick.removed_lost_objects
+            ));
+        }
+    }
+
+    void RestoreGameSession(serde::snapshot::SessionState&& state) {
+        const model::Map* map = game_.FindMap(state.map_id);
+        if (!map) {
+            throw std::runtime_error("Unknown map");
+        }
+
+        auto game_session = game_sessions_.AddGameSession(*map);
+        for (auto& lost_object : state.lost_objects) {
+            model::LostObject::ReserveId(lost_object.GetId());
+            game_session->AddLostObject(std::move(lost_object));
+        }
+
+        for (auto& player_state : state.players) {
+            RestorePlayer(
+                game_session, player_state.id, std::move(player_state.name),
+                player_state.token, player_state.dog
+            );
+        }
+    }
+
+    void RestorePlayer(
+        const model::GameSessionHolder& game_session, Player::Id id,
+        std::string name, const Token& token, const model::Dog& dog_state
+    ) {
+        auto player = std::make_shared<Player>(id, std::move(name));
+        auto dog = std::make_shared<model::Dog>(dog_state);
+        dog->SetId(model::Dog::Id(*player->GetId()));
+        game_session->AddDog(dog);
+
+        player->SetGameSession(game_session);
+        player->SetDog(dog);
+        players_.AddPlayer(player, token);
+    }
+
+    // Состояние, сохранённое до перехода на двоичные снимки
+    void RestoreTextArchive(const std::string& state_file) {
+        using namespace serde::archive;
+
         std::ifstream input(state_file);
         if (!input) {
             return;
@@ -245,7 +534,6 @@ class Application {
 
         for (const auto& player_repr : players) {
             auto player = std::make_shared<Player>(player_repr.Restore());
-            players_.AddPlayer(player, player_repr.RestoreToken());
             auto game_session =
                 game_sessions_.FindGameSessionBy(player_repr.RestoreMapId());
 
@@ -254,37 +542,55 @@ class Application {
             }
 
             auto dog = std::make_shared<model::Dog>(player_repr.RestoreDog());
+            dog->SetId(model::Dog::Id(*player->GetId()));
             game_session->AddDog(dog);
 
             player->SetGameSession(game_session);
             player->SetDog(dog);
-            players_.SetPlayerSession(player, game_session);
+            players_.AddPlayer(player, player_repr.RestoreToken());
         }
     }
 
     void SetPlayerGameSession(
         const PlayerHolder& player, const model::GameSessionHolder& session
     ) {
+        auto dog = session->MakeDog(
+            config_.loot.randomize_spawn_points, random_engine_
+        );
+        dog->SetId(model::Dog::Id(*player->GetId()));
         player->SetGameSession(session);
-        player->SetDog(session->CreateDog(config_.loot.randomize_spawn_points));
-        players_.SetPlayerSession(player, session);
+        player->SetDog(std::move(dog));
+    }
+
+    // Должен вызываться на strand сессии игрока
+    void SetDogDirection(Player& player, model::Direction direction) {
+        double dog_speed = player.GetSession()->GetMap().GetDogSpeed();
+        auto& dog = player.GetDog();
+
+        dog->SetSpeed(model::Speed(dog_speed, direction));
+        dog->SetDirection(direction);
+
+        if (direction != model::Direction::NONE) {
+            dog->SetInactiveTime(std::chrono::milliseconds(0));
+        }
+        player.GetSession()->MarkDogChanged(*dog);
     }
 
-    void ProcessInactiveDogs() {
+    // Собаки уже удалены из сессий и больше не изменяются игрой
+    void ProcessRetiredDogs(const model::GameSession::Dogs& dogs) {
         std::vector<PlayerRecord> records;
 
-        for (const auto& player :
-             players_.RemoveInactivePlayers(game_.GetMaxInactiveTime())) {
+        for (const auto& player : players_.RemovePlayersByDogs(dogs)) {
+            player->GetSession()->MarkStateChanged();
             const auto& dog = player->GetDog();
             records.push_back(PlayerRecord{
                 player->GetName(),
                 dog->GetScore(),
                 dog->GetLiveTime(),
             });
-            player->GetSession()->RemoveDog(dog);
         }
 
-        use_cases_.SavePlayerRecords(records);
+        record_sink_.Enqueue(std::move(records));
     }
 
     net::io_context& io_;
@@ -293,9 +599,24 @@ class Application {
     model::Game game_;
     GameSessionsController game_sessions_;
     PlayersController players_;
+    GameStateCache game_state_cache_;
     ApplicationConfig config_;
+    // Точки появления новых собак. Используется на strand приложения
+    utils::RandomEngine random_engine_ {utils::MakeRandomSeed(0)};
     std::chrono::milliseconds time_without_save_{0};
+    std::optional<StateSaver> state_saver_;
+    std::optional<Journal> journal_;
+    // Номер последней записи журнала, прочитанной при восстановлении
+    uint64_t journal_position_ = 0;
     postgres::Database db_;
     app::UseCasesImpl use_cases_{db_.GetUnitOfWorkFactory()};
+    // Разрушается раньше базы данных и дописывает в неё очередь рекордов
+    RecordSink record_sink_{use_cases_, config_.records};
+    metrics::DurationStat& tick_duration_ =
+        metrics::Registry::Instance().GetDuration("tick");
+    metrics::DurationStat& save_state_capture_duration_ =
+        metrics::Registry::Instance().GetDuration("save_state_capture");
+    metrics::Gauge& snapshot_age_ =
+        metrics::Registry::Instance().GetGauge("state_snapshot_age_ms");
 };
 } // namespace app
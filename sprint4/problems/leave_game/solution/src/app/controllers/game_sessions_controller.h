@@ -2,8 +2,19 @@
 
 #include "model/game_session.h"
 #include "model/game.h"
+#include "metrics/metrics.h"
+#include "utils/random.h"
 
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
 
 namespace app {
 
@@ -16,10 +27,11 @@ class GameSessionsController {
 
     GameSessionsController(
         net::io_context& io, Strand& strand, model::Game& game,
-        std::chrono::milliseconds max_inactive_time
+        std::chrono::milliseconds max_inactive_time, unsigned threads_count = 1
     ) :
         io_(io),
-        game_(game) {}
+        game_(game),
+        threads_count_(threads_count) {}
 
     model::GameSessionHolder AddGameSession(const model::Map& map) {
         if (map_id_to_index_.contains(map.GetId())) {
@@ -28,7 +40,8 @@ class GameSessionsController {
 
         map_id_to_index_[map.GetId()] = sessions_.size();
         sessions_.push_back(std::make_shared<model::GameSession>(
-            io_, map, game_.GetLootGenerator(), game_.GetMaxInactiveTime()
+            io_, map, game_.GetLootGenerator(), game_.GetMaxInactiveTime(),
+            utils::MakeRandomSeed(GetRandomStream(map))
         ));
 
         return sessions_.back();
@@ -42,9 +55,60 @@ class GameSessionsController {
         return nullptr;
     }
 
-    void UpdateGameState(const std::chrono::milliseconds& time_delta) {
-        for (const auto& session : sessions_) {
-            session->UpdateGameState(time_delta);
+    // Обновляет состояние всех сессий и возвращает собак, отправленных на
+    // покой. Управление возвращается, когда обновлены все сессии
+    model::GameSession::Dogs
+    UpdateGameState(const std::chrono::milliseconds& time_delta) {
+        return UpdateGameState(time_delta, [](size_t, model::GameSession&) {});
+    }
+
+    // То же, но после обновления каждой сессии на её strand выполняется
+    // after_update(index, session)
+    template <typename AfterUpdate>
+    model::GameSession::Dogs UpdateGameState(
+        const std::chrono::milliseconds& time_delta, AfterUpdate&& after_update
+    ) {
+        metrics::ScopedTimer timer(sessions_tick_duration_);
+
+        std::vector<model::GameSession::Dogs> retired(sessions_.size());
+        RunOnSessions([&](size_t index, model::GameSession& session) {
+            retired[index] = session.UpdateGameState(time_delta);
+            after_update(index, session);
+        });
+
+        model::GameSession::Dogs result;
+        for (auto& dogs : retired) {
+            result.insert(result.end(), dogs.begin(), dogs.end());
+        }
+        return result;
+    }
+
+    // Выполняет task(index, session) для каждой сессии на её strand и
+    // дожидается завершения всех задач. Сессии обрабатываются параллельно.
+    // Если io_context обслуживает один поток или уже остановлен, задачи
+    // выполняются в вызывающем потоке
+    template <typename Task>
+    void RunOnSessions(Task&& task) {
+        if (threads_count_ < 2 || io_.stopped()) {
+            for (size_t i = 0; i < sessions_.size(); ++i) {
+                task(i, *sessions_[i]);
+            }
+            return;
+        }
+
+        RunOnSessionsInParallel(std::function<void(size_t)>([&](size_t i) {
+            task(i, *sessions_[i]);
+        }));
+    }
+
+    // Вызывается после остановки io_context: задачи RunOnSessions, которые
+    // ещё не начались, уже не будут выполнены, поэтому они отменяются, и
+    // ожидающий поток ждёт только начавшиеся
+    void Stop() {
+        std::lock_guard lock(running_mutex_);
+        is_stopped_ = true;
+        if (running_) {
+            running_->CancelNotStarted();
         }
     }
 
@@ -53,12 +117,115 @@ class GameSessionsController {
     }
 
   private:
+    // Общее состояние параллельного выполнения. Задачи владеют им
+    // совместно с ожидающим потоком, так как после остановки io_context
+    // ожидание прекращается, не дожидаясь запуска оставшихся задач
+    struct Join {
+        explicit Join(size_t tasks_count) :
+            started(tasks_count),
+            errors(tasks_count),
+            pending(tasks_count) {}
+
+        bool TryStart(size_t task) {
+            return !started[task].exchange(true);
+        }
+
+        void Finish() {
+            std::lock_guard lock(mutex);
+            if (--pending == 0) {
+                done.notify_all();
+            }
+        }
+
+        void CancelNotStarted() {
+            for (size_t i = 0; i < started.size(); ++i) {
+                if (TryStart(i)) {
+                    Finish();
+                }
+            }
+        }
+
+        void Wait() {
+            std::unique_lock lock(mutex);
+            done.wait(lock, [this] {
+                return pending == 0;
+            });
+        }
+
+        std::vector<std::atomic_bool> started;
+        std::vector<std::exception_ptr> errors;
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t pending;
+    };
+
+    void RunOnSessionsInParallel(const std::function<void(size_t)>& task) {
+        auto join = std::make_shared<Join>(sessions_.size());
+        {
+            // Stop мог быть вызван после проверки io_context в RunOnSessions
+            std::lock_guard lock(running_mutex_);
+            if (is_stopped_) {
+                join->CancelNotStarted();
+            }
+            running_ = join;
+        }
+
+        for (size_t i = 0; i < sessions_.size(); ++i) {
+            // Задача ссылается на task, поэтому выполняется только пока
+            // вызывающий поток её ждёт
+            net::post(sessions_[i]->GetStrand(), [join, &task, i] {
+                if (!join->TryStart(i)) {
+                    return;
+                }
+                try {
+                    task(i);
+                } catch (...) {
+                    join->errors[i] = std::current_exception();
+                }
+                join->Finish();
+            });
+        }
+
+        join->Wait();
+        {
+            std::lock_guard lock(running_mutex_);
+            running_.reset();
+        }
+
+        for (const auto& error : join->errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    // Поток случайных чисел сессии определяется положением её карты в
+    // игре, а не порядком создания сессий. Поток 0 остаётся приложению
+    uint64_t GetRandomStream(const model::Map& map) const {
+        const auto& maps = game_.GetMaps();
+        const auto it = std::find_if(
+            maps.begin(), maps.end(),
+            [&](const model::Map& other) {
+                return other.GetId() == map.GetId();
+            }
+        );
+        return static_cast<uint64_t>(it - maps.begin()) + 1;
+    }
+
     using MapIdToIndex = std::unordered_map<
         model::Map::Id, size_t, utils::TaggedHasher<model::Map::Id>>;
 
     net::io_context& io_;
     model::Game& game_;
+    unsigned threads_count_;
     GameSessions sessions_;
     MapIdToIndex map_id_to_index_;
+    // Параллельное выполнение, которое ждёт вызывающий поток. Задачи
+    // выполняются с одного strand приложения, поэтому оно одно
+    std::mutex running_mutex_;
+    std::shared_ptr<Join> running_;
+    bool is_stopped_ = false;
+    metrics::DurationStat& sessions_tick_duration_ =
+        metrics::Registry::Instance().GetDuration("sessions_tick");
 };
 } // namespace app
@@ -1,150 +1,164 @@
 #pragma once
 
 #include "app/player.h"
+#include "app/token_table.h"
+
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
 
 namespace app {
 
+/*
+ *  Реестр игроков. Методы потокобезопасны. Поиск игрока по токену не
+ *  использует блокировок, списки игроков сессий и индекс по собакам
+ *  читаются под разделяемой блокировкой.
+ */
 class PlayersController {
   public:
     using PlayerByToken =
-        std::unordered_map<Token, PlayerHolder, utils::TaggedHasher<Token>>;
+        std::unordered_map<Token, PlayerHolder, TokenHasher, TokenEqual>;
 
     PlayerHolder FindPlayerBy(const Token& token) const {
-        if (const auto it = players_.find(token); it != players_.end()) {
-            return it->second;
-        }
-        return nullptr;
+        return players_.Find(token).value_or(nullptr);
     }
 
     bool HasPlayer(const Token& token) const {
         return FindPlayerBy(token) != nullptr;
     }
 
+    // Игрок должен уже получить сессию и собаку: по ним он попадает в
+    // список игроков сессии и в индекс по собакам
     Token AddPlayer(PlayerHolder player) {
+        std::lock_guard lock(mutex_);
         Token token = GenerateToken();
-        AddPlayer(std::move(player), token);
+        Register(std::move(player), token);
         return token;
     }
 
-    void AddPlayer(PlayerHolder player, Token token) {
-        players_[token] = std::move(player);
-        free_id_++;
-    }
-
-    void SetPlayerSession(
-        const PlayerHolder& player, const model::GameSessionHolder& session
-    ) {
-        session_players_[session->GetId()].push_back(player);
+    void AddPlayer(PlayerHolder player, const Token& token) {
+        std::lock_guard lock(mutex_);
+        Register(std::move(player), token);
     }
 
-    const Players& GetPlayers(const Token& token) {
-        static const Players empty_list = {};
-
+    // Игроки сессии, в которой играет владелец токена
+    Players GetPlayers(const Token& token) const {
         auto player = FindPlayerBy(token);
         if (!player) {
             throw std::invalid_argument("Player doesn't exists");
         }
 
-        model::GameSessionHolder session = player->GetSession();
-
-        if (!session || !session_players_.contains(session->GetId())) {
-            return empty_list;
-        }
-
-        return session_players_[session->GetId()];
+        const model::GameSessionHolder& session = player->GetSession();
+        return session ? GetPlayers(*session) : Players {};
     }
 
-    const model::GameSession::LostObjects& GetLostObjects(const Token& token) {
-        static const model::GameSession::LostObjects empty_list = {};
-
-        auto player = FindPlayerBy(token);
-        if (!player) {
-            throw std::invalid_argument("Player doesn't exists");
-        }
-
-        const auto& session = player->GetSession();
-
-        if (!session || !session_players_.contains(session->GetId())) {
-            return empty_list;
+    Players GetPlayers(const model::GameSession& session) const {
+        std::shared_lock lock(mutex_);
+        if (auto it = session_players_.find(session.GetId());
+            it != session_players_.end()) {
+            return it->second;
         }
-
-        return session->GetLostObjects();
+        return {};
     }
 
-    const PlayerByToken& GetPlayers() const {
-        return players_;
+    PlayerByToken GetPlayers() const {
+        PlayerByToken result;
+        players_.ForEach([&](const Token& token, const PlayerHolder& player) {
+            result.emplace(token, player);
+        });
+        return result;
     }
 
     Player::Id GetFreePlayerId() const {
+        std::shared_lock lock(mutex_);
         return Player::Id(free_id_);
     }
 
-    PlayerHolder GetPlayerByDog(const model::DogHolder& dog) {
-        auto it = std::find_if(
-            players_.begin(), players_.end(),
-            [&](const auto& data) {
-                const PlayerHolder& player = data.second;
-                return player->GetDog() == dog;
-            }
-        );
-        if (it == players_.end()) {
-            return nullptr;
+    PlayerHolder GetPlayerByDog(const model::DogHolder& dog) const {
+        std::shared_lock lock(mutex_);
+        if (auto it = players_by_dog_.find(dog.get());
+            it != players_by_dog_.end()) {
+            return it->second.player;
         }
-        return it->second;
+        return nullptr;
     }
 
+    // Удаляет игроков, которым принадлежат собаки dogs, и возвращает их.
+    // Работа пропорциональна количеству собак, а не всех игроков
     std::vector<PlayerHolder>
-    RemoveInactivePlayers(const std::chrono::milliseconds& max_inactive_time) {
-        for (auto& [_, players] : session_players_) {
-            std::erase_if(players, [&](const auto& player) {
-                return player->GetDog()->GetInactiveTime() >= max_inactive_time;
-            });
-        }
-
+    RemovePlayersByDogs(const model::GameSession::Dogs& dogs) {
         std::vector<PlayerHolder> result;
-        for (const auto& [_, player] : players_) {
-            if (player->GetDog()->GetInactiveTime() >= max_inactive_time) {
-                result.push_back(player);
-            }
+        if (dogs.empty()) {
+            return result;
         }
 
-        std::erase_if(players_, [&](const auto& data) {
-            const PlayerHolder& player = data.second;
-            return player->GetDog()->GetInactiveTime() >= max_inactive_time;
-        });
+        std::lock_guard lock(mutex_);
+        for (const auto& dog : dogs) {
+            auto it = players_by_dog_.find(dog.get());
+            if (it == players_by_dog_.end()) {
+                continue;
+            }
 
+            PlayerEntry entry = std::move(it->second);
+            players_by_dog_.erase(it);
+            players_.Erase(entry.token);
+            RemoveFromSession(*entry.player, entry.session_index);
+            result.push_back(std::move(entry.player));
+        }
         return result;
     }
 
     void RemovePlayerByDog(const model::DogHolder& dog) {
-        for (auto& [_, players] : session_players_) {
-            std::erase_if(players, [&](const auto& player) {
-                return player->GetDog() == dog;
-            });
-        }
-
-        std::erase_if(players_, [&](const auto& data) {
-            const PlayerHolder& player = data.second;
-            return player->GetDog() == dog;
-        });
+        RemovePlayersByDogs({dog});
     }
 
   private:
     using Distribution =
         std::uniform_int_distribution<std::mt19937_64::result_type>;
 
-    Token GenerateToken() {
-        constexpr size_t token_size = 16;
-        std::stringstream ss;
+    struct PlayerEntry {
+        Token token;
+        PlayerHolder player;
+        // Позиция игрока в списке игроков его сессии
+        size_t session_index = 0;
+    };
+
+    // Вызывается под мьютексом
+    void Register(PlayerHolder player, const Token& token) {
+        const auto& session = player->GetSession();
+        const auto& dog = player->GetDog();
+        if (session && dog) {
+            auto& players = session_players_[session->GetId()];
+            players_by_dog_.insert_or_assign(
+                dog.get(),
+                PlayerEntry {
+                    .token = token,
+                    .player = player,
+                    .session_index = players.size(),
+                }
+            );
+            players.push_back(player);
+        }
 
-        const auto add_hex_number = [&](auto x) {
-            ss << std::setfill('0') << std::setw(token_size) << std::hex << x;
-        };
+        // Восстановленные игроки сохраняют свои идентификаторы
+        free_id_ = std::max(free_id_, *player->GetId() + 1);
+        players_.InsertOrAssign(token, std::move(player));
+    }
 
-        add_hex_number(generator1_());
-        add_hex_number(generator2_());
+    // Удаляет игрока из списка сессии, перемещая на его место последнего
+    // игрока. Вызывается под мьютексом
+    void RemoveFromSession(const Player& player, size_t index) {
+        auto& players = session_players_.at(player.GetSession()->GetId());
+        if (index + 1 != players.size()) {
+            players[index] = std::move(players.back());
+            players_by_dog_.at(players[index]->GetDog().get()).session_index =
+                index;
+        }
+        players.pop_back();
+    }
 
-        return Token{ss.str()};
+    Token GenerateToken() {
+        return Token {generator1_(), generator2_()};
     }
 
     std::mt19937_64 MakeGenerator() {
@@ -152,8 +166,11 @@ class PlayersController {
         return std::mt19937_64(dist(random_device_));
     }
 
+    // Защищает всё, кроме players_, у которой своя синхронизация
+    mutable std::shared_mutex mutex_;
     size_t free_id_ = 0;
-    PlayerByToken players_;
+    TokenTable<PlayerHolder> players_;
+    std::unordered_map<const model::Dog*, PlayerEntry> players_by_dog_;
     std::unordered_map<
         model::GameSession::Id, Players,
         utils::TaggedHasher<model::GameSession::Id>>
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "model/game_session.h"
+#include "metrics/metrics.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace app {
+
+/*
+ *  Отрисованное состояние игровых сессий. Пока версия состояния сессии не
+ *  изменилась, все её игроки получают одну и ту же неизменяемую строку.
+ *  Get для одной сессии должен вызываться на её strand, для разных сессий
+ *  может вызываться одновременно. Сессии должны жить дольше кэша.
+ */
+class GameStateCache {
+  public:
+    using Body = std::shared_ptr<const std::string>;
+
+    // render() -> std::string вызывается только при промахе
+    template <typename Render>
+    Body Get(const model::GameSession& session, Render&& render) {
+        // Версия читается до отрисовки: если состояние изменится во время
+        // неё, следующий запрос промахнётся и отрисует его заново
+        const uint64_t version = session.GetStateVersion();
+        {
+            std::shared_lock lock(mutex_);
+            if (auto it = entries_.find(&session);
+                it != entries_.end() && it->second.version == version) {
+                hits_.Increment();
+                return it->second.body;
+            }
+        }
+
+        misses_.Increment();
+        auto body = std::make_shared<const std::string>(render());
+
+        std::lock_guard lock(mutex_);
+        entries_[&session] = Entry {version, body};
+        return body;
+    }
+
+  private:
+    struct Entry {
+        uint64_t version;
+        Body body;
+    };
+
+    std::shared_mutex mutex_;
+    std::unordered_map<const model::GameSession*, Entry> entries_;
+    metrics::Counter& hits_ =
+        metrics::Registry::Instance().GetCounter("game_state_cache_hits");
+    metrics::Counter& misses_ =
+        metrics::Registry::Instance().GetCounter("game_state_cache_misses");
+};
+
+} // namespace app
@@ -0,0 +1,322 @@
+#pragma once
+
+#include "logger/report.h"
+#include "metrics/metrics.h"
+#include "serde/journal.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace app {
+
+/*
+ *  Дописывает записи журнала состояния (см. serde/journal.h). Записи
+ *  накапливаются в памяти и раз в commit_period записываются одним
+ *  вызовом write и сбрасываются на диск одним fdatasync в отдельном
+ *  потоке: сколько бы записей ни появилось за период, диск ждёт только
+ *  этот поток. При сбое теряются записи не более чем за один период.
+ *
+ *  Append может вызываться из любого потока. Порядок записей совпадает с
+ *  порядком вызовов Append.
+ */
+class Journal {
+  public:
+    // first - номер первой записи. Он должен быть больше номеров всех
+    // записей журнала, применённых при восстановлении
+    Journal(
+        std::filesystem::path state_file, uint64_t first,
+        std::chrono::milliseconds commit_period
+    ) :
+        state_file_(std::move(state_file)),
+        commit_period_(commit_period),
+        segments_(serde::journal::ListSegments(state_file_)),
+        last_(first - 1) {
+        // Сегменты без записей могли остаться после сбоя, а сегменты после
+        // пропуска в нумерации не были применены и уже не будут
+        std::erase_if(segments_, [first](const auto& segment) {
+            if (segment.start < first) {
+                return false;
+            }
+            std::error_code ec;
+            std::filesystem::remove(segment.path, ec);
+            return true;
+        });
+        pending_.push_back(Batch {.start = first, .data = {}});
+        worker_ = std::thread([this] {
+            Run();
+        });
+    }
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Записывает накопленные записи
+    ~Journal() {
+        {
+            std::lock_guard lock(mutex_);
+            is_stopped_ = true;
+        }
+        commit_ready_.notify_one();
+        worker_.join();
+        CloseSegment();
+    }
+
+    // Дописывает запись, данные которой encode(std::string&) дописывает в
+    // переданную строку. Запись кодируется до захвата мьютекса
+    template <typename Encode>
+    void Append(Encode&& encode) {
+        thread_local std::string data;
+        data.clear();
+        encode(data);
+
+        std::lock_guard lock(mutex_);
+        serde::journal::AppendFrame(pending_.back().data, data);
+        size_since_rotate_ += data.size();
+        ++last_;
+    }
+
+    // Начинает новый сегмент и возвращает номер последней записи старого.
+    // Вызывается при захвате снимка: когда снимок будет записан, старые
+    // сегменты можно удалить вызовом Discard
+    uint64_t Rotate() {
+        std::lock_guard lock(mutex_);
+        if (pending_.back().start != last_ + 1) {
+            pending_.push_back(Batch {.start = last_ + 1, .data = {}});
+        }
+        size_since_rotate_ = 0;
+        has_failed_ = false;
+        return last_;
+    }
+
+    // Объём данных записей, добавленных после последнего вызова Rotate
+    uint64_t GetSizeSinceRotate() {
+        std::lock_guard lock(mutex_);
+        return size_since_rotate_;
+    }
+
+    // Записи не удалось записать на диск после последнего вызова Rotate.
+    // Сегмент, в который они писались, больше не дополняется: сохранить
+    // их может только снимок, захваченный после Rotate
+    bool HasFailed() {
+        std::lock_guard lock(mutex_);
+        return has_failed_;
+    }
+
+    // Удаляет сегменты, все записи которых имеют номера не больше position
+    void Discard(uint64_t position) {
+        std::lock_guard lock(mutex_);
+        discard_position_ = std::max(discard_position_, position);
+    }
+
+    // Дожидается записи на диск всех добавленных записей и удаления
+    // сегментов, переданных Discard
+    void Flush() {
+        std::unique_lock lock(mutex_);
+        const uint64_t target = started_commits_ + 1;
+        is_flush_requested_ = true;
+        commit_ready_.notify_one();
+        flushed_.wait(lock, [&] {
+            return finished_commits_ >= target;
+        });
+    }
+
+  private:
+    // Записи одного сегмента, начинающегося с записи start
+    struct Batch {
+        uint64_t start = 0;
+        std::string data;
+    };
+
+    void Run() {
+        std::unique_lock lock(mutex_);
+        std::vector<Batch> batches;
+        while (true) {
+            commit_ready_.wait_for(lock, commit_period_, [this] {
+                return is_stopped_ || is_flush_requested_;
+            });
+            is_flush_requested_ = false;
+            ++started_commits_;
+            const bool is_stopped = is_stopped_;
+            const uint64_t discard_position = discard_position_;
+            const uint64_t failed_segment = failed_segment_;
+
+            // Записи последнего сегмента продолжают накапливаться в
+            // буфере из прошлой итерации
+            batches.swap(pending_);
+            pending_.resize(1);
+            pending_.front().start = batches.back().start;
+            pending_.front().data.clear();
+            lock.unlock();
+
+            bool is_failed = false;
+            try {
+                Commit(batches, failed_segment);
+            } catch (const std::exception& e) {
+                errors_.Increment();
+                logger::ReportError(e, "journal");
+                is_failed = true;
+                CloseSegment();
+            }
+            try {
+                RemoveSegments(discard_position);
+            } catch (const std::exception& e) {
+                errors_.Increment();
+                logger::ReportError(e, "journal");
+            }
+            const uint64_t last_segment = batches.back().start;
+            batches.resize(1);
+
+            lock.lock();
+            if (is_failed) {
+                // В сегменте могла остаться оборванная запись, и записи
+                // после неё не прочитать. Сегмент больше не дополняется,
+                // а его записи сохранит снимок после следующего Rotate
+                failed_segment_ = std::max(failed_segment_, last_segment);
+                has_failed_ = true;
+            }
+            ++finished_commits_;
+            flushed_.notify_all();
+            if (is_stopped) {
+                return;
+            }
+        }
+    }
+
+    // Записи сегментов, начинающихся не позже failed_segment, не пишутся
+    void Commit(const std::vector<Batch>& batches, uint64_t failed_segment) {
+        bool has_data = false;
+        for (const auto& batch : batches) {
+            if (batch.data.empty() || batch.start <= failed_segment) {
+                continue;
+            }
+            if (fd_ < 0 || batch.start != segments_.back().start) {
+                OpenSegment(batch.start);
+            }
+            Write(batch.data);
+            has_data = true;
+        }
+        if (has_data) {
+            metrics::ScopedTimer timer(sync_duration_);
+            if (::fdatasync(fd_) != 0) {
+                throw std::system_error(
+                    errno, std::generic_category(), "fdatasync"
+                );
+            }
+        }
+    }
+
+    // Сегмент создаётся при появлении первой его записи. Предыдущий
+    // сегмент сбрасывается на диск и закрывается
+    void OpenSegment(uint64_t start) {
+        if (fd_ >= 0) {
+            const int result = ::fdatasync(fd_);
+            const int error = errno;
+            CloseSegment();
+            if (result != 0) {
+                throw std::system_error(
+                    error, std::generic_category(), "fdatasync"
+                );
+            }
+        }
+
+        const auto path = serde::journal::GetSegmentPath(state_file_, start);
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "open");
+        }
+        if (segments_.empty() || segments_.back().start != start) {
+            segments_.push_back({start, path});
+        }
+        Write(serde::journal::MakeSegmentHeader(start));
+
+        const auto directory = state_file_.parent_path();
+        serde::snapshot::SyncPath(
+            directory.empty() ? std::filesystem::path(".") : directory
+        );
+    }
+
+    void CloseSegment() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    void Write(std::string_view data) {
+        while (!data.empty()) {
+            const ssize_t written = ::write(fd_, data.data(), data.size());
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(
+                    errno, std::generic_category(), "write"
+                );
+            }
+            data.remove_prefix(static_cast<size_t>(written));
+            bytes_.Increment(static_cast<uint64_t>(written));
+        }
+    }
+
+    // Сегмент не нужен, если следующий начинается не позже position + 1.
+    // Последний сегмент остаётся открытым для записи
+    void RemoveSegments(uint64_t position) {
+        size_t removed = 0;
+        while (removed + 1 < segments_.size() &&
+               segments_[removed + 1].start <= position + 1) {
+            std::error_code ec;
+            std::filesystem::remove(segments_[removed].path, ec);
+            ++removed;
+        }
+        segments_.erase(segments_.begin(), segments_.begin() + removed);
+    }
+
+    const std::filesystem::path state_file_;
+    const std::chrono::milliseconds commit_period_;
+
+    // Используются только потоком записи
+    std::vector<serde::journal::Segment> segments_;
+    int fd_ = -1;
+
+    std::mutex mutex_;
+    std::condition_variable commit_ready_;
+    std::condition_variable flushed_;
+    // Последний элемент - сегмент, в который дописываются записи
+    std::vector<Batch> pending_;
+    uint64_t last_;
+    uint64_t size_since_rotate_ = 0;
+    uint64_t started_commits_ = 0;
+    uint64_t finished_commits_ = 0;
+    uint64_t discard_position_ = 0;
+    // Начало последнего сегмента, запись которого не удалась
+    uint64_t failed_segment_ = 0;
+    bool has_failed_ = false;
+    bool is_flush_requested_ = false;
+    bool is_stopped_ = false;
+
+    metrics::DurationStat& sync_duration_ =
+        metrics::Registry::Instance().GetDuration("journal_sync");
+    metrics::Counter& bytes_ =
+        metrics::Registry::Instance().GetCounter("journal_bytes");
+    metrics::Counter& errors_ =
+        metrics::Registry::Instance().GetCounter("journal_errors");
+
+    std::thread worker_;
+};
+
+} // namespace app
@@ -1,11 +1,10 @@
 #pragma once
 
+#include "app/token.h"
 #include "model/game_session.h"
 #include "utils/tagged.h"
 
-#include <iomanip>
 #include <random>
-#include <sstream>
 #include <string>
 
 namespace app {
@@ -55,6 +54,4 @@ class Player {
 using PlayerHolder = std::shared_ptr<Player>;
 using Players = std::vector<PlayerHolder>;
 
-using Token = utils::Tagged<std::string, class TokenTag>;
-
 } // namespace app
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "app/player_record.h"
+#include "app/use_cases.h"
+#include "logger/report.h"
+#include "metrics/metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace app {
+
+struct RecordSinkConfig {
+    // Сколько рекордов может ждать записи. Не поместившиеся отбрасываются
+    size_t queue_size = 65536;
+    // Наибольшее число рекордов, записываемых одной транзакцией
+    size_t max_batch = 4096;
+    // Сколько раз пробовать записать пакет, прежде чем отбросить его
+    size_t max_attempts = 5;
+    // Пауза перед первым повтором. С каждым следующим повтором удваивается
+    std::chrono::milliseconds retry_delay {100};
+};
+
+/*
+ *  Записывает рекорды игроков в базу данных в отдельном потоке, чтобы тик
+ *  не ждал свободного соединения и ответа сервера. Рекорды, накопившиеся
+ *  за время записи, уходят следующим пакетом одной транзакцией.
+ *
+ *  Очередь ограничена: если база данных не успевает или недоступна,
+ *  рекорды, не поместившиеся в очередь, отбрасываются, а не задерживают
+ *  тик. Пакет, который не удалось записать за max_attempts попыток, тоже
+ *  отбрасывается.
+ */
+class RecordSink {
+  public:
+    RecordSink(UseCases& use_cases, const RecordSinkConfig& config) :
+        use_cases_(use_cases),
+        config_(config),
+        worker_([this] {
+            Run();
+        }) {}
+
+    RecordSink(const RecordSink&) = delete;
+    RecordSink& operator=(const RecordSink&) = delete;
+
+    // Дописывает очередь
+    ~RecordSink() {
+        {
+            std::lock_guard lock(mutex_);
+            is_stopped_ = true;
+        }
+        work_ready_.notify_one();
+        worker_.join();
+    }
+
+    // Ставит рекорды в очередь записи. Не ждёт базу данных
+    void Enqueue(std::vector<PlayerRecord> records) {
+        if (records.empty()) {
+            return;
+        }
+        {
+            std::lock_guard lock(mutex_);
+            const size_t free_space = config_.queue_size - queue_.size();
+            if (records.size() > free_space) {
+                dropped_.Increment(records.size() - free_space);
+                records.erase(records.begin() + free_space, records.end());
+            }
+            std::move(
+                records.begin(), records.end(), std::back_inserter(queue_)
+            );
+            backlog_.Set(static_cast<int64_t>(queue_.size()));
+        }
+        work_ready_.notify_one();
+    }
+
+    // Дожидается записи или отбрасывания всех поставленных в очередь
+    // рекордов
+    void Flush() {
+        std::unique_lock lock(mutex_);
+        written_.wait(lock, [this] {
+            return queue_.empty() && !is_writing_;
+        });
+    }
+
+  private:
+    void Run() {
+        std::unique_lock lock(mutex_);
+        std::vector<PlayerRecord> batch;
+        while (true) {
+            work_ready_.wait(lock, [this] {
+                return is_stopped_ || !queue_.empty();
+            });
+            if (queue_.empty()) {
+                return;
+            }
+
+            const size_t batch_size =
+                std::min(queue_.size(), config_.max_batch);
+            batch.assign(
+                std::make_move_iterator(queue_.begin()),
+                std::make_move_iterator(queue_.begin() + batch_size)
+            );
+            queue_.erase(queue_.begin(), queue_.begin() + batch_size);
+            backlog_.Set(static_cast<int64_t>(queue_.size()));
+            is_writing_ = true;
+            lock.unlock();
+
+            Write(batch);
+
+            lock.lock();
+            is_writing_ = false;
+            written_.notify_all();
+        }
+    }
+
+    // Повторяет запись пакета с растущей паузой. После остановки повторы
+    // делаются без пауз
+    void Write(const std::vector<PlayerRecord>& batch) {
+        auto delay = config_.retry_delay;
+        for (size_t attempt = 1;; ++attempt) {
+            try {
+                metrics::ScopedTimer timer(write_duration_);
+                use_cases_.SavePlayerRecords(batch);
+                return;
+            } catch (const std::exception& e) {
+                if (attempt >= config_.max_attempts) {
+                    dropped_.Increment(batch.size());
+                    logger::ReportError(e, "save_player_records");
+                    return;
+                }
+            }
+
+            retries_.Increment();
+            std::unique_lock lock(mutex_);
+            work_ready_.wait_for(lock, delay, [this] {
+                return is_stopped_;
+            });
+            delay *= 2;
+        }
+    }
+
+    UseCases& use_cases_;
+    const RecordSinkConfig config_;
+
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable written_;
+    std::deque<PlayerRecord> queue_;
+    bool is_writing_ = false;
+    bool is_stopped_ = false;
+
+    metrics::DurationStat& write_duration_ =
+        metrics::Registry::Instance().GetDuration("player_records_write");
+    metrics::Gauge& backlog_ =
+        metrics::Registry::Instance().GetGauge("player_records_backlog");
+    metrics::Counter& retries_ =
+        metrics::Registry::Instance().GetCounter("player_records_retries");
+    metrics::Counter& dropped_ =
+        metrics::Registry::Instance().GetCounter("player_records_dropped");
+
+    std::thread worker_;
+};
+
+} // namespace app
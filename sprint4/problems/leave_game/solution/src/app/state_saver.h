@@ -0,0 +1,192 @@
+#pragma once
+
+#include "logger/report.h"
+#include "metrics/metrics.h"
+#include "serde/snapshot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace app {
+
+/*
+ *  Публикует снимки состояния в файл. Снимок - уже закодированные секции
+ *  сессий, поэтому после захвата он не зависит от игрового состояния и
+ *  может записываться в отдельном потоке, пока идут следующие тики.
+ *
+ *  Очередь снимков ограничена: если запись не успевает, самый старый из
+ *  ожидающих снимков отбрасывается, так как более новый его заменяет.
+ */
+class StateSaver {
+  public:
+    using Clock = std::chrono::steady_clock;
+    using Sections = std::vector<std::string>;
+
+    StateSaver(std::filesystem::path state_file, size_t max_backlog) :
+        state_file_(std::move(state_file)),
+        max_backlog_(std::max<size_t>(max_backlog, 1)),
+        worker_([this] {
+            Run();
+        }) {}
+
+    StateSaver(const StateSaver&) = delete;
+    StateSaver& operator=(const StateSaver&) = delete;
+
+    // Дописывает ожидающие снимки
+    ~StateSaver() {
+        {
+            std::lock_guard lock(mutex_);
+            is_stopped_ = true;
+        }
+        work_ready_.notify_one();
+        worker_.join();
+    }
+
+    // Буферы уже записанного снимка, чтобы не выделять память при захвате
+    // следующего
+    Sections TakeBuffers() {
+        std::lock_guard lock(mutex_);
+        return std::exchange(spare_, {});
+    }
+
+    // Ставит снимок в очередь записи. journal_position - номер последней
+    // записи журнала, учтённой в снимке
+    void Enqueue(
+        Sections sections, Clock::time_point captured_at,
+        uint64_t journal_position = 0
+    ) {
+        {
+            std::lock_guard lock(mutex_);
+            if (queue_.size() >= max_backlog_) {
+                queue_.pop_front();
+                skipped_.Increment();
+            }
+            queue_.push_back(
+                {std::move(sections), captured_at, journal_position}
+            );
+        }
+        work_ready_.notify_one();
+    }
+
+    // Записывает снимок в вызывающем потоке после всех ожидающих, чтобы
+    // они не перезаписали более новое состояние. Ошибки записи бросаются
+    void Write(
+        Sections sections, Clock::time_point captured_at,
+        uint64_t journal_position = 0
+    ) {
+        Flush();
+        Publish({std::move(sections), captured_at, journal_position});
+    }
+
+    // Дожидается записи всех поставленных в очередь снимков
+    void Flush() {
+        std::unique_lock lock(mutex_);
+        written_.wait(lock, [this] {
+            return queue_.empty() && !is_writing_;
+        });
+    }
+
+    // Время, прошедшее с захвата последнего записанного снимка
+    std::optional<Clock::duration> GetSnapshotAge() const {
+        std::lock_guard lock(mutex_);
+        if (!last_captured_at_) {
+            return std::nullopt;
+        }
+        return Clock::now() - *last_captured_at_;
+    }
+
+    // Позиция журнала в последнем записанном снимке. Более ранние записи
+    // журнала больше не нужны для восстановления
+    uint64_t GetJournalPosition() const {
+        std::lock_guard lock(mutex_);
+        return journal_position_;
+    }
+
+  private:
+    struct Snapshot {
+        Sections sections;
+        Clock::time_point captured_at;
+        uint64_t journal_position = 0;
+    };
+
+    void Run() {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            work_ready_.wait(lock, [this] {
+                return is_stopped_ || !queue_.empty();
+            });
+            if (queue_.empty()) {
+                return;
+            }
+
+            Snapshot snapshot = std::move(queue_.front());
+            queue_.pop_front();
+            is_writing_ = true;
+            lock.unlock();
+
+            try {
+                Publish(std::move(snapshot));
+            } catch (const std::exception& e) {
+                errors_.Increment();
+                logger::ReportError(e, "save_state");
+            }
+
+            lock.lock();
+            is_writing_ = false;
+            written_.notify_all();
+        }
+    }
+
+    void Publish(Snapshot snapshot) {
+        {
+            metrics::ScopedTimer timer(write_duration_);
+            serde::snapshot::PublishSnapshot(
+                state_file_, snapshot.sections, snapshot.journal_position
+            );
+        }
+
+        std::lock_guard lock(mutex_);
+        if (!last_captured_at_ || *last_captured_at_ < snapshot.captured_at) {
+            last_captured_at_ = snapshot.captured_at;
+            journal_position_ = snapshot.journal_position;
+        }
+        if (spare_.empty()) {
+            spare_ = std::move(snapshot.sections);
+        }
+    }
+
+    const std::filesystem::path state_file_;
+    const size_t max_backlog_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable written_;
+    std::deque<Snapshot> queue_;
+    bool is_writing_ = false;
+    bool is_stopped_ = false;
+    Sections spare_;
+    std::optional<Clock::time_point> last_captured_at_;
+    uint64_t journal_position_ = 0;
+
+    metrics::DurationStat& write_duration_ =
+        metrics::Registry::Instance().GetDuration("save_state_write");
+    metrics::Counter& skipped_ =
+        metrics::Registry::Instance().GetCounter("state_snapshots_skipped");
+    metrics::Counter& errors_ =
+        metrics::Registry::Instance().GetCounter("save_state_errors");
+
+    std::thread worker_;
+};
+
+} // namespace app
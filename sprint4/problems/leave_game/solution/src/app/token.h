@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace app {
+
+namespace detail {
+
+inline constexpr std::array<char, 16> hex_digits = {
+    '0', '1', '2', '3', '4', '5', '6', '7',
+    '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+};
+
+// Значения шестнадцатеричных цифр, 0xff для остальных символов
+inline constexpr std::array<uint8_t, 256> hex_digit_values = [] {
+    std::array<uint8_t, 256> values {};
+    values.fill(0xff);
+    for (uint8_t i = 0; i < hex_digits.size(); ++i) {
+        values[static_cast<uint8_t>(hex_digits[i])] = i;
+    }
+    return values;
+}();
+
+} // namespace detail
+
+/*
+ *  Токен игрока - 128-битное число. Текстовая форма состоит из 32
+ *  шестнадцатеричных цифр в нижнем регистре, старшая половина идёт первой.
+ *  Разбор и форматирование в Chars не выделяют память.
+ */
+class Token {
+  public:
+    static constexpr size_t text_size = 32;
+    using Chars = std::array<char, text_size>;
+
+    constexpr Token() noexcept = default;
+
+    constexpr Token(uint64_t high, uint64_t low) noexcept :
+        high_(high),
+        low_(low) {}
+
+    // Возвращает nullopt, если text не является текстовой формой токена
+    static constexpr std::optional<Token> Parse(std::string_view text
+    ) noexcept {
+        if (text.size() != text_size) {
+            return std::nullopt;
+        }
+
+        // Цифры разбираются без ветвлений, ошибка накапливается в invalid
+        uint8_t invalid = 0;
+        const auto parse_half = [&](size_t offset) {
+            uint64_t result = 0;
+            for (size_t i = offset; i < offset + half_size; ++i) {
+                const uint8_t value =
+                    detail::hex_digit_values[static_cast<uint8_t>(text[i])];
+                invalid |= value;
+                result = (result << 4) | (value & 0xf);
+            }
+            return result;
+        };
+
+        const Token token {parse_half(0), parse_half(half_size)};
+        if (invalid & 0xf0) {
+            return std::nullopt;
+        }
+        return token;
+    }
+
+    constexpr Chars ToChars() const noexcept {
+        Chars chars {};
+        for (size_t i = 0; i < half_size; ++i) {
+            const size_t shift = 4 * (half_size - 1 - i);
+            chars[i] = detail::hex_digits[(high_ >> shift) & 0xf];
+            chars[half_size + i] = detail::hex_digits[(low_ >> shift) & 0xf];
+        }
+        return chars;
+    }
+
+    std::string ToString() const {
+        const Chars chars = ToChars();
+        return std::string(chars.data(), chars.size());
+    }
+
+    constexpr uint64_t GetHigh() const noexcept {
+        return high_;
+    }
+
+    constexpr uint64_t GetLow() const noexcept {
+        return low_;
+    }
+
+    auto operator<=>(const Token&) const = default;
+
+  private:
+    static constexpr size_t half_size = text_size / 2;
+
+    uint64_t high_ = 0;
+    uint64_t low_ = 0;
+};
+
+// Хешер для unordered-контейнеров, позволяющий искать токен по его
+// текстовой форме без создания строки
+struct TokenHasher {
+    using is_transparent = void;
+
+    size_t operator()(const Token& token) const noexcept {
+        uint64_t hash = token.GetLow() * 0x9e3779b97f4a7c15ull;
+        hash ^= token.GetHigh();
+        hash ^= hash >> 32;
+        return static_cast<size_t>(hash);
+    }
+
+    size_t operator()(std::string_view text) const noexcept {
+        if (auto token = Token::Parse(text)) {
+            return (*this)(*token);
+        }
+        return std::hash<std::string_view> {}(text);
+    }
+};
+
+struct TokenEqual {
+    using is_transparent = void;
+
+    bool operator()(const Token& lhs, const Token& rhs) const noexcept {
+        return lhs == rhs;
+    }
+
+    bool operator()(const Token& lhs, std::string_view rhs) const noexcept {
+        return Token::Parse(rhs) == lhs;
+    }
+
+    bool operator()(std::string_view lhs, const Token& rhs) const noexcept {
+        return Token::Parse(lhs) == rhs;
+    }
+};
+
+}  // namespace app
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "app/token.h"
+#include "utils/epoch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace app {
+
+/*
+ *  Хеш-таблица с открытой адресацией, отображающая токены на значения.
+ *
+ *  Поиск не использует блокировок и не ждёт других потоков: он читает
+ *  слоты атомарно и проходит не больше ячеек, чем есть в таблице.
+ *  Изменения таблицы сериализуются мьютексом. Удалённые записи и старые
+ *  массивы слотов после перестроения освобождаются через utils::epoch,
+ *  когда их уже не может видеть ни один читатель.
+ */
+template <typename Value>
+class TokenTable {
+  public:
+    TokenTable() : table_(new Table(min_capacity)) {}
+
+    TokenTable(const TokenTable&) = delete;
+    TokenTable& operator=(const TokenTable&) = delete;
+
+    // Вызывается, когда читателей таблицы уже не осталось
+    ~TokenTable() {
+        Table* table = table_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i <= table->mask; ++i) {
+            Node* node = table->slots[i].load(std::memory_order_relaxed);
+            if (node && node != Tombstone()) {
+                delete node;
+            }
+        }
+        delete table;
+        // Удалённые записи держат свои значения, пока их не освободит
+        // utils::epoch
+        utils::epoch::CollectAll();
+    }
+
+    std::optional<Value> Find(const Token& key) const {
+        utils::epoch::Guard guard;
+        const Table* table = table_.load(std::memory_order_acquire);
+
+        size_t index = Hash(key) & table->mask;
+        for (size_t probe = 0; probe <= table->mask; ++probe) {
+            const Node* node =
+                table->slots[index].load(std::memory_order_acquire);
+            if (!node) {
+                break;
+            }
+            if (node != Tombstone() && node->key == key) {
+                return node->value;
+            }
+            index = (index + 1) & table->mask;
+        }
+        return std::nullopt;
+    }
+
+    bool Contains(const Token& key) const {
+        return Find(key).has_value();
+    }
+
+    void InsertOrAssign(const Token& key, Value value) {
+        std::lock_guard lock(mutex_);
+        Table* table = table_.load(std::memory_order_relaxed);
+
+        auto slot = FindSlot(*table, key);
+        if (slot.found) {
+            Node* old_node =
+                table->slots[slot.index].load(std::memory_order_relaxed);
+            table->slots[slot.index].store(
+                new Node {key, std::move(value)}, std::memory_order_release
+            );
+            utils::epoch::Retire(old_node);
+            return;
+        }
+
+        // Заполненность считается вместе с надгробиями, так как они тоже
+        // удлиняют поиск
+        if ((table->used + 1) * 4 > (table->mask + 1) * 3) {
+            table = Rehash(size_ + 1);
+            slot = FindSlot(*table, key);
+        }
+
+        if (!table->slots[slot.index].load(std::memory_order_relaxed)) {
+            ++table->used;
+        }
+        table->slots[slot.index].store(
+            new Node {key, std::move(value)}, std::memory_order_release
+        );
+        ++size_;
+    }
+
+    bool Erase(const Token& key) {
+        std::lock_guard lock(mutex_);
+        Table* table = table_.load(std::memory_order_relaxed);
+
+        const auto slot = FindSlot(*table, key);
+        if (!slot.found) {
+            return false;
+        }
+
+        Node* node = table->slots[slot.index].load(std::memory_order_relaxed);
+        table->slots[slot.index].store(Tombstone(), std::memory_order_release);
+        utils::epoch::Retire(node);
+        --size_;
+        return true;
+    }
+
+    // Вызывает fn(key, value) для каждой записи. Изменения таблицы на это
+    // время блокируются, поэтому fn не должна изменять таблицу
+    template <typename Fn>
+    void ForEach(Fn&& fn) const {
+        std::lock_guard lock(mutex_);
+        const Table* table = table_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i <= table->mask; ++i) {
+            const Node* node = table->slots[i].load(std::memory_order_relaxed);
+            if (node && node != Tombstone()) {
+                fn(node->key, node->value);
+            }
+        }
+    }
+
+    size_t Size() const {
+        std::lock_guard lock(mutex_);
+        return size_;
+    }
+
+  private:
+    static constexpr size_t min_capacity = 16;
+
+    struct Node {
+        Token key;
+        Value value;
+    };
+
+    struct Table {
+        explicit Table(size_t capacity) :
+            mask(capacity - 1),
+            slots(new std::atomic<Node*>[capacity]) {
+            for (size_t i = 0; i < capacity; ++i) {
+                slots[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        size_t mask;
+        std::unique_ptr<std::atomic<Node*>[]> slots;
+        // Количество занятых слотов, включая надгробия. Меняется только
+        // под мьютексом
+        size_t used = 0;
+    };
+
+    struct Slot {
+        size_t index;
+        bool found;
+    };
+
+    // Метка удалённой записи. Поиск проходит её, не останавливаясь
+    static Node* Tombstone() noexcept {
+        static Node tombstone {};
+        return &tombstone;
+    }
+
+    static size_t Hash(const Token& key) noexcept {
+        return TokenHasher {}(key);
+    }
+
+    // Слот с ключом key или слот, в который его нужно вставить.
+    // Вызывается под мьютексом
+    static Slot FindSlot(const Table& table, const Token& key) noexcept {
+        std::optional<size_t> first_tombstone;
+        size_t index = Hash(key) & table.mask;
+        for (size_t probe = 0; probe <= table.mask; ++probe) {
+            const Node* node =
+                table.slots[index].load(std::memory_order_relaxed);
+            if (!node) {
+                return Slot {first_tombstone.value_or(index), false};
+            }
+            if (node == Tombstone()) {
+                if (!first_tombstone) {
+                    first_tombstone = index;
+                }
+            } else if (node->key == key) {
+                return Slot {index, true};
+            }
+            index = (index + 1) & table.mask;
+        }
+        return Slot {*first_tombstone, false};
+    }
+
+    // Переносит записи в новый массив слотов, рассчитанный на
+    // expected_size записей, без надгробий. Вызывается под мьютексом
+    Table* Rehash(size_t expected_size) {
+        Table* old_table = table_.load(std::memory_order_relaxed);
+        const size_t capacity =
+            std::max(min_capacity, std::bit_ceil(expected_size * 2));
+        auto* table = new Table(capacity);
+
+        for (size_t i = 0; i <= old_table->mask; ++i) {
+            Node* node = old_table->slots[i].load(std::memory_order_relaxed);
+            if (!node || node == Tombstone()) {
+                continue;
+            }
+            const auto slot = FindSlot(*table, node->key);
+            table->slots[slot.index].store(node, std::memory_order_relaxed);
+            ++table->used;
+        }
+
+        // Записи переходят в новую таблицу, освобождается только массив
+        table_.store(table, std::memory_order_release);
+        utils::epoch::Retire(old_table);
+        return table;
+    }
+
+    mutable std::mutex mutex_;
+    std::atomic<Table*> table_;
+    size_t size_ = 0;
+};
+
+}  // namespace app
@@ -11,6 +11,11 @@ class UseCasesImpl : public UseCases {
         unit_factory_(unit_factory) {}
 
     void SavePlayerRecords(const std::vector<PlayerRecord>& records) override {
+        // Большинство тиков никого не отправляет на покой: не занимаем
+        // соединение ради пустой транзакции
+        if (records.empty()) {
+            return;
+        }
         auto work = unit_factory_.CreateUnitOfWork();
         work->PlayerRecords().SaveAll(records);
         work->Commit();
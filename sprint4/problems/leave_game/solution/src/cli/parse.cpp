@@ -9,6 +9,10 @@ std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
 
     po::options_description desc{"All options"};
     Args args;
+    uint64_t random_seed = 0;
+    std::string io_mode = "shared";
+    std::string log_overflow = "drop";
+    std::string save_state_mode = "sync";
     // clang-format off
     desc.add_options()
         ("help,h", "produce help message")
@@ -17,7 +21,16 @@ std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
         ("www-root,w", po::value(&args.www_root)->value_name("dir"), "set static files root")
         ("randomize-spawn-points", po::value(&args.randomize_spawn_points), "spawn dogs at random positions")
         ("state-file", po::value(&args.state_file)->value_name("file"), "set game state file path")
-        ("save-state-period", po::value(&args.save_period)->value_name("milliseconds"), "set save game state period");
+        ("save-state-period", po::value(&args.save_period)->value_name("milliseconds"), "set save game state period")
+        ("save-state-mode", po::value(&save_state_mode)->value_name("sync|background"), "write periodic game state saves within the tick or from a background thread")
+        ("journal-commit-period", po::value(&args.journal_commit_period)->value_name("milliseconds"), "journal game changes between state saves and commit them to disk with this period")
+        ("journal-snapshot-size", po::value(&args.journal_snapshot_size)->value_name("bytes"), "save game state early once the journal has grown by this many bytes")
+        ("random-seed", po::value(&random_seed)->value_name("number"), "seed random generators for reproducible runs")
+        ("expose-metrics", po::value(&args.expose_metrics), "serve server metrics at /api/v1/metrics without authorization")
+        ("io-mode", po::value(&io_mode)->value_name("shared|per-core"), "serve connections from one shared io_context or, experimentally, from io_contexts pinned to half of the cores")
+        ("log-flush-period", po::value(&args.log_flush_period)->value_name("milliseconds"), "set how often buffered log records are written")
+        ("log-queue-size", po::value(&args.log_queue_size)->value_name("records"), "set capacity of the log record queue")
+        ("log-overflow", po::value(&log_overflow)->value_name("drop|block"), "drop log records or wait when the log queue is full");
     // clang-format on
 
     po::variables_map vm;
@@ -37,6 +50,28 @@ std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
         throw std::runtime_error("Path to the static content is not specified");
     }
 
+    if (vm.contains("random-seed")) {
+        args.random_seed = random_seed;
+    }
+
+    if (io_mode == "per-core") {
+        args.io_mode = IoMode::per_core;
+    } else if (io_mode != "shared") {
+        throw std::runtime_error("Unknown IO mode " + io_mode);
+    }
+
+    if (save_state_mode == "background") {
+        args.save_state_in_background = true;
+    } else if (save_state_mode != "sync") {
+        throw std::runtime_error("Unknown save state mode " + save_state_mode);
+    }
+
+    if (log_overflow == "block") {
+        args.log_overflow = LogOverflow::block;
+    } else if (log_overflow != "drop") {
+        throw std::runtime_error("Unknown log overflow policy " + log_overflow);
+    }
+
     return args;
 }
 } // namespace cli
@@ -1,10 +1,26 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <optional>
 
 namespace cli {
 
+// Как распределяются сетевые соединения между потоками
+enum class IoMode {
+    // Один io_context на все потоки
+    shared,
+    // Экспериментальный: свой io_context и акцептор на каждое ядро сетевого
+    // пула. Ядра делятся между сетевым пулом и игровой логикой
+    per_core,
+};
+
+// Что делать с записью журнала, если его очередь заполнена
+enum class LogOverflow {
+    drop,
+    block,
+};
+
 struct Args {
     size_t tick_period = 0;
     std::string config_file;
@@ -12,6 +28,15 @@ struct Args {
     bool randomize_spawn_points = false;
     std::string state_file;
     size_t save_period = 0;
+    bool save_state_in_background = false;
+    size_t journal_commit_period = 0;
+    uint64_t journal_snapshot_size = uint64_t(64) << 20;
+    std::optional<uint64_t> random_seed;
+    bool expose_metrics = false;
+    IoMode io_mode = IoMode::shared;
+    size_t log_flush_period = 100;
+    size_t log_queue_size = 65536;
+    LogOverflow log_overflow = LogOverflow::drop;
 };
 
 [[nodiscard]] std::optional<Args>
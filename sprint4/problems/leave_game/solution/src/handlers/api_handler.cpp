@@ -2,9 +2,9 @@
 #include "serde/json.h"
 #include "web/response_builder.h"
 #include "web/utils.h"
+#include "metrics/metrics.h"
 
-#include <boost/url/url_view.hpp>
-#include <boost/url/parse.hpp>
+#include <optional>
 
 namespace handlers {
 
@@ -14,66 +14,61 @@ namespace json = boost::json;
 
 class ApiHandlerImpl {
   public:
-    ApiHandlerImpl(app::Application& app, web::StringRequest&& req) :
+    ApiHandlerImpl(
+        app::Application& app,
+        const MapPayloads& map_payloads,
+        bool expose_metrics,
+        const ApiRoute& route,
+        web::StringRequest&& req
+    ) :
         app_(app),
+        map_payloads_(map_payloads),
+        expose_metrics_(expose_metrics),
+        route_(route),
         req_(std::move(req)) {}
 
-    web::StringResponse HandleApiRequest() const {
-        std::string_view target = req_.target();
-        if (target.back() == '/') {
-            target.remove_suffix(1);
-        }
-
-        target.remove_prefix(api_uri_.size());
-
-        if (target == "/game/join") {
-            return HandleGameJoinRequest();
-        }
-
-        if (target == "/game/players") {
-            return HandlePlayersRequest();
-        }
+    ApiResponse HandleApiRequest() const {
+        const auto& endpoint = route_.endpoint;
 
-        if (target == "/game/state") {
-            return HandleGameStateRequest();
-        }
-
-        if (target == "/game/player/action") {
-            return HandlePlayerAction();
-        }
-
-        if (target.starts_with("/game/records")) {
-            return HandleRecordsAction();
-        }
-
-        if (target == "/game/tick" && !app_.HasTickPeriod()) {
-            return HandleGameTick();
-        }
-
-        if (!target.starts_with(maps_uri_)) {
+        // Без периода тиков в конфигурации время двигается запросом
+        // /game/tick, иначе такого пути нет. Метрики отдаются, только если
+        // это разрешено при запуске
+        if (!endpoint ||
+            (endpoint == ApiEndpoint::tick && app_.HasTickPeriod()) ||
+            (endpoint == ApiEndpoint::metrics && !expose_metrics_)) {
             web::JsonResponseBuilder res(req_);
             res.SetBadRequest();
-            return res;
-        }
-
-        target.remove_prefix(maps_uri_.size());
-
-        if (target.empty()) {
-            return HandleMapsListRequest();
+            return res.MakeResponse();
         }
 
-        if (target.front() != '/') {
-            web::JsonResponseBuilder res(req_);
-            res.SetBadRequest();
-            return res;
+        switch (*endpoint) {
+            case ApiEndpoint::join:
+                return HandleGameJoinRequest();
+            case ApiEndpoint::players:
+                return HandlePlayersRequest();
+            case ApiEndpoint::state:
+                return HandleGameStateRequest();
+            case ApiEndpoint::action:
+                return HandlePlayerAction();
+            case ApiEndpoint::records:
+                return HandleRecordsAction();
+            case ApiEndpoint::tick:
+                return HandleGameTick();
+            case ApiEndpoint::metrics:
+                return HandleMetricsRequest();
+            case ApiEndpoint::maps_list:
+                return HandleMapsListRequest();
+            case ApiEndpoint::map_info:
+                return HandleMapInfoRequest(route_.map_id);
         }
 
-        target.remove_prefix(1);
-        return HandleMapInfoRequest(std::string(target));
+        web::JsonResponseBuilder res(req_);
+        res.SetBadRequest();
+        return res.MakeResponse();
     }
 
   private:
-    web::StringResponse HandleMapInfoRequest(std::string map_id) const {
+    ApiResponse HandleMapInfoRequest(std::string_view map_id) const {
         web::JsonResponseBuilder res(req_);
         res.SetNoCache();
 
@@ -81,27 +76,49 @@ class ApiHandlerImpl {
             method != http::verb::get && method != http::verb::head) {
             res.SetInvalidMethod();
             res.SetAllow("GET,HEAD");
-            return res;
+            return res.MakeResponse();
         }
 
-        const model::Map* map = app_.FindMap(model::Map::Id(std::move(map_id)));
-
-        if (!map) {
+        auto it = map_payloads_.by_id.find(map_id);
+        if (it == map_payloads_.by_id.end()) {
             res.SetMapNotFound();
-            return res;
+            return res.MakeResponse();
         }
 
-        res.SetJsonBody(serde::json::SerializeMapInfo(*map));
-        return res;
+        return SendPrecomputed(it->second);
     };
 
-    web::StringResponse HandleMapsListRequest() const {
-        web::JsonResponseBuilder res(req_);
-        res.SetNoCache();
-        res.SetJsonBody(serde::json::SerializeMapsList(app_.ListMaps()));
-        return res;
+    ApiResponse HandleMapsListRequest() const {
+        return SendPrecomputed(map_payloads_.list);
     };
 
+    // Отдаёт сжатую версию, если клиент её принимает, и 304, если у
+    // клиента уже есть эта версия
+    ApiResponse SendPrecomputed(const web::PrecomputedBody& payload) const {
+        web::SharedJsonResponseBuilder res(req_);
+        res.SetNoCache();
+        res.Set(http::field::vary, "Accept-Encoding");
+
+        const bool use_gzip = payload.gzip_body &&
+            web::IsEncodingAccepted(req_[http::field::accept_encoding], "gzip");
+        const std::string& etag = use_gzip ? payload.gzip_etag : payload.etag;
+        res.Set(http::field::etag, etag);
+
+        if (auto it = req_.find(http::field::if_none_match);
+            it != req_.end() && web::IsETagMatched(it->value(), etag)) {
+            res.SetStatus(http::status::not_modified);
+            return res.MakeResponse();
+        }
+
+        if (use_gzip) {
+            res.Set(http::field::content_encoding, "gzip");
+            res.SetJsonBody(payload.gzip_body);
+        } else {
+            res.SetJsonBody(payload.body);
+        }
+        return res.MakeResponse();
+    }
+
     web::StringResponse HandleGameJoinRequest() const {
         web::JsonResponseBuilder res(req_);
         res.SetNoCache();
@@ -125,7 +142,7 @@ class ApiHandlerImpl {
             app::JoinGameResult info = app_.JoinGame(std::move(data));
 
             res.SetJsonBody({
-                {"authToken", *info.token},
+                {"authToken", info.token.ToString()},
                 {"playerId", *info.id},
             });
             return res;
@@ -149,14 +166,14 @@ class ApiHandlerImpl {
             return res;
         }
 
-        return ExecuteAuthorized([&](const app::Token& token) {
-            const auto& players = app_.GetPlayers(token);
-            res.SetJsonBody(serde::json::SerializePlayers(players));
+        return ExecuteAuthorized([&](const app::Token&, app::Player& player) {
+            const auto& players = app_.GetPlayers(player);
+            res.SetJsonText(serde::json::WritePlayers(players));
             return res;
         });
     }
 
-    web::StringResponse HandleGameStateRequest() const {
+    ApiResponse HandleGameStateRequest() const {
         web::JsonResponseBuilder res(req_);
         res.SetNoCache();
 
@@ -164,15 +181,49 @@ class ApiHandlerImpl {
             method != http::verb::get && method != http::verb::head) {
             res.SetInvalidMethod();
             res.SetAllow("GET,HEAD");
-            return res;
+            return res.MakeResponse();
         }
 
-        return ExecuteAuthorized([&](const app::Token& token) {
-            res.SetJsonBody(serde::json::SerializeGameState(
-                app_.GetPlayers(token), app_.GetLostObjects(token)
-            ));
-            return res;
-        });
+        // С параметром since клиент получает только изменения после
+        // указанного тика
+        std::optional<model::GameSession::Tick> since;
+        try {
+            since = route_.query.GetNumber<model::GameSession::Tick>("since");
+        } catch (const std::invalid_argument&) {
+            res.SetInvalidArgument("Invalid since parameter");
+            return res.MakeResponse();
+        }
+
+        const auto handle = [&](const app::Token&,
+                                app::Player& player) -> ApiResponse {
+            if (!since) {
+                // Все игроки сессии получают одно и то же тело, пока
+                // состояние сессии не изменится
+                web::SharedJsonResponseBuilder shared_res(req_);
+                shared_res.SetNoCache();
+                shared_res.SetJsonBody(app_.GetGameStateBody(
+                    player,
+                    [](const auto& players, const auto& lost_objects) {
+                        return serde::json::WriteGameState(
+                            players, lost_objects
+                        );
+                    }
+                ));
+                return shared_res.MakeResponse();
+            }
+
+            if (auto changes = app_.GetGameStateChanges(player, *since)) {
+                res.SetJsonText(serde::json::WriteGameStateChanges(*changes));
+            } else {
+                res.SetJsonText(serde::json::WriteGameStateSnapshot(
+                    app_.GetGameStateTick(player), app_.GetPlayers(player),
+                    app_.GetLostObjects(player)
+                ));
+            }
+            return res.MakeResponse();
+        };
+
+        return ExecuteAuthorized<ApiResponse>(handle);
     }
 
     web::StringResponse HandlePlayerAction() const {
@@ -192,10 +243,13 @@ class ApiHandlerImpl {
             return res;
         }
 
-        return ExecuteAuthorized([&](const app::Token& token) {
+        return ExecuteAuthorized([&](const app::Token& token,
+                                     app::Player& player) {
             try {
                 auto body = json::parse(req_.body()).as_object();
-                app_.MovePlayer(token, serde::json::ParseDirection(body));
+                app_.MovePlayer(
+                    token, player, serde::json::ParseDirection(body)
+                );
                 res.SetJsonBody(json::object{});
                 return res;
             } catch (const std::exception&) {
@@ -216,21 +270,19 @@ class ApiHandlerImpl {
             return res;
         }
 
-        const std::string_view start_key = "start";
-        const std::string_view max_items_key = "maxItems";
-
         app::PlayerRecordsData data;
-
-        auto params = boost::urls::url_view{req_.target()}.params();
-        if (auto it = params.find(start_key); it != params.end()) {
-            data.start = std::stoi((*it).value);
-        }
-        if (auto it = params.find(max_items_key); it != params.end()) {
-            data.max_items = std::stoi((*it).value);
+        try {
+            const auto& query = route_.query;
+            data.start = query.GetNumber<size_t>("start").value_or(data.start);
+            data.max_items =
+                query.GetNumber<size_t>("maxItems").value_or(data.max_items);
+        } catch (const std::invalid_argument& e) {
+            res.SetInvalidArgument(e.what());
+            return res;
         }
 
         const auto& records = app_.GetPlayerRecords(data);
-        res.SetJsonBody(serde::json::SerializePlayerRecords(records));
+        res.SetJsonText(serde::json::WritePlayerRecords(records));
         return res;
     }
 
@@ -262,40 +314,113 @@ class ApiHandlerImpl {
         }
     }
 
-    template <typename Fn>
-    web::StringResponse ExecuteAuthorized(Fn&& action) const {
+    web::StringResponse HandleMetricsRequest() const {
         web::JsonResponseBuilder res(req_);
         res.SetNoCache();
 
-        auto token = web::TryExtractToken(req_);
-        if (!token) {
-            res.SetInvalidToken("Authorization header is missing");
+        if (auto method = req_.method();
+            method != http::verb::get && method != http::verb::head) {
+            res.SetInvalidMethod();
+            res.SetAllow("GET,HEAD");
             return res;
         }
 
-        if (!app_.HasPlayer(*token)) {
+        res.SetJsonBody(serde::json::SerializeMetrics(
+            metrics::Registry::Instance().Collect()
+        ));
+        return res;
+    }
+
+    template <typename Response = web::StringResponse, typename Fn>
+    Response ExecuteAuthorized(Fn&& action) const {
+        web::JsonResponseBuilder res(req_);
+        res.SetNoCache();
+
+        auto token_text = web::TryExtractTokenText(req_);
+        if (!token_text) {
+            res.SetInvalidToken("Authorization header is missing");
+            return Response(res.MakeResponse());
+        }
+
+        // Игрок мог присоединиться уже после выбора strand для запроса.
+        // Тогда запрос выполняется не на strand его сессии и игрок для
+        // него считается неизвестным. Игрок ищется один раз: на strand
+        // приложения он может быть удалён, пока выполняется action
+        auto token = app::Token::Parse(*token_text);
+        app::PlayerHolder player = token ? app_.FindPlayer(*token) : nullptr;
+        if (!player ||
+            !player->GetSession()->GetStrand().running_in_this_thread()) {
             res.SetUnknownToken("Player token has not been found");
-            return res;
+            return Response(res.MakeResponse());
         }
 
-        return action(*token);
+        return action(*token, *player);
     }
 
     app::Application& app_;
+    const MapPayloads& map_payloads_;
+    const bool expose_metrics_;
+    const ApiRoute& route_;
     web::StringRequest req_;
-
-    std::string api_uri_ = "/api/v1";
-    std::string maps_uri_ = "/maps";
 };
 
-ApiHandler::ApiHandler(app::Application& app) : app_(app) {}
+MapPayloads::MapPayloads(const model::Game::Maps& maps) :
+    list(web::PrecomputedBody::Make(serde::json::WriteMapsList(maps))) {
+    for (const auto& map : maps) {
+        by_id.emplace(
+            *map.GetId(),
+            web::PrecomputedBody::Make(
+                json::serialize(serde::json::SerializeMapInfo(map))
+            )
+        );
+    }
+}
+
+ApiHandler::ApiHandler(app::Application& app, bool expose_metrics) :
+    app_(app),
+    map_payloads_(app.ListMaps()),
+    expose_metrics_(expose_metrics) {}
 
 bool ApiHandler::IsApiRequest(const web::StringRequest& req) {
     return req.target().starts_with(uri_prefix_);
 }
 
-web::StringResponse ApiHandler::HandleApiRequest(web::StringRequest&& req) {
-    return ApiHandlerImpl(app_, std::move(req)).HandleApiRequest();
+ApiRoute ApiHandler::Route(const web::StringRequest& req) const {
+    return RouteApiTarget(req.target());
+}
+
+app::Application::Strand* ApiHandler::SelectStrand(
+    const ApiRoute& route, const web::StringRequest& req
+) {
+    if (!route.endpoint) {
+        return nullptr;
+    }
+
+    switch (*route.endpoint) {
+        case ApiEndpoint::players:
+        case ApiEndpoint::state:
+        case ApiEndpoint::action: {
+            auto token_text = web::TryExtractTokenText(req);
+            auto token =
+                token_text ? app::Token::Parse(*token_text) : std::nullopt;
+            return token ? app_.FindPlayerStrand(*token) : nullptr;
+        }
+        case ApiEndpoint::join:
+        case ApiEndpoint::tick:
+        case ApiEndpoint::records:
+            return &app_.GetStrand();
+        default:
+            return nullptr;
+    }
+}
+
+ApiResponse ApiHandler::HandleApiRequest(
+    const ApiRoute& route, web::StringRequest&& req
+) {
+    ApiHandlerImpl handler(
+        app_, map_payloads_, expose_metrics_, route, std::move(req)
+    );
+    return handler.HandleApiRequest();
 }
 
 } // namespace handlers
@@ -1,20 +1,61 @@
 #pragma once
 
+#include "handlers/api_route.h"
 #include "web/core.h"
+#include "web/http_cache.h"
 #include "app/app.h"
+#include "utils/string_hash.h"
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <variant>
 
 namespace handlers {
 
+// Состояние игры и заранее подготовленные ответы отдаются с разделяемым
+// телом, остальные ответы - со строковым
+using ApiResponse =
+    std::variant<web::StringResponse, web::SharedStringResponse>;
+
+// Ответы о картах. Карты не меняются после загрузки игры, поэтому ответы
+// готовятся один раз при запуске сервера
+struct MapPayloads {
+    explicit MapPayloads(const model::Game::Maps& maps);
+
+    web::PrecomputedBody list;
+    std::unordered_map<
+        std::string, web::PrecomputedBody, utils::StringHasher,
+        std::equal_to<>>
+        by_id;
+};
+
 class ApiHandler {
   public:
-    ApiHandler(app::Application& app);
+    // Метрики сервера отдаются без авторизации, поэтому путь /metrics
+    // доступен, только если expose_metrics
+    ApiHandler(app::Application& app, bool expose_metrics = false);
 
     bool IsApiRequest(const web::StringRequest& req);
 
-    web::StringResponse HandleApiRequest(web::StringRequest&& req);
+    ApiRoute Route(const web::StringRequest& req) const;
+
+    // Strand, на котором нужно обработать запрос, или nullptr, если запрос
+    // не затрагивает изменяемое состояние и может быть обработан в любом
+    // потоке. Запросы игрока выполняются на strand его сессии, глобальные
+    // операции - на strand приложения
+    app::Application::Strand*
+    SelectStrand(const ApiRoute& route, const web::StringRequest& req);
+
+    // Запрос разрушается до возврата ответа: его арена освобождается, как
+    // только ответ отправлен
+    ApiResponse
+    HandleApiRequest(const ApiRoute& route, web::StringRequest&& req);
 
   private:
     app::Application& app_;
+    const MapPayloads map_payloads_;
+    const bool expose_metrics_;
     std::string uri_prefix_ = "/api";
 };
 
@@ -0,0 +1,74 @@
+#include "handlers/api_route.h"
+
+namespace handlers {
+
+namespace {
+
+const std::string_view api_uri = "/api/v1";
+const std::string_view maps_uri = "/maps";
+
+// Путь запроса без префикса API и завершающего слеша
+std::string_view GetApiPath(std::string_view path) {
+    if (!path.starts_with(api_uri)) {
+        return {};
+    }
+    path.remove_prefix(api_uri.size());
+    if (!path.empty() && path.back() == '/') {
+        path.remove_suffix(1);
+    }
+    return path;
+}
+
+// Точка API по пути. Путей немного, и цепочка сравнений обходится
+// дешевле хеширования пути
+std::optional<ApiEndpoint> FindEndpoint(std::string_view path) {
+    if (path == "/game/join") {
+        return ApiEndpoint::join;
+    }
+    if (path == "/game/players") {
+        return ApiEndpoint::players;
+    }
+    if (path == "/game/state") {
+        return ApiEndpoint::state;
+    }
+    if (path == "/game/player/action") {
+        return ApiEndpoint::action;
+    }
+    if (path.starts_with("/game/records")) {
+        return ApiEndpoint::records;
+    }
+    if (path == "/game/tick") {
+        return ApiEndpoint::tick;
+    }
+    if (path == "/metrics") {
+        return ApiEndpoint::metrics;
+    }
+    if (path == maps_uri) {
+        return ApiEndpoint::maps_list;
+    }
+    if (path.starts_with(maps_uri) && path[maps_uri.size()] == '/') {
+        return ApiEndpoint::map_info;
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+ApiRoute RouteApiTarget(std::string_view target) {
+    const auto request_target = web::RequestTarget::Parse(target);
+    const std::string_view path = GetApiPath(request_target.path);
+
+    ApiRoute route {
+        .endpoint = FindEndpoint(path),
+        .map_id = {},
+        .query = request_target.query,
+    };
+    if (route.endpoint == ApiEndpoint::map_info) {
+        // Идентификатор - весь остаток пути. Карты с таким
+        // идентификатором нет, если в нём есть слеш
+        route.map_id = path.substr(maps_uri.size() + 1);
+    }
+    return route;
+}
+
+} // namespace handlers
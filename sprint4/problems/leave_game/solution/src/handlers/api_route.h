@@ -0,0 +1,35 @@
+#pragma once
+
+#include "web/request_target.h"
+
+#include <optional>
+#include <string_view>
+
+namespace handlers {
+
+enum class ApiEndpoint {
+    join,
+    players,
+    state,
+    action,
+    records,
+    tick,
+    metrics,
+    maps_list,
+    map_info,
+};
+
+// Запрос к API, разобранный один раз до выбора strand. Ссылается на цель
+// запроса, которая не переносится в памяти при перемещении запроса
+struct ApiRoute {
+    // nullopt, если путь не относится ни к одной точке API
+    std::optional<ApiEndpoint> endpoint;
+    // Идентификатор карты для ApiEndpoint::map_info
+    std::string_view map_id;
+    web::QueryString query;
+};
+
+// Разбирает цель запроса к API. Метод запроса проверяют обработчики
+ApiRoute RouteApiTarget(std::string_view target);
+
+}  // namespace handlers
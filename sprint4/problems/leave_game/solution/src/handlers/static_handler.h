@@ -0,0 +1,114 @@
+#pragma once
+
+#include "web/content_type.h"
+#include "web/core.h"
+#include "web/static_content.h"
+#include "web/utils.h"
+#include "utils/path.h"
+
+#include <filesystem>
+#include <string>
+#include <variant>
+
+namespace handlers {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace sys = boost::system;
+namespace fs = std::filesystem;
+
+/*
+ *  Отдаёт статические файлы: загруженные при запуске - из памяти,
+ *  остальные - с диска.
+ */
+class StaticHandler {
+  public:
+    using Response = std::variant<
+        web::StringResponse, web::SharedStringResponse, web::FileResponse>;
+
+    explicit StaticHandler(std::string static_path) :
+        static_path_(std::move(static_path)),
+        static_content_(static_path_) {}
+
+    // Запрос размещён в арене соединения, которая освобождается, как только
+    // ответ передан в send. Поэтому ответ готовится отдельно, и запрос
+    // разрушается до его отправки
+    template <typename Send>
+    void operator()(web::StringRequest&& req, Send&& send) const {
+        std::visit(send, MakeResponse(std::move(req)));
+    }
+
+  private:
+    Response MakeResponse(web::StringRequest&& req) const {
+        const web::StringRequest request = std::move(req);
+
+        const auto make_string_response = [&](http::status status,
+                                              std::string_view body) {
+            web::StringResponse res(status, request.version());
+
+            res.set(http::field::content_type, web::ContentType::text::plain);
+            res.body() = body;
+            res.prepare_payload();
+            res.keep_alive(request.keep_alive());
+
+            return res;
+        };
+
+        const auto make_file_response = [&](http::status status,
+                                            http::file_body::value_type&& body,
+                                            std::string_view content_type) {
+            web::FileResponse res(status, request.version());
+
+            res.set(http::field::content_type, content_type);
+            if (request.method() == http::verb::get) {
+                res.body() = std::move(body);
+                res.prepare_payload();
+            } else {
+                res.content_length(body.size());
+            }
+            res.keep_alive(request.keep_alive());
+
+            return res;
+        };
+
+        const std::string static_path = web::GetStaticPath(request.target());
+        if (const auto* file = static_content_.Find(static_path)) {
+            return std::visit(
+                [](auto&& res) -> Response {
+                    return std::move(res);
+                },
+                web::MakeStaticResponse(request, *file)
+            );
+        }
+
+        fs::path path = static_path_ + static_path;
+        if (fs::is_directory(path)) {
+            path /= "index.html";
+        }
+
+        if (!utils::IsSubPath(path, static_path_)) {
+            return make_string_response(
+                http::status::bad_request, "Incorrect URL"
+            );
+        }
+
+        http::file_body::value_type file;
+        if (sys::error_code ec;
+            file.open(path.c_str(), beast::file_mode::read, ec), ec) {
+            return make_string_response(
+                http::status::not_found, "This page does not exist"
+            );
+        }
+
+        return make_file_response(
+            http::status::ok,
+            std::move(file),
+            web::GetMimeType(path.c_str())
+        );
+    }
+
+    const std::string static_path_;
+    const web::StaticContent static_content_;
+};
+
+}  // namespace handlers
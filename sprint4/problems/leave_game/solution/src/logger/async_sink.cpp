@@ -0,0 +1,116 @@
+#include "logger/async_sink.h"
+
+namespace logger {
+
+namespace {
+
+// При таком объёме буфер сбрасывается, не дожидаясь flush_period
+constexpr size_t max_buffer_size = 64 * 1024;
+
+} // namespace
+
+AsyncSink::AsyncSink(
+    std::ostream& out, Formatter formatter, AsyncSinkConfig config
+) :
+    out_(out),
+    formatter_(formatter),
+    config_(config),
+    queue_(config.queue_size),
+    worker_([this] {
+        Run();
+    }) {}
+
+AsyncSink::~AsyncSink() {
+    Stop();
+}
+
+void AsyncSink::consume(const logging::record_view& record) {
+    logging::record_view pending = record;
+    while (is_running_.load(std::memory_order_acquire)) {
+        if (queue_.TryPush(std::move(pending))) {
+            return;
+        }
+        if (config_.overflow == OverflowPolicy::drop) {
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+            dropped_.Increment();
+            return;
+        }
+        // Фоновый поток мог уснуть до следующего сброса
+        wake_up_.notify_one();
+        std::this_thread::yield();
+    }
+
+    // Фоновый поток остановлен: сначала дописываются записи, которые
+    // успели попасть в очередь, затем эта
+    std::lock_guard lock(mutex_);
+    Drain();
+    Format(pending);
+    Flush();
+}
+
+void AsyncSink::Stop() {
+    {
+        std::lock_guard lock(mutex_);
+        if (!is_running_.exchange(false)) {
+            return;
+        }
+    }
+    wake_up_.notify_one();
+    worker_.join();
+
+    std::lock_guard lock(mutex_);
+    while (Drain()) {
+        Flush();
+    }
+    Flush();
+}
+
+void AsyncSink::Run() {
+    using Clock = std::chrono::steady_clock;
+
+    auto next_flush = Clock::now() + config_.flush_period;
+    while (is_running_.load(std::memory_order_acquire)) {
+        std::unique_lock lock(mutex_);
+        const bool has_records = Drain();
+        if (buffer_.size() >= max_buffer_size || Clock::now() >= next_flush) {
+            Flush();
+            next_flush = Clock::now() + config_.flush_period;
+        }
+        // Пустая очередь проверяется снова к следующему сбросу. Раньше поток
+        // будят Stop и писатели, ждущие места в очереди. Stop меняет флаг
+        // под mutex_, поэтому его сигнал не теряется
+        if (!has_records && is_running_.load(std::memory_order_relaxed)) {
+            wake_up_.wait_until(lock, next_flush);
+        }
+    }
+}
+
+bool AsyncSink::Drain() {
+    bool has_records = false;
+    while (buffer_.size() < max_buffer_size) {
+        auto record = queue_.TryPop();
+        if (!record) {
+            break;
+        }
+        Format(*record);
+        has_records = true;
+    }
+    return has_records;
+}
+
+void AsyncSink::Flush() {
+    stream_.flush();
+    if (buffer_.empty()) {
+        return;
+    }
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    out_.flush();
+    buffer_.clear();
+}
+
+void AsyncSink::Format(const logging::record_view& record) {
+    formatter_(record, stream_);
+    stream_ << '\n';
+}
+
+} // namespace logger
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "metrics/metrics.h"
+#include "utils/mpsc_ring.h"
+
+#include <boost/log/core/record_view.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/utility/formatting_ostream.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+namespace logger {
+
+namespace logging = boost::log;
+namespace sinks = boost::log::sinks;
+
+// Что делать с записью, если очередь журнала заполнена
+enum class OverflowPolicy {
+    // Отбросить запись и увеличить счётчик отброшенных
+    drop,
+    // Ждать, пока фоновый поток освободит место
+    block,
+};
+
+struct AsyncSinkConfig {
+    size_t queue_size = 65536;
+    // Как часто фоновый поток сбрасывает накопленные записи в поток вывода
+    std::chrono::milliseconds flush_period {100};
+    OverflowPolicy overflow = OverflowPolicy::drop;
+};
+
+/*
+ *  Бэкенд Boost.Log, который только кладёт запись в очередь без
+ *  блокировок. Форматирование и запись в поток выполняет фоновый поток:
+ *  он забирает записи пачками и сбрасывает их раз в flush_period. После
+ *  Stop записи форматируются и пишутся синхронно.
+ *
+ *  Используется с фронтендом sinks::unlocked_sink.
+ */
+class AsyncSink : public sinks::basic_sink_backend<sinks::concurrent_feeding> {
+  public:
+    using Formatter =
+        void (*)(const logging::record_view&, logging::formatting_ostream&);
+
+    AsyncSink(std::ostream& out, Formatter formatter, AsyncSinkConfig config);
+
+    AsyncSink(const AsyncSink&) = delete;
+    AsyncSink& operator=(const AsyncSink&) = delete;
+
+    ~AsyncSink();
+
+    void consume(const logging::record_view& record);
+
+    // Дописывает оставшиеся записи и останавливает фоновый поток
+    void Stop();
+
+    uint64_t GetDroppedCount() const noexcept {
+        return dropped_count_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    void Run();
+
+    // Забирает записи из очереди и форматирует их в буфер. Возвращает
+    // false, если очередь была пуста
+    bool Drain();
+
+    void Flush();
+
+    void Format(const logging::record_view& record);
+
+    std::ostream& out_;
+    const Formatter formatter_;
+    const AsyncSinkConfig config_;
+
+    utils::MpscRing<logging::record_view> queue_;
+    std::atomic<bool> is_running_ {true};
+    std::atomic<uint64_t> dropped_count_ {0};
+    metrics::Counter& dropped_ =
+        metrics::Registry::Instance().GetCounter("log_records_dropped");
+
+    // Буфер разделяют фоновый поток и писатели после Stop
+    std::mutex mutex_;
+    std::condition_variable wake_up_;
+    std::string buffer_;
+    logging::formatting_ostream stream_ {buffer_};
+
+    std::thread worker_;
+};
+
+} // namespace logger
@@ -1,8 +1,10 @@
 #include "logger/json.h"
 
+#include <boost/log/sinks/unlocked_frontend.hpp>
+#include <boost/make_shared.hpp>
+
 namespace logger::json {
 
-namespace keywords = boost::log::keywords;
 namespace expr = boost::log::expressions;
 
 void JsonFormatter(
@@ -26,12 +28,15 @@ void JsonFormatter(
     strm << log;
 }
 
-void InitBoostLogFilter() {
+AsyncLogGuard InitBoostLogFilter(const AsyncSinkConfig& config) {
     logging::add_common_attributes();
-    logging::add_console_log(
-        std::cout,
-        keywords::auto_flush = true,
-        keywords::format = &JsonFormatter
+
+    auto backend = boost::make_shared<AsyncSink>(
+        std::cout, &JsonFormatter, config
+    );
+    logging::core::get()->add_sink(
+        boost::make_shared<sinks::unlocked_sink<AsyncSink>>(backend)
     );
+    return AsyncLogGuard(std::move(backend));
 }
 }  // namespace logger::json
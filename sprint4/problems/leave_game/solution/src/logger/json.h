@@ -1,5 +1,7 @@
 #pragma once
 
+#include "logger/async_sink.h"
+
 #include <boost/log/core.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/log/expressions.hpp>
@@ -22,5 +24,23 @@ void JsonFormatter(
     logging::formatting_ostream& strm
 );
 
-void InitBoostLogFilter();
+// Останавливает фоновую запись журнала при выходе из области видимости
+class AsyncLogGuard {
+  public:
+    explicit AsyncLogGuard(boost::shared_ptr<AsyncSink> sink) :
+        sink_(std::move(sink)) {}
+
+    AsyncLogGuard(const AsyncLogGuard&) = delete;
+    AsyncLogGuard& operator=(const AsyncLogGuard&) = delete;
+
+    ~AsyncLogGuard() {
+        sink_->Stop();
+    }
+
+  private:
+    boost::shared_ptr<AsyncSink> sink_;
+};
+
+[[nodiscard]] AsyncLogGuard
+InitBoostLogFilter(const AsyncSinkConfig& config = {});
 }  // namespace logger::json
@@ -17,4 +17,15 @@ void ReportError(sys::error_code ec, std::string_view where) {
                              << "error";
 }
 
+void ReportError(const std::exception& e, std::string_view where) {
+    BOOST_LOG_TRIVIAL(error) << logging::add_value(
+                                    logger::json::additional_data,
+                                    boost::json::value {
+                                        {"exception", e.what()},
+                                        {"where", where},
+                                    }
+                                )
+                             << "error";
+}
+
 }  // namespace logger
@@ -2,6 +2,7 @@
 
 #include <boost/system/error_code.hpp>
 
+#include <exception>
 #include <string_view>
 
 namespace logger {
@@ -9,4 +10,7 @@ namespace logger {
 namespace sys = boost::system;
 void ReportError(sys::error_code ec, std::string_view what);
 
+// Сообщает об исключении, перехваченном в where, с его текстом
+void ReportError(const std::exception& e, std::string_view where);
+
 }  // namespace logger
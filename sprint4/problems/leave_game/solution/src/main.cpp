@@ -4,6 +4,7 @@
 #include "web/server.h"
 #include "handlers/request_handler.h"
 #include "utils/thread.h"
+#include "utils/random.h"
 #include "logger/json.h"
 #include "app/app.h"
 #include "cli/parse.h"
@@ -12,7 +13,9 @@
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/signal_set.hpp>
 #include <iostream>
+#include <optional>
 #include <thread>
+#include <vector>
 
 using namespace std::literals;
 namespace net = boost::asio;
@@ -20,17 +23,60 @@ namespace sys = boost::system;
 namespace logging = boost::log;
 namespace json = boost::json;
 
+namespace {
+
+// Ядра потоков игровой логики и сетевого пула
+struct IoCores {
+    std::vector<unsigned> app;
+    std::vector<unsigned> network;
+};
+
+// Делит ядра между io_context приложения и сетевым пулом режима per-core,
+// чтобы потоков было столько же, сколько ядер. На одном ядре оба
+// получают его целиком
+IoCores SplitCores(std::vector<unsigned> cores) {
+    IoCores result;
+    const size_t network_count = std::max<size_t>(1, cores.size() / 2);
+    result.network.assign(cores.begin(), cores.begin() + network_count);
+    if (cores.size() > network_count) {
+        cores.erase(cores.begin(), cores.begin() + network_count);
+    }
+    result.app = std::move(cores);
+    return result;
+}
+
+} // namespace
+
 int main(int argc, const char* argv[]) {
     try {
         if (auto args = cli::ParseCommandLine(argc, argv)) {
-            logger::json::InitBoostLogFilter();
+            const auto log_guard = logger::json::InitBoostLogFilter({
+                .queue_size = args->log_queue_size,
+                .flush_period =
+                    std::chrono::milliseconds(args->log_flush_period),
+                .overflow = args->log_overflow == cli::LogOverflow::block
+                    ? logger::OverflowPolicy::block
+                    : logger::OverflowPolicy::drop,
+            });
 
             const auto db_url = std::getenv(postgres::db_url.c_str());
             if (!db_url) {
                 throw std::runtime_error("Cannot read database URL");
             }
 
-            const unsigned num_threads = std::thread::hardware_concurrency();
+            if (args->random_seed) {
+                utils::SetRandomSeed(*args->random_seed);
+            }
+
+            // Режим per-core экспериментальный: запросы к API по-прежнему
+            // выполняются на strand сессий в io_context приложения
+            IoCores io_cores;
+            if (args->io_mode == cli::IoMode::per_core) {
+                io_cores = SplitCores(utils::GetWorkerCores());
+            }
+            const unsigned num_threads = io_cores.app.empty()
+                ? std::thread::hardware_concurrency()
+                : static_cast<unsigned>(io_cores.app.size());
             net::io_context io(num_threads);
 
             app::Application app(
@@ -48,38 +94,55 @@ int main(int argc, const char* argv[]) {
                             .state_file = args->state_file,
                             .save_period =
                                 std::chrono::milliseconds(args->save_period),
+                            .in_background = args->save_state_in_background,
+                            .journal_commit_period = std::chrono::milliseconds(
+                                args->journal_commit_period
+                            ),
+                            .journal_snapshot_size =
+                                args->journal_snapshot_size,
                         },
                     .database =
                         postgres::DatabaseConfig{
                             .pool_size = num_threads,
                             .url = db_url,
                         },
+                    .threads_count = std::max(1u, num_threads),
                 }
             );
 
             net::signal_set signals(io, SIGINT, SIGTERM);
-            signals.async_wait([&io](
+            signals.async_wait([&app](
                                    const sys::error_code& ec,
                                    [[maybe_unused]] int signal_number
                                ) {
                 if (!ec) {
-                    io.stop();
+                    app.Stop();
                 }
             });
 
-            auto handler =
-                std::make_shared<handlers::RequestHandler>(app, args->www_root);
+            auto handler = std::make_shared<handlers::RequestHandler>(
+                app, args->www_root, args->expose_metrics
+            );
 
             const auto address = net::ip::make_address("0.0.0.0");
             constexpr net::ip::port_type port = 8080;
-            web::ServeHttp(
-                io, {address, port},
-                [&handler](auto&& req, auto&& send) {
-                    (*handler
-                    )(std::forward<decltype(req)>(req),
-                      std::forward<decltype(send)>(send));
-                }
-            );
+            const auto handle_request = [&handler](auto&& req, auto&& send) {
+                (*handler
+                )(std::forward<decltype(req)>(req),
+                  std::forward<decltype(send)>(send));
+            };
+
+            // В режиме per-core соединения обслуживаются потоками пула на
+            // своей части ядер, а io_context приложения выполняет игровую
+            // логику на остальных
+            std::optional<web::IoContextPool> network_pool;
+            if (args->io_mode == cli::IoMode::per_core) {
+                network_pool.emplace(std::move(io_cores.network));
+                web::ServeHttp(*network_pool, {address, port}, handle_request);
+                network_pool->Start();
+            } else {
+                web::ServeHttp(io, {address, port}, handle_request);
+            }
 
             BOOST_LOG_TRIVIAL(info) << logging::add_value(
                                            logger::json::additional_data,
@@ -90,10 +153,20 @@ int main(int argc, const char* argv[]) {
                                        )
                                     << "Server has started...";
 
-            utils::RunWorkers(std::max(1u, num_threads), [&io] {
+            const auto run_io = [&io] {
                 io.run();
-            });
+            };
+            if (io_cores.app.empty()) {
+                utils::RunWorkers(std::max(1u, num_threads), run_io);
+            } else {
+                utils::RunPinnedWorkers(io_cores.app, run_io);
+            }
+            if (network_pool) {
+                network_pool->Stop();
+            }
 
+            // После SIGINT или SIGTERM последнее состояние записывается
+            // синхронно, после всех фоновых сохранений
             app.SaveGameState();
 
             BOOST_LOG_TRIVIAL(info)
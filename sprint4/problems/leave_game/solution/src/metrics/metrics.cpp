@@ -0,0 +1,71 @@
+#include "metrics/metrics.h"
+
+namespace metrics {
+
+void DurationStat::Record(Duration duration) noexcept {
+    const int64_t ns = duration.count();
+
+    count_.fetch_add(1, std::memory_order_relaxed);
+    total_ns_.fetch_add(ns, std::memory_order_relaxed);
+    last_ns_.store(ns, std::memory_order_relaxed);
+
+    int64_t max = max_ns_.load(std::memory_order_relaxed);
+    while (ns > max &&
+           !max_ns_.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+DurationStat::Snapshot DurationStat::GetSnapshot() const noexcept {
+    return Snapshot {
+        .count = count_.load(std::memory_order_relaxed),
+        .total = Duration(total_ns_.load(std::memory_order_relaxed)),
+        .max = Duration(max_ns_.load(std::memory_order_relaxed)),
+        .last = Duration(last_ns_.load(std::memory_order_relaxed)),
+    };
+}
+
+Registry& Registry::Instance() {
+    static Registry registry;
+    return registry;
+}
+
+template <typename T>
+T& Registry::GetOrCreate(Storage<T>& storage, std::string_view name) {
+    std::lock_guard lock(mutex_);
+    if (auto it = storage.find(name); it != storage.end()) {
+        return *it->second;
+    }
+    auto [it, _] =
+        storage.emplace(std::string(name), std::make_unique<T>());
+    return *it->second;
+}
+
+Counter& Registry::GetCounter(std::string_view name) {
+    return GetOrCreate(counters_, name);
+}
+
+Gauge& Registry::GetGauge(std::string_view name) {
+    return GetOrCreate(gauges_, name);
+}
+
+DurationStat& Registry::GetDuration(std::string_view name) {
+    return GetOrCreate(durations_, name);
+}
+
+Registry::Snapshot Registry::Collect() const {
+    std::lock_guard lock(mutex_);
+
+    Snapshot snapshot;
+    for (const auto& [name, counter] : counters_) {
+        snapshot.counters.emplace_back(name, counter->Get());
+    }
+    for (const auto& [name, gauge] : gauges_) {
+        snapshot.gauges.emplace_back(name, gauge->Get());
+    }
+    for (const auto& [name, duration] : durations_) {
+        snapshot.durations.emplace_back(name, duration->GetSnapshot());
+    }
+    return snapshot;
+}
+
+}  // namespace metrics
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace metrics {
+
+// Монотонно растущий счётчик
+class Counter {
+  public:
+    void Increment(uint64_t value = 1) noexcept {
+        value_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t Get() const noexcept {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<uint64_t> value_ {0};
+};
+
+// Текущее значение величины, которое может как расти, так и убывать
+class Gauge {
+  public:
+    void Set(int64_t value) noexcept {
+        value_.store(value, std::memory_order_relaxed);
+    }
+
+    void Add(int64_t delta) noexcept {
+        value_.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    int64_t Get() const noexcept {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<int64_t> value_ {0};
+};
+
+// Статистика длительностей: количество замеров, сумма, максимум и
+// последний замер
+class DurationStat {
+  public:
+    using Duration = std::chrono::nanoseconds;
+
+    struct Snapshot {
+        uint64_t count = 0;
+        Duration total {0};
+        Duration max {0};
+        Duration last {0};
+    };
+
+    void Record(Duration duration) noexcept;
+
+    Snapshot GetSnapshot() const noexcept;
+
+  private:
+    std::atomic<uint64_t> count_ {0};
+    std::atomic<int64_t> total_ns_ {0};
+    std::atomic<int64_t> max_ns_ {0};
+    std::atomic<int64_t> last_ns_ {0};
+};
+
+// Записывает в статистику время жизни объекта
+class ScopedTimer {
+  public:
+    explicit ScopedTimer(DurationStat& stat) noexcept :
+        stat_(stat),
+        start_(std::chrono::steady_clock::now()) {}
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer() {
+        stat_.Record(std::chrono::steady_clock::now() - start_);
+    }
+
+  private:
+    DurationStat& stat_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/*
+ *  Реестр метрик процесса. Метрика создаётся при первом обращении по имени
+ *  и живёт до конца работы программы, поэтому ссылку на неё можно
+ *  сохранить и обновлять без блокировок.
+ */
+class Registry {
+  public:
+    struct Snapshot {
+        std::vector<std::pair<std::string, uint64_t>> counters;
+        std::vector<std::pair<std::string, int64_t>> gauges;
+        std::vector<std::pair<std::string, DurationStat::Snapshot>> durations;
+    };
+
+    static Registry& Instance();
+
+    Counter& GetCounter(std::string_view name);
+
+    Gauge& GetGauge(std::string_view name);
+
+    DurationStat& GetDuration(std::string_view name);
+
+    // Значения всех метрик, упорядоченные по имени
+    Snapshot Collect() const;
+
+  private:
+    template <typename T>
+    using Storage = std::map<std::string, std::unique_ptr<T>, std::less<>>;
+
+    template <typename T>
+    T& GetOrCreate(Storage<T>& storage, std::string_view name);
+
+    mutable std::mutex mutex_;
+    Storage<Counter> counters_;
+    Storage<Gauge> gauges_;
+    Storage<DurationStat> durations_;
+};
+
+}  // namespace metrics
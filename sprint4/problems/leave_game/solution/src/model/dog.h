@@ -3,6 +3,8 @@
 #include "model/units.h"
 #include "model/lost_object.h"
 #include "model/lost_objects_bag.h"
+#include "model/dog_store.h"
+#include "utils/tagged.h"
 
 #include <utility>
 #include <vector>
@@ -13,47 +15,87 @@ namespace model {
 
 class Dog {
   public:
+    // Совпадает с идентификатором игрока, которому принадлежит собака
+    using Id = utils::Tagged<size_t, Dog>;
+
     Dog(Point position, size_t bag_capacity, double width = 0.6) :
         Dog(position, Speed(0, 0), Direction::NORTH, bag_capacity, width) {}
 
     Dog(Point position, Speed speed, Direction direction, size_t bag_capacity,
         double width = 0.6) :
-        position_(std::move(position)),
-        prev_position_(position_),
-        speed_(std::move(speed)),
+        motion_ {
+            .position = position,
+            .prev_position = position,
+            .speed = speed,
+        },
         direction_(std::move(direction)),
         bag_(bag_capacity),
         width_(width) {}
 
     Dog(Point position, Point prev_position, Speed speed, Direction direction,
         LostObjectsBag bag, double width = 0.6, size_t score = 0) :
-        position_(std::move(position)),
-        prev_position_(prev_position),
-        speed_(std::move(speed)),
+        motion_ {
+            .position = position,
+            .prev_position = prev_position,
+            .speed = speed,
+        },
         direction_(std::move(direction)),
         bag_(std::move(bag)),
         width_(width),
         score_(score) {}
 
+    // Копия собаки не присоединена к хранилищу
+    Dog(const Dog& other) :
+        motion_(other.GetMotion()),
+        id_(other.id_),
+        direction_(other.direction_),
+        bag_(other.bag_),
+        width_(other.width_),
+        score_(other.score_) {}
+
+    // Присваивание отсоединило бы собаку от хранилища, оставив её в
+    // сессии. Состояние переносится через CopyStateFrom
+    Dog& operator=(const Dog&) = delete;
+
+    ~Dog() {
+        if (store_) {
+            store_->Detach(*this);
+        }
+    }
+
     Point GetPosition() const {
-        return position_;
+        return store_ ? store_->GetPosition(slot_) : motion_.position;
     }
 
     Point GetPrevPosition() const {
-        return prev_position_;
+        return store_ ? store_->GetPrevPosition(slot_) : motion_.prev_position;
     }
 
     void SetPosition(Point position) {
-        prev_position_ = std::move(position_);
-        position_ = std::move(position);
+        if (store_) {
+            return store_->SetPosition(slot_, position);
+        }
+        motion_.prev_position = motion_.position;
+        motion_.position = position;
     }
 
     Speed GetSpeed() const {
-        return speed_;
+        return store_ ? store_->GetSpeed(slot_) : motion_.speed;
     }
 
     void SetSpeed(Speed speed) {
-        speed_ = std::move(speed);
+        if (store_) {
+            return store_->SetSpeed(slot_, speed);
+        }
+        motion_.speed = speed;
+    }
+
+    const Id& GetId() const noexcept {
+        return id_;
+    }
+
+    void SetId(Id id) noexcept {
+        id_ = id;
     }
 
     Direction GetDirection() const {
@@ -84,32 +126,68 @@ class Dog {
         return width_;
     }
 
-    const std::chrono::milliseconds& GetLiveTime() const {
-        return live_time_;
+    std::chrono::milliseconds GetLiveTime() const {
+        return store_ ? store_->GetLiveTime(slot_) : motion_.live_time;
     }
 
     void SetLiveTime(std::chrono::milliseconds live_time) {
-        live_time_ = std::move(live_time);
+        if (store_) {
+            return store_->SetLiveTime(slot_, live_time);
+        }
+        motion_.live_time = live_time;
     }
 
-    const std::chrono::milliseconds& GetInactiveTime() const {
-        return inactive_time_;
+    std::chrono::milliseconds GetInactiveTime() const {
+        return store_ ? store_->GetInactiveTime(slot_)
+                      : motion_.inactive_time;
     }
 
     void SetInactiveTime(std::chrono::milliseconds inactive_time) {
-        inactive_time_ = std::move(inactive_time);
+        if (store_) {
+            return store_->SetInactiveTime(slot_, inactive_time);
+        }
+        motion_.inactive_time = inactive_time;
+    }
+
+    // Переносит положение, скорость, направление, рюкзак и очки other.
+    // Собака остаётся в своём хранилище
+    void CopyStateFrom(const Dog& other) {
+        SetPosition(other.GetPrevPosition());
+        SetPosition(other.GetPosition());
+        SetSpeed(other.GetSpeed());
+        direction_ = other.direction_;
+        bag_ = other.bag_;
+        score_ = other.score_;
+    }
+
+    bool IsAttached() const noexcept {
+        return store_ != nullptr;
     }
 
   private:
-    Point position_;
-    Point prev_position_;
-    Speed speed_;
+    friend class DogStore;
+
+    DogMotion GetMotion() const {
+        return DogMotion {
+            .position = GetPosition(),
+            .prev_position = GetPrevPosition(),
+            .speed = GetSpeed(),
+            .live_time = GetLiveTime(),
+            .inactive_time = GetInactiveTime(),
+        };
+    }
+
+    // Используется, пока собака не присоединена к хранилищу
+    DogMotion motion_;
+    DogStore* store_ = nullptr;
+    size_t slot_ = 0;
+
+    Id id_ {0};
+
     Direction direction_;
     LostObjectsBag bag_;
     double width_;
     size_t score_ = 0;
-    std::chrono::milliseconds live_time_{0};
-    std::chrono::milliseconds inactive_time_{0};
 };
 
 using DogHolder = std::shared_ptr<Dog>;
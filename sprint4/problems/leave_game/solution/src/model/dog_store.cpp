@@ -0,0 +1,156 @@
+#include "model/dog_store.h"
+#include "model/dog.h"
+#include "datetime/consts.h"
+
+#include <cassert>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace model {
+
+namespace {
+
+// Переносит последний элемент на место index
+template <typename T>
+void SwapRemove(std::vector<T>& values, size_t index) {
+    values[index] = values.back();
+    values.pop_back();
+}
+
+} // namespace
+
+DogStore::~DogStore() {
+    while (!dogs_.empty()) {
+        Detach(*dogs_.back());
+    }
+}
+
+void DogStore::Attach(Dog& dog) {
+    if (dog.store_) {
+        dog.store_->Detach(dog);
+    }
+
+    const DogMotion& motion = dog.motion_;
+    x_.push_back(motion.position.x);
+    y_.push_back(motion.position.y);
+    prev_x_.push_back(motion.prev_position.x);
+    prev_y_.push_back(motion.prev_position.y);
+    vx_.push_back(motion.speed.x);
+    vy_.push_back(motion.speed.y);
+    live_ms_.push_back(motion.live_time.count());
+    inactive_ms_.push_back(motion.inactive_time.count());
+    target_x_.push_back(motion.position.x);
+    target_y_.push_back(motion.position.y);
+    dogs_.push_back(&dog);
+
+    dog.store_ = this;
+    dog.slot_ = dogs_.size() - 1;
+}
+
+void DogStore::Detach(Dog& dog) {
+    assert(dog.store_ == this && dogs_[dog.slot_] == &dog);
+
+    const size_t slot = dog.slot_;
+    dog.motion_ = GetMotion(slot);
+    dog.store_ = nullptr;
+    dog.slot_ = 0;
+
+    SwapRemove(x_, slot);
+    SwapRemove(y_, slot);
+    SwapRemove(prev_x_, slot);
+    SwapRemove(prev_y_, slot);
+    SwapRemove(vx_, slot);
+    SwapRemove(vy_, slot);
+    SwapRemove(live_ms_, slot);
+    SwapRemove(inactive_ms_, slot);
+    SwapRemove(target_x_, slot);
+    SwapRemove(target_y_, slot);
+    SwapRemove(dogs_, slot);
+
+    if (slot < dogs_.size()) {
+        dogs_[slot]->slot_ = slot;
+    }
+}
+
+bool DogStore::Contains(const Dog& dog) const noexcept {
+    return dog.store_ == this;
+}
+
+size_t DogStore::GetSlot(const Dog& dog) const noexcept {
+    assert(Contains(dog));
+    return dog.slot_;
+}
+
+DogMotion DogStore::GetMotion(size_t slot) const noexcept {
+    return DogMotion {
+        .position = GetPosition(slot),
+        .prev_position = GetPrevPosition(slot),
+        .speed = GetSpeed(slot),
+        .live_time = GetLiveTime(slot),
+        .inactive_time = GetInactiveTime(slot),
+    };
+}
+
+void DogStore::Integrate(std::chrono::milliseconds time_delta) {
+    const size_t size = dogs_.size();
+    const double delta = static_cast<double>(time_delta.count());
+    const int64_t delta_ms = time_delta.count();
+
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    // Считаем так же, как скалярный цикл ниже, без FMA, чтобы результат
+    // не зависел от наличия AVX2
+    const __m256d delta_pd = _mm256_set1_pd(delta);
+    const __m256d ms_in_second_pd =
+        _mm256_set1_pd(datetime::milliseconds_in_second);
+    const __m256d zero_pd = _mm256_setzero_pd();
+    const __m256i delta_epi = _mm256_set1_epi64x(delta_ms);
+
+    for (; i + 4 <= size; i += 4) {
+        const __m256d x = _mm256_loadu_pd(x_.data() + i);
+        const __m256d y = _mm256_loadu_pd(y_.data() + i);
+        const __m256d vx = _mm256_loadu_pd(vx_.data() + i);
+        const __m256d vy = _mm256_loadu_pd(vy_.data() + i);
+
+        const __m256d dx =
+            _mm256_div_pd(_mm256_mul_pd(vx, delta_pd), ms_in_second_pd);
+        const __m256d dy =
+            _mm256_div_pd(_mm256_mul_pd(vy, delta_pd), ms_in_second_pd);
+        _mm256_storeu_pd(target_x_.data() + i, _mm256_add_pd(x, dx));
+        _mm256_storeu_pd(target_y_.data() + i, _mm256_add_pd(y, dy));
+
+        auto* live = reinterpret_cast<__m256i*>(live_ms_.data() + i);
+        _mm256_storeu_si256(
+            live, _mm256_add_epi64(_mm256_loadu_si256(live), delta_epi)
+        );
+
+        const __m256i is_standing = _mm256_castpd_si256(_mm256_and_pd(
+            _mm256_cmp_pd(vx, zero_pd, _CMP_EQ_OQ),
+            _mm256_cmp_pd(vy, zero_pd, _CMP_EQ_OQ)
+        ));
+        auto* inactive = reinterpret_cast<__m256i*>(inactive_ms_.data() + i);
+        _mm256_storeu_si256(
+            inactive,
+            _mm256_and_si256(
+                is_standing,
+                _mm256_add_epi64(_mm256_loadu_si256(inactive), delta_epi)
+            )
+        );
+    }
+#endif
+
+    constexpr double ms_in_second = datetime::milliseconds_in_second;
+    for (; i < size; ++i) {
+        target_x_[i] = x_[i] + vx_[i] * delta / ms_in_second;
+        target_y_[i] = y_[i] + vy_[i] * delta / ms_in_second;
+        live_ms_[i] += delta_ms;
+
+        const bool is_standing = vx_[i] == 0 && vy_[i] == 0;
+        inactive_ms_[i] = is_standing ? inactive_ms_[i] + delta_ms : 0;
+    }
+}
+
+}  // namespace model
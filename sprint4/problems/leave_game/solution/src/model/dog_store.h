@@ -0,0 +1,119 @@
+#pragma once
+
+#include "model/units.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace model {
+
+class Dog;
+
+// Состояние движения собаки, которое хранится в DogStore
+struct DogMotion {
+    Point position;
+    Point prev_position;
+    Speed speed;
+    std::chrono::milliseconds live_time {0};
+    std::chrono::milliseconds inactive_time {0};
+};
+
+/*
+ *  Хранилище состояния движения собак игровой сессии в виде структуры
+ *  массивов. Пока собака присоединена к хранилищу, её координаты, скорость
+ *  и таймеры читаются и пишутся через него, а объект Dog служит дескриптором.
+ *  Отсоединение собаки переносит в её слот собаку из последнего слота.
+ */
+class DogStore {
+  public:
+    DogStore() = default;
+
+    DogStore(const DogStore&) = delete;
+    DogStore& operator=(const DogStore&) = delete;
+
+    ~DogStore();
+
+    size_t Size() const noexcept {
+        return dogs_.size();
+    }
+
+    void Attach(Dog& dog);
+
+    void Detach(Dog& dog);
+
+    bool Contains(const Dog& dog) const noexcept;
+
+    size_t GetSlot(const Dog& dog) const noexcept;
+
+    Point GetPosition(size_t slot) const noexcept {
+        return Point {x_[slot], y_[slot]};
+    }
+
+    Point GetPrevPosition(size_t slot) const noexcept {
+        return Point {prev_x_[slot], prev_y_[slot]};
+    }
+
+    void SetPosition(size_t slot, Point position) noexcept {
+        prev_x_[slot] = x_[slot];
+        prev_y_[slot] = y_[slot];
+        x_[slot] = position.x;
+        y_[slot] = position.y;
+    }
+
+    Speed GetSpeed(size_t slot) const noexcept {
+        return Speed(vx_[slot], vy_[slot]);
+    }
+
+    void SetSpeed(size_t slot, Speed speed) noexcept {
+        vx_[slot] = speed.x;
+        vy_[slot] = speed.y;
+    }
+
+    std::chrono::milliseconds GetLiveTime(size_t slot) const noexcept {
+        return std::chrono::milliseconds(live_ms_[slot]);
+    }
+
+    void SetLiveTime(size_t slot, std::chrono::milliseconds time) noexcept {
+        live_ms_[slot] = time.count();
+    }
+
+    std::chrono::milliseconds GetInactiveTime(size_t slot) const noexcept {
+        return std::chrono::milliseconds(inactive_ms_[slot]);
+    }
+
+    void SetInactiveTime(size_t slot, std::chrono::milliseconds time) noexcept {
+        inactive_ms_[slot] = time.count();
+    }
+
+    // Точка, в которую собака придёт за время последнего вызова Integrate,
+    // если ей ничто не помешает
+    Point GetTarget(size_t slot) const noexcept {
+        return Point {target_x_[slot], target_y_[slot]};
+    }
+
+    Dog& GetDog(size_t slot) const noexcept {
+        return *dogs_[slot];
+    }
+
+    // Рассчитывает целевые точки всех собак и обновляет их таймеры жизни
+    // и бездействия. Бездействие считается по скорости до перемещения.
+    void Integrate(std::chrono::milliseconds time_delta);
+
+  private:
+    DogMotion GetMotion(size_t slot) const noexcept;
+
+    std::vector<double> x_;
+    std::vector<double> y_;
+    std::vector<double> prev_x_;
+    std::vector<double> prev_y_;
+    std::vector<double> vx_;
+    std::vector<double> vy_;
+    std::vector<int64_t> live_ms_;
+    std::vector<int64_t> inactive_ms_;
+    std::vector<double> target_x_;
+    std::vector<double> target_y_;
+    std::vector<Dog*> dogs_;
+};
+
+}  // namespace model
@@ -3,8 +3,13 @@
 #include "model/map.h"
 #include "model/loot_generator.h"
 #include "model/game_session.h"
+#include "utils/string_hash.h"
 #include "utils/tagged.h"
 
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <chrono>
 
@@ -24,7 +29,7 @@ class Game {
     void AddMap(Map map);
 
     void AddSession(GameSessionHolder game_session) {
-        map_id_to_index_[game_session->GetMap().GetId()] = sessions_.size();
+        map_id_to_index_[*game_session->GetMap().GetId()] = sessions_.size();
         sessions_.push_back(std::move(game_session));
     }
 
@@ -32,13 +37,18 @@ class Game {
         return maps_;
     }
 
-    const Map* FindMap(const Map::Id& id) const noexcept {
+    // Поиск по строке не создаёт временный Map::Id
+    const Map* FindMap(std::string_view id) const noexcept {
         if (auto it = map_id_to_index_.find(id); it != map_id_to_index_.end()) {
             return &maps_.at(it->second);
         }
         return nullptr;
     }
 
+    const Map* FindMap(const Map::Id& id) const noexcept {
+        return FindMap(std::string_view(*id));
+    }
+
     bool ContainsMap(const Map::Id& id) const noexcept {
         return FindMap(id) != nullptr;
     }
@@ -69,8 +79,8 @@ class Game {
     }
 
   private:
-    using MapIdToIndex =
-        std::unordered_map<Map::Id, size_t, utils::TaggedHasher<Map::Id>>;
+    using MapIdToIndex = std::unordered_map<
+        std::string, size_t, utils::StringHasher, std::equal_to<>>;
 
     GameSessions sessions_;
     std::vector<Map> maps_;
@@ -8,34 +8,68 @@
 #include "datetime/consts.h"
 #include "utils/tagged.h"
 #include "utils/random.h"
+#include "utils/timing_wheel.h"
 
 #include <boost/asio/strand.hpp>
 #include <boost/asio/io_context.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <optional>
 #include <chrono>
 #include <deque>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace model {
 
 namespace net = boost::asio;
 
+/*
+ *  Игровая сессия на одной карте. Методы, изменяющие или читающие состояние
+ *  сессии, должны вызываться на её strand, если io_context уже запущен.
+ */
 class GameSession : public std::enable_shared_from_this<GameSession> {
   public:
     using Id = utils::Tagged<std::string, GameSession>;
     using LostObjects = std::vector<LostObject>;
     using Strand = net::strand<net::io_context::executor_type>;
-
+    using Dogs = std::vector<DogHolder>;
+    // Номер тика. Увеличивается при каждом вызове UpdateGameState
+    using Tick = uint64_t;
+
+    // Изменения сессии после некоторого тика: текущее состояние
+    // изменившихся собак и появившихся предметов, а также идентификаторы
+    // удалённых
+    struct Changes {
+        Tick tick = 0;
+        Dogs changed_dogs;
+        std::vector<Dog::Id> removed_dogs;
+        LostObjects added_lost_objects;
+        std::vector<LostObject::Id> removed_lost_objects;
+    };
+
+    // Количество тиков, изменения которых хранит сессия
+    static constexpr size_t changes_history_size = 64;
+
+    // Случайные точки появления собак и трофеев берутся из генератора,
+    // засеянного random_seed. Генератор принадлежит сессии, поэтому при
+    // одном засеве последовательность не зависит от того, какой поток
+    // выполняет strand сессии
     GameSession(
         net::io_context& io, const Map& map, LootGenerator& loot_generator,
-        std::chrono::milliseconds max_inactive_time
+        std::chrono::milliseconds max_inactive_time,
+        uint64_t random_seed = utils::MakeRandomSeed(0)
     ) :
         strand_(net::make_strand(io)),
         id_(*map.GetId()),
         map_(map),
         loot_generator_(loot_generator),
-        max_inactive_time_(std::move(max_inactive_time)) {
+        max_inactive_time_(std::move(max_inactive_time)),
+        random_engine_(random_seed) {
         loot_ticker_ = std::make_shared<datetime::Ticker>(
             strand_, loot_generator_.GetInterval(),
             [this](const auto& dt) {
@@ -53,68 +87,166 @@ class GameSession : public std::enable_shared_from_this<GameSession> {
         return map_;
     }
 
+    Strand& GetStrand() {
+        return strand_;
+    }
+
     void AddDog(DogHolder dog) {
+        dog_store_.Attach(*dog);
+        ScheduleInactivityCheck(dog, inactivity_wheel_.GetNow());
+        pending_changes_.changed_dogs.push_back(dog->GetId());
         dogs_.push_back(std::move(dog));
+        MarkStateChanged();
 
         net::dispatch(strand_, [self = shared_from_this()] {
             self->GenerateLoot(self->loot_generator_.GetInterval());
         });
     }
 
-    DogHolder CreateDog(bool randomize_spawn_points) {
-        Point start_position = randomize_spawn_points ? MakeRandomPosition()
-                                                      : MakeDefaultPosition();
+    // Создаёт собаку в точке появления, не добавляя её в сессию.
+    // Читает только карту и берёт случайную точку из engine, поэтому может
+    // вызываться вне strand сессии
+    DogHolder
+    MakeDog(bool randomize_spawn_points, utils::RandomEngine& engine) const {
+        Point start_position = randomize_spawn_points
+            ? MakeRandomPosition(engine)
+            : MakeDefaultPosition();
 
-        auto dog = std::make_shared<Dog>(
+        return std::make_shared<Dog>(
             start_position, Speed(0, 0), Direction::NORTH,
             map_.GetConfig().bag_capacity
         );
+    }
+
+    DogHolder CreateDog(bool randomize_spawn_points) {
+        auto dog = MakeDog(randomize_spawn_points, random_engine_);
         AddDog(dog);
         return dog;
     }
 
     void AddLostObject(LostObject lost_object) {
+        pending_changes_.added_lost_objects.push_back(lost_object.GetId());
         lost_objects_.push_back(std::move(lost_object));
+        MarkStateChanged();
     }
 
-    void UpdateGameState(const std::chrono::milliseconds& time_delta) {
-        for (const auto& dog : dogs_) {
-            const auto& position = dog->GetPosition();
-            const auto& speed = dog->GetSpeed();
-
-            Point new_position = {
-                position.x + speed.x * time_delta.count() /
-                                 datetime::milliseconds_in_second,
-                position.y + speed.y * time_delta.count() /
-                                 datetime::milliseconds_in_second,
-            };
+    // Отмечает изменение собаки, сделанное вне UpdateGameState
+    void MarkDogChanged(const Dog& dog) {
+        pending_changes_.changed_dogs.push_back(dog.GetId());
+        MarkStateChanged();
+    }
+
+    // Версия видимого игрокам состояния сессии. Меняется при каждом тике и
+    // изменении собак или предметов. Может читаться из любого потока
+    uint64_t GetStateVersion() const noexcept {
+        return state_version_.load(std::memory_order_acquire);
+    }
+
+    // Отмечает изменение состояния, которое сессия не видит сама, например
+    // появление игрока. Может вызываться из любого потока
+    void MarkStateChanged() noexcept {
+        state_version_.fetch_add(1, std::memory_order_release);
+    }
+
+    // Продвигает состояние сессии на time_delta и возвращает собак,
+    // отправленных на покой из-за бездействия. Они уже удалены из сессии
+    Dogs UpdateGameState(const std::chrono::milliseconds& time_delta) {
+        dog_store_.Integrate(time_delta);
 
-            auto suitable_point = FindSuitablePoint(position, new_position);
+        for (size_t slot = 0; slot < dog_store_.Size(); ++slot) {
+            const Point position = dog_store_.GetPosition(slot);
+            const Point target = dog_store_.GetTarget(slot);
+
+            // Стоящей собаке не нужно искать дорогу
+            if (position.x == target.x && position.y == target.y) {
+                dog_store_.SetPosition(slot, position);
+                continue;
+            }
+
+            pending_changes_.changed_dogs.push_back(
+                dog_store_.GetDog(slot).GetId()
+            );
+            auto suitable_point = FindSuitablePoint(position, target);
 
             if (suitable_point) {
-                dog->SetPosition(*suitable_point);
-                if (suitable_point->x != new_position.x ||
-                    suitable_point->y != new_position.y) {
-                    dog->SetSpeed(Speed(0, 0));
+                dog_store_.SetPosition(slot, *suitable_point);
+                if (suitable_point->x != target.x ||
+                    suitable_point->y != target.y) {
+                    dog_store_.SetSpeed(slot, Speed(0, 0));
                 }
             }
+        }
+        ProcessLoot();
+        auto retired = RetireInactiveDogs(time_delta);
+        CommitChanges();
+        return retired;
+    }
 
-            dog->SetLiveTime(dog->GetLiveTime() + time_delta);
+    Tick GetTick() const noexcept {
+        return tick_;
+    }
 
-            if (speed.x == 0 && speed.y == 0) {
-                dog->SetInactiveTime(dog->GetInactiveTime() + time_delta);
-            } else {
-                dog->SetInactiveTime(std::chrono::milliseconds(0));
+    // Изменения после тика since, включая сделанные после последнего тика.
+    // nullopt, если история изменений уже не покрывает since и клиенту
+    // нужно полное состояние
+    std::optional<Changes> GetChangesSince(Tick since) const {
+        const Tick oldest_since = changes_history_.empty()
+            ? tick_
+            : changes_history_.front().tick - 1;
+        if (since < oldest_since || since > tick_) {
+            return std::nullopt;
+        }
+
+        std::unordered_set<size_t> changed_dogs;
+        std::unordered_set<size_t> added_lost_objects;
+        Changes changes {
+            .tick = tick_,
+            .changed_dogs = {},
+            .removed_dogs = {},
+            .added_lost_objects = {},
+            .removed_lost_objects = {},
+        };
+
+        const auto collect = [&](const TickChanges& tick_changes) {
+            for (const auto& id : tick_changes.changed_dogs) {
+                changed_dogs.insert(*id);
             }
+            for (const auto& id : tick_changes.added_lost_objects) {
+                added_lost_objects.insert(*id);
+            }
+            changes.removed_dogs.insert(
+                changes.removed_dogs.end(), tick_changes.removed_dogs.begin(),
+                tick_changes.removed_dogs.end()
+            );
+            changes.removed_lost_objects.insert(
+                changes.removed_lost_objects.end(),
+                tick_changes.removed_lost_objects.begin(),
+                tick_changes.removed_lost_objects.end()
+            );
+        };
 
-            if (dog->GetInactiveTime() >= max_inactive_time_) {
-                continue;
+        for (const auto& tick_changes : changes_history_) {
+            if (tick_changes.tick > since) {
+                collect(tick_changes);
             }
         }
-        ProcessLoot();
+        collect(pending_changes_);
+
+        // Удалённые собаки и предметы уже отсутствуют в сессии
+        for (const auto& dog : dogs_) {
+            if (changed_dogs.contains(*dog->GetId())) {
+                changes.changed_dogs.push_back(dog);
+            }
+        }
+        for (const auto& lost_object : lost_objects_) {
+            if (added_lost_objects.contains(*lost_object.GetId())) {
+                changes.added_lost_objects.push_back(lost_object);
+            }
+        }
+        return changes;
     }
 
-    const std::vector<DogHolder>& GetDogs() const {
+    const Dogs& GetDogs() const {
         return dogs_;
     }
 
@@ -122,21 +254,90 @@ class GameSession : public std::enable_shared_from_this<GameSession> {
         return lost_objects_;
     }
 
+    // На место удалённой собаки переносится последняя
     void RemoveDog(const DogHolder& dog) {
-        std::erase(dogs_, dog);
+        if (!dog_store_.Contains(*dog)) {
+            return;
+        }
+        const size_t slot = dog_store_.GetSlot(*dog);
+        assert(dogs_[slot] == dog);
+        dog_store_.Detach(*dog);
+        pending_changes_.removed_dogs.push_back(dog->GetId());
+        // dog может ссылаться на элемент dogs_
+        dogs_[slot] = std::move(dogs_.back());
+        dogs_.pop_back();
+        MarkStateChanged();
+    }
+
+    // Применяет изменения, сделанные не этой сессией, например прочитанные
+    // из журнала: переносит состояние изменившихся собак, удаляет собак и
+    // предметы и добавляет предметы, которых ещё нет в сессии. Повторное
+    // применение тех же изменений ничего не меняет. Возвращает удалённых
+    // собак
+    Dogs ApplyChanges(
+        const std::vector<Dog>& changed_dogs,
+        const std::vector<Dog::Id>& removed_dogs,
+        const LostObjects& added_lost_objects,
+        const std::vector<LostObject::Id>& removed_lost_objects
+    ) {
+        std::unordered_map<size_t, DogHolder> dogs_by_id;
+        for (const auto& dog : dogs_) {
+            dogs_by_id.emplace(*dog->GetId(), dog);
+        }
+
+        for (const Dog& state : changed_dogs) {
+            if (auto it = dogs_by_id.find(*state.GetId());
+                it != dogs_by_id.end()) {
+                it->second->CopyStateFrom(state);
+                pending_changes_.changed_dogs.push_back(state.GetId());
+            }
+        }
+
+        Dogs removed;
+        for (const auto& id : removed_dogs) {
+            if (auto it = dogs_by_id.find(*id); it != dogs_by_id.end()) {
+                RemoveDog(it->second);
+                removed.push_back(std::move(it->second));
+                dogs_by_id.erase(it);
+            }
+        }
+
+        std::unordered_set<size_t> lost_object_ids;
+        for (const auto& id : removed_lost_objects) {
+            lost_object_ids.insert(*id);
+        }
+        std::erase_if(lost_objects_, [&](const LostObject& object) {
+            if (lost_object_ids.contains(*object.GetId())) {
+                pending_changes_.removed_lost_objects.push_back(object.GetId());
+                return true;
+            }
+            return false;
+        });
+
+        for (const auto& object : lost_objects_) {
+            lost_object_ids.insert(*object.GetId());
+        }
+        for (const auto& object : added_lost_objects) {
+            if (lost_object_ids.insert(*object.GetId()).second) {
+                AddLostObject(object);
+            }
+        }
+
+        MarkStateChanged();
+        return removed;
     }
 
   private:
-    Point MakeRandomPosition() const {
+    Point MakeRandomPosition(utils::RandomEngine& engine) const {
         const auto& roads = map_.GetRoads();
         size_t road_index =
-            utils::GenerateRandomNumber<size_t>(0, roads.size() - 1);
+            utils::GenerateRandomNumber<size_t>(engine, 0, roads.size() - 1);
         const auto& road = roads[road_index];
 
         if (road.IsHorizontal()) {
             return Point{
                 .x = utils::GenerateRandomNumber<double>(
-                    road.GetStart().x, road.GetEnd().x
+                    engine, road.GetStart().x, road.GetEnd().x
                 ),
                 .y = static_cast<double>(road.GetStart().y),
             };
@@ -144,7 +345,7 @@ class GameSession : public std::enable_shared_from_this<GameSession> {
             return Point{
                 .x = static_cast<double>(road.GetStart().x),
                 .y = utils::GenerateRandomNumber<double>(
-                    road.GetStart().y, road.GetEnd().y
+                    engine, road.GetStart().y, road.GetEnd().y
                 ),
             };
         }
@@ -157,54 +358,43 @@ class GameSession : public std::enable_shared_from_this<GameSession> {
 
     std::optional<Point>
     FindSuitablePoint(const Point& start, const Point& end) const {
-        std::vector<Road> start_roads;
-        for (const auto& road : map_.GetRoads()) {
-            if (road.Contains(start)) {
-                start_roads.push_back(road);
-            }
-        }
-
-        if (start_roads.empty()) {
-            return std::nullopt;
-        }
-
-        Point most_far = start_roads.front().Bound(end);
-
-        if (start_roads.size() == 1) {
-            return most_far;
-        }
+        std::optional<Point> most_far;
+        Dimension max_distance = 0;
 
-        Dimension max_distance = FindDistance(start, most_far);
-
-        for (size_t i = 1; i < start_roads.size(); ++i) {
-            Point pretender = start_roads[i].Bound(end);
+        map_.ForEachRoadContaining(start, [&](const Road& road) {
+            Point pretender = road.Bound(end);
             Dimension distance = FindDistance(start, pretender);
-            if (distance > max_distance) {
+            if (!most_far || distance > max_distance) {
                 most_far = pretender;
                 max_distance = distance;
             }
-        }
+        });
 
         return most_far;
     }
 
-    LostObject MakeLostObject() const {
-        const auto& loot_types = map_.GetLootTypes();
-
-        auto type =
-            utils::GenerateRandomNumber<size_t>(0, loot_types.size() - 1);
+    LostObject MakeLostObject(size_t type, utils::RandomEngine& engine) const {
         return LostObject{
-            MakeRandomPosition(),
+            MakeRandomPosition(engine),
             type,
-            loot_types[type].value,
+            map_.GetLootTypes()[type].value,
         };
     }
 
     void GenerateLoot(const LootGenerator::TimeInterval& dt) {
         size_t generated_count =
             loot_generator_.Generate(dt, lost_objects_.size(), dogs_.size());
-        for (size_t i = 0; i < generated_count; ++i) {
-            lost_objects_.push_back(MakeLostObject());
+        if (generated_count == 0) {
+            return;
+        }
+
+        std::vector<size_t> types(generated_count);
+        utils::GenerateRandomNumbers<size_t>(
+            random_engine_, 0, map_.GetLootTypes().size() - 1, types
+        );
+
+        for (size_t type : types) {
+            AddLostObject(MakeLostObject(type, random_engine_));
         }
     }
 
@@ -224,12 +414,25 @@ class GameSession : public std::enable_shared_from_this<GameSession> {
             items.emplace_back(office.GetPosition(), office.GetWidth());
         }
 
+        // Собиратели - только переместившиеся собаки, в порядке слотов
         ItemDogProvider::Gatherers gatherers;
-        gatherers.reserve(dogs_.size());
-        for (const auto& dog : dogs_) {
+        std::vector<size_t> gatherer_slots;
+        for (size_t slot = 0; slot < dog_store_.Size(); ++slot) {
+            const Point prev_position = dog_store_.GetPrevPosition(slot);
+            const Point position = dog_store_.GetPosition(slot);
+            if (prev_position.x == position.x &&
+                prev_position.y == position.y) {
+                continue;
+            }
+
             gatherers.emplace_back(
-                dog->GetPrevPosition(), dog->GetPosition(), dog->GetWidth()
+                prev_position, position, dog_store_.GetDog(slot).GetWidth()
             );
+            gatherer_slots.push_back(slot);
+        }
+
+        if (gatherers.empty()) {
+            return;
         }
 
         auto events = physics::FindGatherEvents(
@@ -241,8 +444,8 @@ class GameSession : public std::enable_shared_from_this<GameSession> {
         }
 
         for (const auto& event : events) {
-            auto& dog = dogs_[event.gatherer_id];
-            auto& bag = dog->GetBag();
+            Dog& dog = dog_store_.GetDog(gatherer_slots[event.gatherer_id]);
+            auto& bag = dog.GetBag();
 
             if (event.item_id < offices_start) {
                 auto& obj = lost_objects_[event.item_id];
@@ -256,23 +459,93 @@ class GameSession : public std::enable_shared_from_this<GameSession> {
                 if (bag.IsEmpty()) {
                     continue;
                 }
-                dog->SetScore(dog->GetScore() + bag.Drop());
+                dog.SetScore(dog.GetScore() + bag.Drop());
             }
         }
 
-        std::erase_if(lost_objects_, [](const auto& obj) {
-            return obj.IsPickedUp();
+        std::erase_if(lost_objects_, [&](const auto& obj) {
+            if (obj.IsPickedUp()) {
+                pending_changes_.removed_lost_objects.push_back(obj.GetId());
+                return true;
+            }
+            return false;
         });
     }
 
+    // Планирует проверку собаки на момент, когда её бездействие, отсчитанное
+    // от now, достигнет предела
+    void ScheduleInactivityCheck(
+        const DogHolder& dog, std::chrono::milliseconds now
+    ) {
+        const auto time_left = std::max(
+            max_inactive_time_ - dog->GetInactiveTime(),
+            std::chrono::milliseconds(0)
+        );
+        inactivity_wheel_.Schedule(now + time_left, dog);
+    }
+
+    // Проверяет только собак, чей срок в колесе истёк. Срок не позже
+    // момента, когда собака действительно станет бездействующей: движение
+    // лишь сбрасывает бездействие, и тогда проверка планируется заново
+    Dogs RetireInactiveDogs(const std::chrono::milliseconds& time_delta) {
+        Dogs retired;
+        const auto now = inactivity_wheel_.GetNow() + time_delta;
+        inactivity_wheel_.Advance(now, [&](std::weak_ptr<Dog>&& weak_dog) {
+            auto dog = weak_dog.lock();
+            // Собака могла быть удалена из сессии раньше
+            if (!dog || !dog->IsAttached()) {
+                return;
+            }
+
+            if (dog->GetInactiveTime() < max_inactive_time_) {
+                ScheduleInactivityCheck(dog, now);
+                return;
+            }
+
+            RemoveDog(dog);
+            retired.push_back(std::move(dog));
+        });
+        return retired;
+    }
+
+    // Переносит изменения, накопленные с прошлого тика, в историю
+    void CommitChanges() {
+        pending_changes_.tick = ++tick_;
+        changes_history_.push_back(std::move(pending_changes_));
+        pending_changes_ = {};
+        if (changes_history_.size() > changes_history_size) {
+            changes_history_.pop_front();
+        }
+        MarkStateChanged();
+    }
+
+    // Идентификаторы объектов, изменённых за один тик
+    struct TickChanges {
+        Tick tick = 0;
+        std::vector<Dog::Id> changed_dogs;
+        std::vector<Dog::Id> removed_dogs;
+        std::vector<LostObject::Id> added_lost_objects;
+        std::vector<LostObject::Id> removed_lost_objects;
+    };
+
     Strand strand_;
     Id id_;
-    std::vector<DogHolder> dogs_;
+    // dogs_[slot] владеет собакой из слота slot хранилища: собаки
+    // добавляются в конец и удаляются так же, как в хранилище. Хранилище
+    // разрушается первым и отсоединяет собак, начиная с конца
+    Dogs dogs_;
+    DogStore dog_store_;
     const Map& map_;
     LootGenerator& loot_generator_;
     std::shared_ptr<datetime::Ticker> loot_ticker_;
     LostObjects lost_objects_;
     std::chrono::milliseconds max_inactive_time_;
+    utils::TimingWheel<std::weak_ptr<Dog>> inactivity_wheel_;
+    utils::RandomEngine random_engine_;
+    Tick tick_ = 0;
+    std::deque<TickChanges> changes_history_;
+    TickChanges pending_changes_;
+    std::atomic<uint64_t> state_version_ {0};
 };
 
 using GameSessionHolder = std::shared_ptr<GameSession>;
@@ -3,6 +3,8 @@
 #include "model/units.h"
 #include "utils/tagged.h"
 
+#include <algorithm>
+
 namespace model {
 
 class LostObject {
@@ -15,12 +17,19 @@ class LostObject {
         id_(id),
         position_(position),
         type_(type),
-        value_(value) {}
+        value_(value),
+        width_(width) {}
 
     LostObject(
         Point position, size_t type, size_t value, double width = 0.0
     ) noexcept :
-        LostObject(Id(free_id_++), position, type, value) {}
+        LostObject(Id(free_id_++), position, type, value, width) {}
+
+    // Новые предметы получат идентификаторы больше id. Вызывается при
+    // восстановлении сохранённых предметов
+    static void ReserveId(Id id) noexcept {
+        free_id_ = std::max(free_id_, *id + 1);
+    }
 
     const Id& GetId() const noexcept {
         return id_;
@@ -20,4 +20,8 @@ void Map::AddOffice(Office office) {
     }
 }
 
+void Map::BuildRoadIndex() {
+    road_index_ = RoadIndex(roads_);
+}
+
 }  // namespace model
@@ -2,6 +2,7 @@
 
 #include "utils/tagged.h"
 #include "model/road.h"
+#include "model/road_index.h"
 #include "model/building.h"
 #include "model/office.h"
 #include "model/dog.h"
@@ -63,6 +64,30 @@ class Map {
         roads_.emplace_back(road);
     }
 
+    // Строит индекс дорог. Вызывается один раз после загрузки карты
+    void BuildRoadIndex();
+
+    // Вызывает fn(road) для каждой дороги, содержащей точку, в порядке
+    // их добавления на карту
+    template <typename Fn>
+    void ForEachRoadContaining(const Point& point, Fn&& fn) const {
+        if (road_index_.RoadsCount() != roads_.size()) {
+            for (const auto& road : roads_) {
+                if (road.Contains(point)) {
+                    fn(road);
+                }
+            }
+            return;
+        }
+
+        road_index_.ForEachCandidate(point, [&](RoadIndex::RoadId id) {
+            const Road& road = roads_[id];
+            if (road.Contains(point)) {
+                fn(road);
+            }
+        });
+    }
+
     void AddBuilding(const Building& building) {
         buildings_.emplace_back(building);
     }
@@ -85,6 +110,7 @@ class Map {
     std::string name_;
     LootTypes loot_types_;
     Roads roads_;
+    RoadIndex road_index_;
     Buildings buildings_;
     OfficeIdToIndex warehouse_id_to_index_;
     Offices offices_;
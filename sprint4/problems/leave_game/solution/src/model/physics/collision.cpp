@@ -1,9 +1,131 @@
 #include "collision.h"
 
+#include <cmath>
+#include <optional>
 #include <stdexcept>
+#include <tuple>
 
 namespace model::physics {
 
+namespace {
+
+// Запас для широкой фазы, покрывающий погрешность вычисления sq_distance
+constexpr double reach_margin = 1e-6;
+
+bool IsPointsEqual(Point p1, Point p2) {
+    return p1.x == p2.x && p1.y == p2.y;
+}
+
+void SortEventsByTime(std::vector<GatheringEvent>& events) {
+    std::sort(
+        events.begin(),
+        events.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.time < rhs.time; }
+    );
+}
+
+void TryGather(
+    const Gatherer& gatherer, size_t gatherer_id, const Item& item,
+    size_t item_id, std::vector<GatheringEvent>& result
+) {
+    const CollectionResult collect_result =
+        TryCollectPoint(gatherer.start_pos, gatherer.end_pos, item.position);
+
+    if (collect_result.IsCollected(item.width + gatherer.width)) {
+        result.push_back(GatheringEvent {
+            .item_id = item_id,
+            .gatherer_id = gatherer_id,
+            .sq_distance = collect_result.sq_distance,
+            .time = collect_result.proj_ratio,
+        });
+    }
+}
+
+/*
+ *  Сетка предметов для широкой фазы поиска столкновений.
+ *  Предметы упорядочены по ячейке (сначала строка, затем столбец), поэтому
+ *  ячейки одной строки сетки образуют непрерывный диапазон, который
+ *  находится двоичным поиском.
+ */
+class ItemsGrid {
+  public:
+    struct Entry {
+        int64_t row;
+        int64_t column;
+        size_t item_id;
+    };
+
+    ItemsGrid(const std::vector<Item>& items, double cell_size) :
+        cell_size_(cell_size) {
+        entries_.reserve(items.size());
+        for (size_t item_id = 0; item_id < items.size(); ++item_id) {
+            const Point& position = items[item_id].position;
+            entries_.push_back(Entry {
+                .row = ToCell(position.y),
+                .column = ToCell(position.x),
+                .item_id = item_id,
+            });
+        }
+
+        std::sort(
+            entries_.begin(),
+            entries_.end(),
+            [](const auto& lhs, const auto& rhs) {
+                return std::tie(lhs.row, lhs.column, lhs.item_id) <
+                    std::tie(rhs.row, rhs.column, rhs.item_id);
+            }
+        );
+    }
+
+    // Количество ячеек, покрывающих прямоугольник, или nullopt, если
+    // прямоугольник не удаётся разбить на ячейки
+    std::optional<double> CountCells(Point left_bottom, Point right_top) const {
+        const double columns = std::floor(right_top.x / cell_size_) -
+            std::floor(left_bottom.x / cell_size_) + 1;
+        const double rows = std::floor(right_top.y / cell_size_) -
+            std::floor(left_bottom.y / cell_size_) + 1;
+        const double cells = columns * rows;
+        if (!std::isfinite(cells)) {
+            return std::nullopt;
+        }
+        return cells;
+    }
+
+    // Вызывает fn(item_id) для каждого предмета из ячеек, покрывающих
+    // прямоугольник
+    template <typename Fn>
+    void ForEachItem(Point left_bottom, Point right_top, Fn&& fn) const {
+        const int64_t first_column = ToCell(left_bottom.x);
+        const int64_t last_column = ToCell(right_top.x);
+        const int64_t last_row = ToCell(right_top.y);
+
+        for (int64_t row = ToCell(left_bottom.y); row <= last_row; ++row) {
+            auto first = std::lower_bound(
+                entries_.begin(), entries_.end(), std::pair {row, first_column},
+                [](const Entry& entry, const auto& cell) {
+                    return std::tie(entry.row, entry.column) <
+                        std::tie(cell.first, cell.second);
+                }
+            );
+            for (; first != entries_.end() && first->row == row &&
+                 first->column <= last_column;
+                 ++first) {
+                fn(first->item_id);
+            }
+        }
+    }
+
+  private:
+    int64_t ToCell(double coord) const {
+        return static_cast<int64_t>(std::floor(coord / cell_size_));
+    }
+
+    double cell_size_;
+    std::vector<Entry> entries_;
+};
+
+} // namespace
+
 CollectionResult TryCollectPoint(Point a, Point b, Point c) {
     // Проверим, что перемещение ненулевое.
     // Тут приходится использовать строгое равенство, а не приближённое,
@@ -27,45 +149,106 @@ CollectionResult TryCollectPoint(Point a, Point b, Point c) {
 }
 
 std::vector<GatheringEvent>
-FindGatherEvents(const ItemGathererProvider& provider) {
-    const auto is_points_equal = [](Point p1, Point p2) {
-        return p1.x == p2.x && p1.y == p2.y;
-    };
-
+FindGatherEventsBruteForce(const ItemGathererProvider& provider) {
     std::vector<GatheringEvent> result;
 
     for (size_t gatherer_id = 0; gatherer_id < provider.GatherersCount();
          ++gatherer_id) {
         const Gatherer gatherer = provider.GetGatherer(gatherer_id);
-        if (is_points_equal(gatherer.start_pos, gatherer.end_pos)) {
+        if (IsPointsEqual(gatherer.start_pos, gatherer.end_pos)) {
             continue;
         }
 
         for (size_t item_id = 0; item_id < provider.ItemsCount(); ++item_id) {
             const Item item = provider.GetItem(item_id);
+            TryGather(gatherer, gatherer_id, item, item_id, result);
+        }
+    }
 
-            const CollectionResult collect_result = TryCollectPoint(
-                gatherer.start_pos,
-                gatherer.end_pos,
-                item.position
-            );
+    SortEventsByTime(result);
+    return result;
+}
+
+std::vector<GatheringEvent>
+FindGatherEvents(const ItemGathererProvider& provider) {
+    if (provider.ItemsCount() == 0 || provider.GatherersCount() == 0) {
+        return {};
+    }
+
+    std::vector<Item> items;
+    items.reserve(provider.ItemsCount());
+    double max_item_width = 0;
+    for (size_t item_id = 0; item_id < provider.ItemsCount(); ++item_id) {
+        const Item& item = items.emplace_back(provider.GetItem(item_id));
+        max_item_width = std::max(max_item_width, item.width);
+    }
+
+    std::vector<Gatherer> gatherers;
+    gatherers.reserve(provider.GatherersCount());
+    double max_gatherer_width = 0;
+    for (size_t gatherer_id = 0; gatherer_id < provider.GatherersCount();
+         ++gatherer_id) {
+        const Gatherer& gatherer =
+            gatherers.emplace_back(provider.GetGatherer(gatherer_id));
+        max_gatherer_width = std::max(max_gatherer_width, gatherer.width);
+    }
 
-            if (collect_result.IsCollected(item.width + gatherer.width)) {
-                result.push_back(GatheringEvent {
-                    .item_id = item_id,
-                    .gatherer_id = gatherer_id,
-                    .sq_distance = collect_result.sq_distance,
-                    .time = collect_result.proj_ratio,
-                });
+    // Сторона ячейки не меньше максимального радиуса сбора, поэтому
+    // предметы, до которых может дотянуться собиратель, лежат в ячейках,
+    // покрывающих его путь, расширенный на этот радиус
+    const double cell_size = max_item_width + max_gatherer_width;
+    std::optional<ItemsGrid> grid;
+    if (cell_size > 0 && std::isfinite(cell_size)) {
+        grid.emplace(items, cell_size);
+    }
+
+    std::vector<GatheringEvent> result;
+    std::vector<size_t> candidates;
+
+    for (size_t gatherer_id = 0; gatherer_id < gatherers.size();
+         ++gatherer_id) {
+        const Gatherer& gatherer = gatherers[gatherer_id];
+        if (IsPointsEqual(gatherer.start_pos, gatherer.end_pos)) {
+            continue;
+        }
+
+        const double reach = max_item_width + gatherer.width + reach_margin;
+        const Point left_bottom {
+            std::min(gatherer.start_pos.x, gatherer.end_pos.x) - reach,
+            std::min(gatherer.start_pos.y, gatherer.end_pos.y) - reach,
+        };
+        const Point right_top {
+            std::max(gatherer.start_pos.x, gatherer.end_pos.x) + reach,
+            std::max(gatherer.start_pos.y, gatherer.end_pos.y) + reach,
+        };
+
+        // Для длинного пути перебор ячеек дороже перебора всех предметов
+        const auto cells_count = grid
+            ? grid->CountCells(left_bottom, right_top)
+            : std::nullopt;
+        if (!cells_count || *cells_count > static_cast<double>(items.size())) {
+            for (size_t item_id = 0; item_id < items.size(); ++item_id) {
+                TryGather(
+                    gatherer, gatherer_id, items[item_id], item_id, result
+                );
             }
+            continue;
+        }
+
+        candidates.clear();
+        grid->ForEachItem(left_bottom, right_top, [&](size_t item_id) {
+            candidates.push_back(item_id);
+        });
+
+        // Сохраняем порядок событий полного перебора, чтобы сортировка по
+        // времени давала тот же результат
+        std::sort(candidates.begin(), candidates.end());
+        for (size_t item_id : candidates) {
+            TryGather(gatherer, gatherer_id, items[item_id], item_id, result);
         }
     }
 
-    std::sort(
-        result.begin(),
-        result.end(),
-        [](const auto& lhs, const auto& rhs) { return lhs.time < rhs.time; }
-    );
+    SortEventsByTime(result);
     return result;
 }
 
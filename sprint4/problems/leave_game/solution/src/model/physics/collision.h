@@ -58,4 +58,9 @@ struct GatheringEvent {
 std::vector<GatheringEvent>
 FindGatherEvents(const ItemGathererProvider& provider);
 
+// Полный перебор всех пар собирателей и предметов. Результат совпадает с
+// FindGatherEvents, используется для проверки широкой фазы.
+std::vector<GatheringEvent>
+FindGatherEventsBruteForce(const ItemGathererProvider& provider);
+
 }  // namespace model::physics
@@ -34,33 +34,33 @@ class Road {
     Road(Point start, Point end, Dimension width = 0.4) noexcept :
         start_(start),
         end_(end),
-        width_(width) {}
+        width_(width),
+        left_bottom_ {
+            std::min(start_.x, end_.x) - width_,
+            std::min(start_.y, end_.y) - width_,
+        },
+        right_top_ {
+            std::max(start_.x, end_.x) + width_,
+            std::max(start_.y, end_.y) + width_,
+        } {}
 
     Point GetLeftBottomCorner() const noexcept {
-        Dimension x = std::min(start_.x, end_.x) - width_;
-        Dimension y = std::min(start_.y, end_.y) - width_;
-
-        return Point {x, y};
+        return left_bottom_;
     }
 
     Point GetRightTopCorner() const noexcept {
-        Dimension x = std::max(start_.x, end_.x) + width_;
-        Dimension y = std::max(start_.y, end_.y) + width_;
-        return Point {x, y};
+        return right_top_;
     }
 
     Point Bound(const Point& point) const noexcept {
-        const Point left_bottom = GetLeftBottomCorner();
-        const Point right_top = GetRightTopCorner();
-
         return Point {
-            std::clamp(point.x, left_bottom.x, right_top.x),
-            std::clamp(point.y, left_bottom.y, right_top.y),
+            std::clamp(point.x, left_bottom_.x, right_top_.x),
+            std::clamp(point.y, left_bottom_.y, right_top_.y),
         };
     }
 
     bool Contains(const Point& point) const noexcept {
-        return GetLeftBottomCorner() <= point && point <= GetRightTopCorner();
+        return left_bottom_ <= point && point <= right_top_;
     }
 
     bool IsHorizontal() const noexcept {
@@ -87,6 +87,8 @@ class Road {
     Point start_;
     Point end_;
     Dimension width_;
+    Point left_bottom_;
+    Point right_top_;
 };
 
 }  // namespace model
@@ -0,0 +1,113 @@
+#include "model/road_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace model {
+
+namespace {
+
+// Минимальная сторона ячейки. Дороги лежат на целочисленных координатах,
+// поэтому более мелкая сетка только раздувает индекс.
+constexpr Dimension min_cell_size = 1.0;
+
+// Желаемое среднее количество ячеек на одну дорогу.
+constexpr double cells_per_road = 4.0;
+
+} // namespace
+
+RoadIndex::RoadIndex(const std::vector<Road>& roads) :
+    roads_count_(roads.size()) {
+    if (roads.empty()) {
+        return;
+    }
+
+    if (roads.size() > std::numeric_limits<RoadId>::max()) {
+        throw std::invalid_argument("Too many roads for road index");
+    }
+
+    Point left_bottom = roads.front().GetLeftBottomCorner();
+    Point right_top = roads.front().GetRightTopCorner();
+    for (const auto& road : roads) {
+        const Point road_left_bottom = road.GetLeftBottomCorner();
+        const Point road_right_top = road.GetRightTopCorner();
+        left_bottom.x = std::min(left_bottom.x, road_left_bottom.x);
+        left_bottom.y = std::min(left_bottom.y, road_left_bottom.y);
+        right_top.x = std::max(right_top.x, road_right_top.x);
+        right_top.y = std::max(right_top.y, road_right_top.y);
+    }
+
+    const Dimension width = right_top.x - left_bottom.x;
+    const Dimension height = right_top.y - left_bottom.y;
+
+    origin_ = left_bottom;
+    cell_size_ = std::max(
+        min_cell_size,
+        std::sqrt(width * height / (cells_per_road * roads.size()))
+    );
+    columns_ = ToColumn(right_top.x) + 1;
+    rows_ = ToRow(right_top.y) + 1;
+
+    const auto for_each_cell = [&](const Road& road, auto&& fn) {
+        const Point road_left_bottom = road.GetLeftBottomCorner();
+        const Point road_right_top = road.GetRightTopCorner();
+        const int64_t last_column = ToColumn(road_right_top.x);
+        const int64_t last_row = ToRow(road_right_top.y);
+
+        for (int64_t row = ToRow(road_left_bottom.y); row <= last_row; ++row) {
+            for (int64_t column = ToColumn(road_left_bottom.x);
+                 column <= last_column; ++column) {
+                fn(static_cast<size_t>(row * columns_ + column));
+            }
+        }
+    };
+
+    // Раскладываем дороги по ячейкам в два прохода: сначала считаем размер
+    // каждой ячейки, затем заполняем плоский массив номеров.
+    cell_offsets_.assign(static_cast<size_t>(columns_ * rows_) + 1, 0);
+    for (const auto& road : roads) {
+        for_each_cell(road, [&](size_t cell) {
+            ++cell_offsets_[cell + 1];
+        });
+    }
+
+    for (size_t i = 1; i < cell_offsets_.size(); ++i) {
+        cell_offsets_[i] += cell_offsets_[i - 1];
+    }
+
+    road_ids_.resize(cell_offsets_.back());
+    std::vector<uint32_t> cell_fill(
+        cell_offsets_.begin(), std::prev(cell_offsets_.end())
+    );
+    for (size_t road_id = 0; road_id < roads.size(); ++road_id) {
+        for_each_cell(roads[road_id], [&](size_t cell) {
+            road_ids_[cell_fill[cell]++] = static_cast<RoadId>(road_id);
+        });
+    }
+}
+
+std::optional<size_t> RoadIndex::FindCell(const Point& point) const noexcept {
+    if (cell_offsets_.empty()) {
+        return std::nullopt;
+    }
+
+    const int64_t column = ToColumn(point.x);
+    const int64_t row = ToRow(point.y);
+    if (column < 0 || column >= columns_ || row < 0 || row >= rows_) {
+        return std::nullopt;
+    }
+
+    return static_cast<size_t>(row * columns_ + column);
+}
+
+int64_t RoadIndex::ToColumn(Coord x) const noexcept {
+    return static_cast<int64_t>(std::floor((x - origin_.x) / cell_size_));
+}
+
+int64_t RoadIndex::ToRow(Coord y) const noexcept {
+    return static_cast<int64_t>(std::floor((y - origin_.y) / cell_size_));
+}
+
+}  // namespace model
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "model/road.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace model {
+
+/*
+ *  Равномерная сетка над прямоугольниками дорог.
+ *  Каждая ячейка хранит номера дорог, чьи границы её пересекают, поэтому
+ *  поиск дорог, содержащих точку, сводится к просмотру одной ячейки.
+ *  Номера дорог внутри ячейки упорядочены по возрастанию.
+ */
+class RoadIndex {
+  public:
+    using RoadId = uint32_t;
+
+    RoadIndex() = default;
+
+    explicit RoadIndex(const std::vector<Road>& roads);
+
+    size_t RoadsCount() const noexcept {
+        return roads_count_;
+    }
+
+    // Вызывает fn(road_id) для каждой дороги, в ячейку которой попадает точка.
+    // Проверять принадлежность точки дороге должен вызывающий код.
+    template <typename Fn>
+    void ForEachCandidate(const Point& point, Fn&& fn) const {
+        const auto cell = FindCell(point);
+        if (!cell) {
+            return;
+        }
+
+        const RoadId* first = road_ids_.data() + cell_offsets_[*cell];
+        const RoadId* last = road_ids_.data() + cell_offsets_[*cell + 1];
+        for (; first != last; ++first) {
+            fn(*first);
+        }
+    }
+
+  private:
+    std::optional<size_t> FindCell(const Point& point) const noexcept;
+
+    int64_t ToColumn(Coord x) const noexcept;
+
+    int64_t ToRow(Coord y) const noexcept;
+
+    size_t roads_count_ = 0;
+    Point origin_ {0, 0};
+    Dimension cell_size_ = 1;
+    int64_t columns_ = 0;
+    int64_t rows_ = 0;
+    std::vector<uint32_t> cell_offsets_;
+    std::vector<RoadId> road_ids_;
+};
+
+}  // namespace model
@@ -6,5 +6,8 @@ namespace postgres {
 
 const std::string db_url = "GAME_DB_URL";
 constexpr size_t player_records_limit = 100;
+// С этого размера пакета рекорды записываются через COPY, а не одним
+// INSERT с массивами
+constexpr size_t player_records_copy_threshold = 1000;
 
 } // namespace postgres
@@ -3,6 +3,10 @@
 
 #include <fmt/core.h>
 #include <pqxx/result>
+#include <pqxx/stream_to>
+
+#include <cstdint>
+#include <string>
 
 namespace postgres {
 
@@ -19,9 +23,54 @@ void PlayerRecordRepositoryImpl::Save(const app::PlayerRecord& record) {
 void PlayerRecordRepositoryImpl::SaveAll(
     const std::vector<app::PlayerRecord>& records
 ) {
-    for (const auto& r : records) {
-        Save(r);
+    if (records.empty()) {
+        return;
+    }
+    if (records.size() == 1) {
+        Save(records.front());
+    } else if (records.size() < player_records_copy_threshold) {
+        InsertRows(records);
+    } else {
+        CopyRows(records);
+    }
+}
+
+void PlayerRecordRepositoryImpl::InsertRows(
+    const std::vector<app::PlayerRecord>& records
+) {
+    std::vector<std::string> names;
+    std::vector<size_t> scores;
+    std::vector<int64_t> play_times;
+    names.reserve(records.size());
+    scores.reserve(records.size());
+    play_times.reserve(records.size());
+    for (const auto& record : records) {
+        names.push_back(record.GetName());
+        scores.push_back(record.GetScore());
+        play_times.push_back(record.GetPlayTime().count());
+    }
+
+    work_.exec_params(
+        R"(
+            INSERT INTO hall_of_fame (name, score, play_time_ms)
+            SELECT * FROM unnest($1::varchar[], $2::integer[], $3::integer[]);
+        )",
+        names, scores, play_times
+    );
+}
+
+void PlayerRecordRepositoryImpl::CopyRows(
+    const std::vector<app::PlayerRecord>& records
+) {
+    auto stream = pqxx::stream_to::table(
+        work_, {"hall_of_fame"}, {"name", "score", "play_time_ms"}
+    );
+    for (const auto& record : records) {
+        stream.write_values(
+            record.GetName(), record.GetScore(), record.GetPlayTime().count()
+        );
     }
+    stream.complete();
 }
 
 std::vector<app::PlayerRecord>
@@ -4,6 +4,8 @@
 
 #include <pqxx/transaction>
 
+#include <vector>
+
 namespace postgres {
 
 class PlayerRecordRepositoryImpl : public app::PlayerRecordRepository {
@@ -12,8 +14,17 @@ class PlayerRecordRepositoryImpl : public app::PlayerRecordRepository {
 
     void Save(const app::PlayerRecord& record) override;
 
+    // Записывает пакет за один запрос. Способ записи выбирается по
+    // размеру пакета
     void SaveAll(const std::vector<app::PlayerRecord>& records) override;
 
+    // Один INSERT, получающий столбцы массивами
+    void InsertRows(const std::vector<app::PlayerRecord>& records);
+
+    // COPY в таблицу. Для больших пакетов быстрее INSERT, так как сервер не
+    // разбирает массивы параметров
+    void CopyRows(const std::vector<app::PlayerRecord>& records);
+
     std::vector<app::PlayerRecord> GetAll(size_t offset, size_t limit) override;
 
   private:
@@ -4,6 +4,7 @@
 #include "serde/archive/lost_object.h"
 #include "model/game_session.h"
 
+#include <boost/serialization/string.hpp>
 #include <boost/serialization/vector.hpp>
 
 namespace serde::archive {
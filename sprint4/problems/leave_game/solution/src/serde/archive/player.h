@@ -3,6 +3,10 @@
 #include "serde/archive/game_session.h"
 #include "app/player.h"
 
+#include <boost/serialization/string.hpp>
+
+#include <stdexcept>
+
 namespace serde::archive {
 
 class PlayerRepr {
@@ -14,7 +18,7 @@ class PlayerRepr {
         map_id_(*player.GetSession()->GetMap().GetId()),
         name_(player.GetName()),
         dog_(*player.GetDog()),
-        token_(*token) {}
+        token_(token.ToString()) {}
 
     [[nodiscard]] app::Player Restore() const {
         return app::Player(app::Player::Id(id_), name_);
@@ -29,7 +33,11 @@ class PlayerRepr {
     }
 
     [[nodiscard]] app::Token RestoreToken() const {
-        return app::Token(token_);
+        auto token = app::Token::Parse(token_);
+        if (!token) {
+            throw std::invalid_argument("Invalid token " + token_);
+        }
+        return *token;
     }
 
     template <typename Archive>
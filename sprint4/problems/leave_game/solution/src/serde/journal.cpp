@@ -0,0 +1,289 @@
+#include "serde/journal.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <system_error>
+
+namespace serde::journal {
+
+namespace fs = std::filesystem;
+
+using snapshot::Decoder;
+using snapshot::Encoder;
+using snapshot::SnapshotError;
+
+namespace {
+
+constexpr std::string_view segment_suffix = ".journal.";
+
+void EncodeToken(Encoder& encoder, const app::Token& token) {
+    encoder.PutFixed64(token.GetHigh());
+    encoder.PutFixed64(token.GetLow());
+}
+
+app::Token DecodeToken(Decoder& decoder) {
+    const uint64_t high = decoder.GetFixed64();
+    return app::Token(high, decoder.GetFixed64());
+}
+
+model::Direction DecodeDirection(Decoder& decoder) {
+    const uint64_t direction = decoder.GetVarint();
+    if (direction > model::Direction::NONE) {
+        throw SnapshotError("Invalid direction in journal");
+    }
+    return static_cast<model::Direction>(direction);
+}
+
+model::Map::Id DecodeMapId(Decoder& decoder) {
+    return model::Map::Id(std::string(decoder.GetString()));
+}
+
+JoinRecord DecodeJoin(Decoder& decoder) {
+    const app::Token token = DecodeToken(decoder);
+    const app::Player::Id player_id(decoder.GetVarint());
+    std::string name(decoder.GetString());
+    model::Map::Id map_id = DecodeMapId(decoder);
+    return JoinRecord {
+        .token = token,
+        .player_id = player_id,
+        .name = std::move(name),
+        .map_id = std::move(map_id),
+        .dog = snapshot::DecodeDog(decoder),
+    };
+}
+
+MoveRecord DecodeMove(Decoder& decoder) {
+    const app::Token token = DecodeToken(decoder);
+    return MoveRecord {
+        .token = token,
+        .direction = DecodeDirection(decoder),
+    };
+}
+
+SessionTickRecord DecodeSessionTick(Decoder& decoder) {
+    SessionTickRecord record {
+        .map_id = DecodeMapId(decoder),
+        .changed_dogs = {},
+        .removed_dogs = {},
+        .added_lost_objects = {},
+        .removed_lost_objects = {},
+    };
+
+    const uint64_t changed_count = decoder.GetVarint();
+    for (uint64_t i = 0; i < changed_count; ++i) {
+        const model::Dog::Id id(decoder.GetVarint());
+        record.changed_dogs.push_back(snapshot::DecodeDog(decoder));
+        record.changed_dogs.back().SetId(id);
+    }
+
+    const uint64_t removed_count = decoder.GetVarint();
+    for (uint64_t i = 0; i < removed_count; ++i) {
+        record.removed_dogs.emplace_back(decoder.GetVarint());
+    }
+
+    const uint64_t added_objects_count = decoder.GetVarint();
+    for (uint64_t i = 0; i < added_objects_count; ++i) {
+        record.added_lost_objects.push_back(
+            snapshot::DecodeLostObject(decoder)
+        );
+    }
+
+    const uint64_t removed_objects_count = decoder.GetVarint();
+    for (uint64_t i = 0; i < removed_objects_count; ++i) {
+        record.removed_lost_objects.emplace_back(decoder.GetVarint());
+    }
+    return record;
+}
+
+Record DecodeRecordData(Decoder& decoder) {
+    switch (static_cast<RecordKind>(decoder.GetBytes(1)[0])) {
+        case RecordKind::join:
+            return DecodeJoin(decoder);
+        case RecordKind::move:
+            return DecodeMove(decoder);
+        case RecordKind::session_tick:
+            return DecodeSessionTick(decoder);
+    }
+    throw SnapshotError("Unknown journal record kind");
+}
+
+std::string ReadFile(const fs::path& path) {
+    std::ifstream input(path, std::ios::binary);
+    std::string data;
+    data.resize(fs::file_size(path));
+    input.read(data.data(), static_cast<std::streamsize>(data.size()));
+    data.resize(static_cast<size_t>(input.gcount()));
+    return data;
+}
+
+} // namespace
+
+void EncodeJoin(
+    std::string& out, const app::Token& token, const app::Player& player
+) {
+    Encoder encoder(out);
+    out.push_back(static_cast<char>(RecordKind::join));
+    EncodeToken(encoder, token);
+    encoder.PutVarint(*player.GetId());
+    encoder.PutString(player.GetName());
+    encoder.PutString(*player.GetSession()->GetMap().GetId());
+    snapshot::EncodeDog(encoder, *player.GetDog());
+}
+
+void EncodeMove(
+    std::string& out, const app::Token& token, model::Direction direction
+) {
+    Encoder encoder(out);
+    out.push_back(static_cast<char>(RecordKind::move));
+    EncodeToken(encoder, token);
+    encoder.PutVarint(direction);
+}
+
+void EncodeSessionTick(
+    std::string& out, const model::GameSession& session,
+    const model::GameSession::Changes& changes
+) {
+    Encoder encoder(out);
+    out.push_back(static_cast<char>(RecordKind::session_tick));
+    encoder.PutString(*session.GetMap().GetId());
+
+    encoder.PutVarint(changes.changed_dogs.size());
+    for (const auto& dog : changes.changed_dogs) {
+        encoder.PutVarint(*dog->GetId());
+        snapshot::EncodeDog(encoder, *dog);
+    }
+
+    encoder.PutVarint(changes.removed_dogs.size());
+    for (const auto& id : changes.removed_dogs) {
+        encoder.PutVarint(*id);
+    }
+
+    encoder.PutVarint(changes.added_lost_objects.size());
+    for (const auto& object : changes.added_lost_objects) {
+        snapshot::EncodeLostObject(encoder, object);
+    }
+
+    encoder.PutVarint(changes.removed_lost_objects.size());
+    for (const auto& id : changes.removed_lost_objects) {
+        encoder.PutVarint(*id);
+    }
+}
+
+Record DecodeRecord(std::string_view data) {
+    Decoder decoder(data);
+    Record record = DecodeRecordData(decoder);
+    if (!decoder.IsEmpty()) {
+        throw SnapshotError("Unexpected data at the end of journal record");
+    }
+    return record;
+}
+
+void AppendFrame(std::string& out, std::string_view data) {
+    Encoder encoder(out);
+    encoder.PutFixed32(static_cast<uint32_t>(data.size()));
+    encoder.PutFixed32(snapshot::Crc32(data));
+    out.append(data);
+}
+
+std::string MakeSegmentHeader(uint64_t start) {
+    std::string header(signature);
+    Encoder encoder(header);
+    encoder.PutFixed32(format_version);
+    encoder.PutFixed64(start);
+    return header;
+}
+
+fs::path GetSegmentPath(const fs::path& state_file, uint64_t start) {
+    fs::path path = state_file;
+    path += segment_suffix;
+    path += std::to_string(start);
+    return path;
+}
+
+std::vector<Segment> ListSegments(const fs::path& state_file) {
+    const fs::path directory = state_file.parent_path().empty()
+        ? fs::path(".")
+        : state_file.parent_path();
+    const std::string prefix =
+        state_file.filename().string() + std::string(segment_suffix);
+
+    std::vector<Segment> segments;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (!name.starts_with(prefix)) {
+            continue;
+        }
+
+        uint64_t start = 0;
+        const char* first = name.data() + prefix.size();
+        const char* last = name.data() + name.size();
+        if (const auto [end, error] = std::from_chars(first, last, start);
+            error == std::errc() && end == last && first != last) {
+            segments.push_back(Segment {start, entry.path()});
+        }
+    }
+
+    std::sort(
+        segments.begin(), segments.end(),
+        [](const Segment& a, const Segment& b) {
+            return a.start < b.start;
+        }
+    );
+    return segments;
+}
+
+uint64_t ReadJournal(
+    const fs::path& state_file, uint64_t position, const RecordHandler& handle
+) {
+    const auto segments = ListSegments(state_file);
+
+    uint64_t expected = position + 1;
+
+    for (size_t i = 0; i < segments.size(); ++i) {
+        // Все записи сегмента уже учтены в снимке
+        if (i + 1 < segments.size() && segments[i + 1].start <= expected) {
+            continue;
+        }
+
+        const std::string data = ReadFile(segments[i].path);
+        Decoder decoder(data);
+        if (data.size() < segment_header_size ||
+            decoder.GetBytes(signature.size()) != signature ||
+            decoder.GetFixed32() != format_version ||
+            decoder.GetFixed64() != segments[i].start) {
+            // Сегмент создан, но его заголовок не дописан
+            continue;
+        }
+
+        uint64_t number = segments[i].start;
+        std::string_view frames =
+            std::string_view(data).substr(segment_header_size);
+        while (frames.size() >= frame_header_size) {
+            Decoder frame(frames);
+            const uint32_t size = frame.GetFixed32();
+            const uint32_t crc = frame.GetFixed32();
+            if (frames.size() - frame_header_size < size) {
+                break;
+            }
+            const std::string_view record = frame.GetBytes(size);
+            if (snapshot::Crc32(record) != crc) {
+                break;
+            }
+            frames.remove_prefix(frame_header_size + size);
+
+            if (number > position) {
+                if (number != expected) {
+                    return expected - 1;
+                }
+                handle(number, record);
+                ++expected;
+            }
+            ++number;
+        }
+    }
+    return expected - 1;
+}
+
+} // namespace serde::journal
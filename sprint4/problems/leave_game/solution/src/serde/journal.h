@@ -0,0 +1,126 @@
+#pragma once
+
+#include "app/player.h"
+#include "app/token.h"
+#include "model/dog.h"
+#include "model/game_session.h"
+#include "model/lost_object.h"
+#include "model/map.h"
+#include "serde/snapshot.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace serde::journal {
+
+/*
+ *  Журнал изменений состояния игры, дописываемый между снимками.
+ *
+ *  Журнал состоит из сегментов - файлов "<файл состояния>.journal.<номер>",
+ *  где номер - номер первой записи сегмента. Записи нумеруются подряд, а
+ *  снимок хранит номер последней учтённой в нём записи, поэтому после
+ *  записи снимка старые сегменты удаляются.
+ *
+ *  Заголовок сегмента: сигнатура "GJNL", версия формата и номер первой
+ *  записи. Запись начинается с размера данных и их CRC32. Данные
+ *  кодируются так же, как секции снимка, и начинаются с вида записи.
+ *
+ *  Случайные точки появления собак и предметов не воспроизводятся
+ *  повторно, поэтому журнал хранит не только действия игроков, но и
+ *  результат каждого тика сессии: состояние изменившихся собак и
+ *  появившиеся и исчезнувшие предметы.
+ */
+
+inline constexpr std::string_view signature = "GJNL";
+inline constexpr uint32_t format_version = 1;
+
+// Сигнатура, версия и номер первой записи
+inline constexpr size_t segment_header_size = 16;
+// Размер и CRC32 данных записи
+inline constexpr size_t frame_header_size = 8;
+
+enum class RecordKind : uint8_t {
+    join = 1,
+    move = 2,
+    session_tick = 3,
+};
+
+// Игрок вошёл в игру. Собака ещё не изменялась игрой
+struct JoinRecord {
+    app::Token token;
+    app::Player::Id player_id;
+    std::string name;
+    model::Map::Id map_id;
+    model::Dog dog;
+};
+
+// Игрок изменил направление движения собаки
+struct MoveRecord {
+    app::Token token;
+    model::Direction direction;
+};
+
+// Результат тика сессии. Идентификаторы собак совпадают с идентификаторами
+// игроков, удалённые собаки отправлены на покой
+struct SessionTickRecord {
+    model::Map::Id map_id;
+    std::vector<model::Dog> changed_dogs;
+    std::vector<model::Dog::Id> removed_dogs;
+    std::vector<model::LostObject> added_lost_objects;
+    std::vector<model::LostObject::Id> removed_lost_objects;
+};
+
+using Record = std::variant<JoinRecord, MoveRecord, SessionTickRecord>;
+
+// Дописывают в out данные записи. Собака и сессия читаются, поэтому
+// EncodeSessionTick должна вызываться на strand сессии
+void EncodeJoin(
+    std::string& out, const app::Token& token, const app::Player& player
+);
+void EncodeMove(
+    std::string& out, const app::Token& token, model::Direction direction
+);
+void EncodeSessionTick(
+    std::string& out, const model::GameSession& session,
+    const model::GameSession::Changes& changes
+);
+
+// Бросает snapshot::SnapshotError, если данные повреждены
+Record DecodeRecord(std::string_view data);
+
+// Дописывает в out запись с данными data
+void AppendFrame(std::string& out, std::string_view data);
+
+// Заголовок сегмента, первая запись которого имеет номер start
+std::string MakeSegmentHeader(uint64_t start);
+
+struct Segment {
+    uint64_t start = 0;
+    std::filesystem::path path;
+};
+
+std::filesystem::path
+GetSegmentPath(const std::filesystem::path& state_file, uint64_t start);
+
+// Сегменты журнала файла состояния в порядке номеров
+std::vector<Segment> ListSegments(const std::filesystem::path& state_file);
+
+using RecordHandler = std::function<void(uint64_t number, std::string_view)>;
+
+// Передаёт handle записи журнала с номерами больше position по порядку.
+// Чтение останавливается на первой недописанной или повреждённой записи
+// и на пропуске в нумерации, так как следующие записи уже нельзя
+// применить. Возвращает номер последней переданной записи или position,
+// если записей не было: с него продолжается нумерация, а записи после
+// него удаляются новым журналом
+uint64_t ReadJournal(
+    const std::filesystem::path& state_file, uint64_t position,
+    const RecordHandler& handle
+);
+
+} // namespace serde::journal
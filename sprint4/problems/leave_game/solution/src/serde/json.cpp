@@ -1,4 +1,5 @@
 #include "serde/json.h"
+#include "serde/json_writer.h"
 
 #include "datetime/consts.h"
 #include "model/loot_generator.h"
@@ -91,6 +92,10 @@ constexpr json::string_view lost_objects = "lostObjects";
 constexpr json::string_view type = "type";
 constexpr json::string_view bag = "bag";
 constexpr json::string_view score = "score";
+constexpr json::string_view tick = "tick";
+constexpr json::string_view full = "full";
+constexpr json::string_view removed_players = "removedPlayers";
+constexpr json::string_view removed_lost_objects = "removedLostObjects";
 } // namespace GameState
 
 namespace Tick {
@@ -118,6 +123,16 @@ constexpr json::string_view score = "score";
 constexpr json::string_view play_time = "playTime";
 } // namespace PlayerRecord
 
+namespace Metrics {
+constexpr json::string_view counters = "counters";
+constexpr json::string_view gauges = "gauges";
+constexpr json::string_view durations = "durations";
+constexpr json::string_view count = "count";
+constexpr json::string_view total = "totalMs";
+constexpr json::string_view max = "maxMs";
+constexpr json::string_view last = "lastMs";
+} // namespace Metrics
+
 } // namespace keys
 
 json::value LoadJson(const std::filesystem::path& json_path) {
@@ -414,43 +429,44 @@ json::value SerializeMapInfo(const model::Map& map) {
     };
 }
 
-json::value SerializeMapsList(const model::Game::Maps& maps) {
-    json::array array;
-    array.reserve(maps.size());
+std::string WriteMapsList(const model::Game::Maps& maps) {
+    std::string output;
+    output.reserve(maps.size() * 64);
+    Writer writer(output);
 
+    writer.BeginArray();
     for (const auto& map : maps) {
-        array.push_back(json::value{
-            {keys::MapsList::id, *map.GetId()},
-            {keys::MapsList::name, map.GetName()},
-        });
+        writer.BeginObject();
+        writer.Key(keys::MapsList::id);
+        writer.String(*map.GetId());
+        writer.Key(keys::MapsList::name);
+        writer.String(map.GetName());
+        writer.EndObject();
     }
+    writer.EndArray();
 
-    return array;
+    return output;
 }
 
-json::value SerializePlayers(const app::Application::Players& players) {
-    json::object object;
-    object.reserve(players.size());
+std::string WritePlayers(const app::Application::Players& players) {
+    std::string output;
+    output.reserve(players.size() * 48);
+    Writer writer(output);
 
-    for (size_t i = 0; i < players.size(); ++i) {
-        const auto& player = players[i];
-        object[std::to_string(*player->GetId())] = json::object{
-            {keys::Player::name, player->GetName()},
-        };
+    writer.BeginObject();
+    for (const auto& player : players) {
+        writer.Key(*player->GetId());
+        writer.BeginObject();
+        writer.Key(keys::Player::name);
+        writer.String(player->GetName());
+        writer.EndObject();
     }
+    writer.EndObject();
 
-    return object;
+    return output;
 }
 
-json::value SerializePosition(const model::Point& position) {
-    return json::array{position.x, position.y};
-}
-
-json::value SerializeSpeed(const model::Speed& speed) {
-    return json::array{speed.x, speed.y};
-}
-
-json::value SerializeDirection(model::Direction direction) {
+json::string_view GetDirectionName(model::Direction direction) {
     switch (direction) {
     case model::Direction::WEST:
         return keys::Direction::west;
@@ -467,81 +483,214 @@ json::value SerializeDirection(model::Direction direction) {
     }
 }
 
-json::value SerializeBag(const LostObjectsBag& bag) {
-    json::array array;
-    array.reserve(bag.Capacity());
+void WritePair(Writer& writer, double x, double y) {
+    writer.BeginArray();
+    writer.Number(x);
+    writer.Number(y);
+    writer.EndArray();
+}
 
+void WriteBag(Writer& writer, const LostObjectsBag& bag) {
+    writer.BeginArray();
     for (const auto& obj : bag) {
-        array.push_back(json::object{
-            {keys::Bag::id, *obj.GetId()},
-            {keys::Bag::type, obj.GetType()},
-        });
+        writer.BeginObject();
+        writer.Key(keys::Bag::id);
+        writer.Number(*obj.GetId());
+        writer.Key(keys::Bag::type);
+        writer.Number(obj.GetType());
+        writer.EndObject();
     }
+    writer.EndArray();
+}
 
-    return array;
+void WriteGameStateDog(Writer& writer, const model::Dog& dog) {
+    const model::Point position = dog.GetPosition();
+    const model::Speed speed = dog.GetSpeed();
+
+    writer.BeginObject();
+    writer.Key(keys::GameState::position);
+    WritePair(writer, position.x, position.y);
+    writer.Key(keys::GameState::speed);
+    WritePair(writer, speed.x, speed.y);
+    writer.Key(keys::GameState::direction);
+    writer.String(GetDirectionName(dog.GetDirection()));
+    writer.Key(keys::GameState::bag);
+    WriteBag(writer, dog.GetBag());
+    writer.Key(keys::GameState::score);
+    writer.Number(dog.GetScore());
+    writer.EndObject();
 }
 
-json::value SerializeGameStatePlayers(const app::Application::Players& players
+void WriteGameStatePlayers(
+    Writer& writer, const app::Application::Players& players
 ) {
-    json::object object;
-
+    writer.BeginObject();
     for (const auto& player : players) {
-        const auto& dog = player->GetDog();
-
-        object[std::to_string(*player->GetId())] = json::object{
-            {keys::GameState::position, SerializePosition(dog->GetPosition())},
-            {keys::GameState::speed, SerializeSpeed(dog->GetSpeed())},
-            {keys::GameState::direction,
-             SerializeDirection(dog->GetDirection())},
-            {keys::GameState::bag, SerializeBag(dog->GetBag())},
-            {keys::GameState::score, dog->GetScore()},
-        };
+        writer.Key(*player->GetId());
+        WriteGameStateDog(writer, *player->GetDog());
     }
-
-    return object;
+    writer.EndObject();
 }
 
-json::value
-SerializeGameStateLostObjects(const GameSession::LostObjects& lost_objects) {
-    json::object object;
+// Идентификатор собаки совпадает с идентификатором её игрока
+void WriteGameStateDogs(Writer& writer, const GameSession::Dogs& dogs) {
+    writer.BeginObject();
+    for (const auto& dog : dogs) {
+        writer.Key(*dog->GetId());
+        WriteGameStateDog(writer, *dog);
+    }
+    writer.EndObject();
+}
 
+void WriteGameStateLostObjects(
+    Writer& writer, const GameSession::LostObjects& lost_objects
+) {
+    writer.BeginObject();
     for (const auto& lost_object : lost_objects) {
-        object[std::to_string(*lost_object.GetId())] = json::object{
-            {keys::GameState::type, lost_object.GetType()},
-            {keys::GameState::position,
-             SerializePosition(lost_object.GetPosition())},
-        };
+        const model::Point position = lost_object.GetPosition();
+
+        writer.Key(*lost_object.GetId());
+        writer.BeginObject();
+        writer.Key(keys::GameState::type);
+        writer.Number(lost_object.GetType());
+        writer.Key(keys::GameState::position);
+        WritePair(writer, position.x, position.y);
+        writer.EndObject();
     }
+    writer.EndObject();
+}
 
-    return object;
+template <typename Ids>
+void WriteIds(Writer& writer, const Ids& ids) {
+    writer.BeginArray();
+    for (const auto& id : ids) {
+        writer.Number(*id);
+    }
+    writer.EndArray();
 }
 
-json::value SerializeGameState(
+// Примерный размер состояния, чтобы строка не перевыделялась при записи
+size_t EstimateGameStateSize(size_t dogs_count, size_t lost_objects_count) {
+    return 64 + dogs_count * 160 + lost_objects_count * 64;
+}
+
+std::string WriteGameState(
     const app::Application::Players& players,
     const GameSession::LostObjects& lost_objects
 ) {
-    return json::object{
-        {keys::GameState::players, SerializeGameStatePlayers(players)},
-        {keys::GameState::lost_objects,
-         SerializeGameStateLostObjects(lost_objects)},
-    };
+    std::string output;
+    output.reserve(EstimateGameStateSize(players.size(), lost_objects.size()));
+    Writer writer(output);
+
+    writer.BeginObject();
+    writer.Key(keys::GameState::players);
+    WriteGameStatePlayers(writer, players);
+    writer.Key(keys::GameState::lost_objects);
+    WriteGameStateLostObjects(writer, lost_objects);
+    writer.EndObject();
+
+    return output;
 }
 
-json::value SerializePlayerRecords(const std::vector<app::PlayerRecord>& records
+std::string WriteGameStateSnapshot(
+    GameSession::Tick tick,
+    const app::Application::Players& players,
+    const GameSession::LostObjects& lost_objects
 ) {
-    json::array array;
-    array.reserve(records.size());
+    std::string output;
+    output.reserve(EstimateGameStateSize(players.size(), lost_objects.size()));
+    Writer writer(output);
+
+    writer.BeginObject();
+    writer.Key(keys::GameState::tick);
+    writer.Number(tick);
+    writer.Key(keys::GameState::full);
+    writer.Bool(true);
+    writer.Key(keys::GameState::players);
+    WriteGameStatePlayers(writer, players);
+    writer.Key(keys::GameState::lost_objects);
+    WriteGameStateLostObjects(writer, lost_objects);
+    writer.EndObject();
+
+    return output;
+}
 
+std::string WriteGameStateChanges(const GameSession::Changes& changes) {
+    std::string output;
+    output.reserve(EstimateGameStateSize(
+        changes.changed_dogs.size(), changes.added_lost_objects.size()
+    ));
+    Writer writer(output);
+
+    writer.BeginObject();
+    writer.Key(keys::GameState::tick);
+    writer.Number(changes.tick);
+    writer.Key(keys::GameState::full);
+    writer.Bool(false);
+    writer.Key(keys::GameState::players);
+    WriteGameStateDogs(writer, changes.changed_dogs);
+    writer.Key(keys::GameState::lost_objects);
+    WriteGameStateLostObjects(writer, changes.added_lost_objects);
+    writer.Key(keys::GameState::removed_players);
+    WriteIds(writer, changes.removed_dogs);
+    writer.Key(keys::GameState::removed_lost_objects);
+    WriteIds(writer, changes.removed_lost_objects);
+    writer.EndObject();
+
+    return output;
+}
+
+std::string WritePlayerRecords(const std::vector<app::PlayerRecord>& records) {
+    std::string output;
+    output.reserve(records.size() * 64);
+    Writer writer(output);
+
+    writer.BeginArray();
     for (const auto& record : records) {
-        array.push_back(json::object{
-            {keys::PlayerRecord::name, record.GetName()},
-            {keys::PlayerRecord::score, record.GetScore()},
-            {keys::PlayerRecord::play_time,
-             record.GetPlayTime().count() / datetime::milliseconds_in_second},
-        });
+        writer.BeginObject();
+        writer.Key(keys::PlayerRecord::name);
+        writer.String(record.GetName());
+        writer.Key(keys::PlayerRecord::score);
+        writer.Number(record.GetScore());
+        writer.Key(keys::PlayerRecord::play_time);
+        writer.Number(
+            record.GetPlayTime().count() / datetime::milliseconds_in_second
+        );
+        writer.EndObject();
     }
+    writer.EndArray();
 
-    return array;
+    return output;
+}
+
+json::value SerializeMetrics(const metrics::Registry::Snapshot& snapshot) {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    json::object counters;
+    for (const auto& [name, value] : snapshot.counters) {
+        counters[name] = value;
+    }
+
+    json::object gauges;
+    for (const auto& [name, value] : snapshot.gauges) {
+        gauges[name] = value;
+    }
+
+    json::object durations;
+    for (const auto& [name, stat] : snapshot.durations) {
+        durations[name] = json::object{
+            {keys::Metrics::count, stat.count},
+            {keys::Metrics::total, Milliseconds(stat.total).count()},
+            {keys::Metrics::max, Milliseconds(stat.max).count()},
+            {keys::Metrics::last, Milliseconds(stat.last).count()},
+        };
+    }
+
+    return json::object{
+        {keys::Metrics::counters, std::move(counters)},
+        {keys::Metrics::gauges, std::move(gauges)},
+        {keys::Metrics::durations, std::move(durations)},
+    };
 }
 
 } // namespace serde::json
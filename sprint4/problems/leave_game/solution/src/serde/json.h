@@ -4,11 +4,14 @@
 #include "model/map.h"
 #include "model/game.h"
 #include "model/game_session.h"
+#include "metrics/metrics.h"
 
 #include <boost/json/value.hpp>
 
 #include <filesystem>
 #include <chrono>
+#include <string>
+#include <vector>
 
 namespace serde::json {
 
@@ -24,16 +27,30 @@ app::JoinGameData ParseJoinGameData(const json::object& object);
 
 json::value SerializeMapInfo(const model::Map& map);
 
-json::value SerializeMapsList(const model::Game::Maps& maps);
+// Ответы, которые запрашиваются чаще всего, записываются сразу в строку
+// без построения json::value
 
-json::value SerializePlayers(const app::Application::Players& players);
+std::string WriteMapsList(const model::Game::Maps& maps);
 
-json::value SerializeGameState(
+std::string WritePlayers(const app::Application::Players& players);
+
+std::string WriteGameState(
     const app::Application::Players& players,
     const model::GameSession::LostObjects& lost_objects
 );
 
-json::value SerializePlayerRecords(const std::vector<app::PlayerRecord>& records
+// Полное состояние с номером тика, после которого клиент может
+// запрашивать изменения
+std::string WriteGameStateSnapshot(
+    model::GameSession::Tick tick,
+    const app::Application::Players& players,
+    const model::GameSession::LostObjects& lost_objects
 );
 
+std::string WriteGameStateChanges(const model::GameSession::Changes& changes);
+
+std::string WritePlayerRecords(const std::vector<app::PlayerRecord>& records);
+
+json::value SerializeMetrics(const metrics::Registry::Snapshot& snapshot);
+
 } // namespace serde::json
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace serde::json {
+
+template <typename T>
+concept StringLike = requires(const T& text) {
+    { text.data() } -> std::convertible_to<const char*>;
+    { text.size() } -> std::convertible_to<size_t>;
+};
+
+/*
+ *  Потоковая запись JSON прямо в строку ответа, без промежуточного
+ *  json::value. Запятые между элементами расставляются автоматически,
+ *  правильность вложенности остаётся на вызывающем.
+ *
+ *  Ключи записываются как есть, без экранирования: это константы из
+ *  таблиц ключей. Строковые значения экранируются.
+ */
+class Writer {
+  public:
+    explicit Writer(std::string& output) : output_(output) {}
+
+    void BeginObject() {
+        BeginValue();
+        output_.push_back('{');
+        need_comma_ = false;
+    }
+
+    void EndObject() {
+        output_.push_back('}');
+        need_comma_ = true;
+    }
+
+    void BeginArray() {
+        BeginValue();
+        output_.push_back('[');
+        need_comma_ = false;
+    }
+
+    void EndArray() {
+        output_.push_back(']');
+        need_comma_ = true;
+    }
+
+    template <StringLike Text>
+    void Key(const Text& key) {
+        BeginValue();
+        output_.push_back('"');
+        output_.append(key.data(), key.size());
+        output_.append("\":");
+        need_comma_ = false;
+    }
+
+    // Ключ-число, например идентификатор игрока
+    template <std::integral T>
+    void Key(T key) {
+        BeginValue();
+        output_.push_back('"');
+        AppendInteger(key);
+        output_.append("\":");
+        need_comma_ = false;
+    }
+
+    template <StringLike Text>
+    void String(const Text& value) {
+        BeginValue();
+        AppendEscaped(std::string_view(value.data(), value.size()));
+        need_comma_ = true;
+    }
+
+    template <std::integral T>
+    void Number(T value) {
+        BeginValue();
+        AppendInteger(value);
+        need_comma_ = true;
+    }
+
+    // Кратчайшая запись, которая читается обратно в то же число. Целые
+    // значения записываются с дробной частью, чтобы остаться вещественными.
+    // В JSON нет бесконечностей и NaN, они записываются как null
+    void Number(double value) {
+        BeginValue();
+        if (!std::isfinite(value)) {
+            output_.append("null");
+            need_comma_ = true;
+            return;
+        }
+        char buffer[32];
+        const auto [end, ec] =
+            std::to_chars(buffer, buffer + sizeof(buffer), value);
+        const std::string_view text(buffer, end - buffer);
+        output_.append(text);
+        if (text.find_first_of(".eE") == std::string_view::npos) {
+            output_.append(".0");
+        }
+        need_comma_ = true;
+    }
+
+    void Bool(bool value) {
+        BeginValue();
+        output_.append(value ? "true" : "false");
+        need_comma_ = true;
+    }
+
+    void Null() {
+        BeginValue();
+        output_.append("null");
+        need_comma_ = true;
+    }
+
+  private:
+    void BeginValue() {
+        if (need_comma_) {
+            output_.push_back(',');
+        }
+    }
+
+    template <std::integral T>
+    void AppendInteger(T value) {
+        char buffer[std::numeric_limits<T>::digits10 + 3];
+        const auto [end, ec] =
+            std::to_chars(buffer, buffer + sizeof(buffer), value);
+        output_.append(buffer, end);
+    }
+
+    void AppendEscaped(std::string_view value) {
+        static constexpr char hex_digits[] = "0123456789abcdef";
+
+        output_.push_back('"');
+        size_t begin = 0;
+        for (size_t i = 0; i < value.size(); ++i) {
+            const auto c = static_cast<unsigned char>(value[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+
+            output_.append(value.data() + begin, i - begin);
+            begin = i + 1;
+            switch (c) {
+            case '"':
+                output_.append("\\\"");
+                break;
+            case '\\':
+                output_.append("\\\\");
+                break;
+            case '\n':
+                output_.append("\\n");
+                break;
+            case '\r':
+                output_.append("\\r");
+                break;
+            case '\t':
+                output_.append("\\t");
+                break;
+            case '\b':
+                output_.append("\\b");
+                break;
+            case '\f':
+                output_.append("\\f");
+                break;
+            default:
+                output_.append("\\u00");
+                output_.push_back(hex_digits[c >> 4]);
+                output_.push_back(hex_digits[c & 0xf]);
+            }
+        }
+        output_.append(value.data() + begin, value.size() - begin);
+        output_.push_back('"');
+    }
+
+    std::string& output_;
+    bool need_comma_ = false;
+};
+
+} // namespace serde::json
@@ -0,0 +1,371 @@
+#include "serde/snapshot.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <bit>
+#include <cerrno>
+#include <fstream>
+#include <system_error>
+
+namespace serde::snapshot {
+
+namespace ip = boost::interprocess;
+
+namespace {
+
+// Сигнатура, версия и число секций
+constexpr size_t file_header_size = 12;
+
+void EncodePoint(Encoder& encoder, model::Point point) {
+    encoder.PutDouble(point.x);
+    encoder.PutDouble(point.y);
+}
+
+model::Point DecodePoint(Decoder& decoder) {
+    const double x = decoder.GetDouble();
+    return model::Point {x, decoder.GetDouble()};
+}
+
+} // namespace
+
+uint32_t Crc32(std::string_view data) {
+    return static_cast<uint32_t>(crc32(
+        crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(data.data()),
+        static_cast<uInt>(data.size())
+    ));
+}
+
+void SyncPath(const std::filesystem::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "open");
+    }
+    const int result = ::fsync(fd);
+    const int error = errno;
+    ::close(fd);
+    if (result != 0) {
+        throw std::system_error(error, std::generic_category(), "fsync");
+    }
+}
+
+void EncodeLostObject(Encoder& encoder, const model::LostObject& object) {
+    encoder.PutVarint(*object.GetId());
+    EncodePoint(encoder, object.GetPosition());
+    encoder.PutVarint(object.GetType());
+    encoder.PutVarint(object.GetValue());
+    encoder.PutDouble(object.GetWidth());
+    encoder.PutBool(object.IsPickedUp());
+}
+
+model::LostObject DecodeLostObject(Decoder& decoder) {
+    const model::LostObject::Id id(decoder.GetVarint());
+    const model::Point position = DecodePoint(decoder);
+    const size_t type = decoder.GetVarint();
+    const size_t value = decoder.GetVarint();
+    const double width = decoder.GetDouble();
+
+    model::LostObject object(id, position, type, value, width);
+    if (decoder.GetBool()) {
+        object.SetPickedUp();
+    }
+    return object;
+}
+
+void EncodeDog(Encoder& encoder, const model::Dog& dog) {
+    EncodePoint(encoder, dog.GetPosition());
+    EncodePoint(encoder, dog.GetPrevPosition());
+    const model::Speed speed = dog.GetSpeed();
+    encoder.PutDouble(speed.x);
+    encoder.PutDouble(speed.y);
+    encoder.PutVarint(dog.GetDirection());
+
+    const auto& bag = dog.GetBag();
+    encoder.PutVarint(bag.Capacity());
+    encoder.PutVarint(bag.Size());
+    for (const auto& object : bag) {
+        EncodeLostObject(encoder, object);
+    }
+
+    encoder.PutDouble(dog.GetWidth());
+    encoder.PutVarint(dog.GetScore());
+}
+
+model::Dog DecodeDog(Decoder& decoder) {
+    const model::Point position = DecodePoint(decoder);
+    const model::Point prev_position = DecodePoint(decoder);
+    const double speed_x = decoder.GetDouble();
+    const model::Speed speed(speed_x, decoder.GetDouble());
+
+    const uint64_t direction = decoder.GetVarint();
+    if (direction > model::Direction::NONE) {
+        throw SnapshotError("Invalid dog direction in snapshot");
+    }
+
+    model::LostObjectsBag bag(decoder.GetVarint());
+    const uint64_t bag_size = decoder.GetVarint();
+    for (uint64_t i = 0; i < bag_size; ++i) {
+        if (!bag.Add(DecodeLostObject(decoder))) {
+            throw SnapshotError("Dog bag overflow in snapshot");
+        }
+    }
+
+    const double width = decoder.GetDouble();
+    return model::Dog(
+        position, prev_position, speed,
+        static_cast<model::Direction>(direction), std::move(bag), width,
+        decoder.GetVarint()
+    );
+}
+
+void Encoder::PutFixed32(uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out_.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+void Encoder::PutFixed64(uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out_.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+void Encoder::PutVarint(uint64_t value) {
+    while (value >= 0x80) {
+        out_.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out_.push_back(static_cast<char>(value));
+}
+
+void Encoder::PutDouble(double value) {
+    PutFixed64(std::bit_cast<uint64_t>(value));
+}
+
+void Encoder::PutBool(bool value) {
+    out_.push_back(value ? 1 : 0);
+}
+
+void Encoder::PutString(std::string_view value) {
+    PutVarint(value.size());
+    out_.append(value);
+}
+
+std::string_view Decoder::GetBytes(size_t size) {
+    if (data_.size() < size) {
+        throw SnapshotError("Snapshot data is truncated");
+    }
+    const std::string_view result = data_.substr(0, size);
+    data_.remove_prefix(size);
+    return result;
+}
+
+uint32_t Decoder::GetFixed32() {
+    const std::string_view bytes = GetBytes(4);
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) {
+        value = value << 8 | static_cast<unsigned char>(bytes[i]);
+    }
+    return value;
+}
+
+uint64_t Decoder::GetFixed64() {
+    const std::string_view bytes = GetBytes(8);
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = value << 8 | static_cast<unsigned char>(bytes[i]);
+    }
+    return value;
+}
+
+uint64_t Decoder::GetVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const auto byte = static_cast<unsigned char>(GetBytes(1).front());
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw SnapshotError("Invalid integer in snapshot");
+}
+
+double Decoder::GetDouble() {
+    return std::bit_cast<double>(GetFixed64());
+}
+
+bool Decoder::GetBool() {
+    return GetBytes(1).front() != 0;
+}
+
+std::string_view Decoder::GetString() {
+    return GetBytes(GetVarint());
+}
+
+void EncodeSession(
+    std::string& out, const model::GameSession& session,
+    const SessionPlayers& players
+) {
+    Encoder encoder(out);
+    encoder.PutString(*session.GetMap().GetId());
+
+    const auto& lost_objects = session.GetLostObjects();
+    encoder.PutVarint(lost_objects.size());
+    for (const auto& object : lost_objects) {
+        EncodeLostObject(encoder, object);
+    }
+
+    encoder.PutVarint(players.size());
+    for (const auto& [token, player] : players) {
+        encoder.PutVarint(*player->GetId());
+        encoder.PutString(player->GetName());
+        encoder.PutFixed64(token.GetHigh());
+        encoder.PutFixed64(token.GetLow());
+        EncodeDog(encoder, *player->GetDog());
+    }
+}
+
+SessionState DecodeSession(std::string_view data) {
+    Decoder decoder(data);
+    SessionState state {
+        .map_id = model::Map::Id(std::string(decoder.GetString())),
+        .lost_objects = {},
+        .players = {},
+    };
+
+    const uint64_t lost_objects_count = decoder.GetVarint();
+    for (uint64_t i = 0; i < lost_objects_count; ++i) {
+        state.lost_objects.push_back(DecodeLostObject(decoder));
+    }
+
+    const uint64_t players_count = decoder.GetVarint();
+    for (uint64_t i = 0; i < players_count; ++i) {
+        const app::Player::Id id(decoder.GetVarint());
+        std::string name(decoder.GetString());
+        const uint64_t token_high = decoder.GetFixed64();
+        const app::Token token(token_high, decoder.GetFixed64());
+        state.players.push_back(PlayerState {
+            .id = id,
+            .name = std::move(name),
+            .token = token,
+            .dog = DecodeDog(decoder),
+        });
+    }
+
+    if (!decoder.IsEmpty()) {
+        throw SnapshotError("Unexpected data at the end of session");
+    }
+    return state;
+}
+
+void WriteSnapshot(
+    const std::filesystem::path& path, const std::vector<std::string>& sessions,
+    uint64_t journal_position
+) {
+    std::string headers;
+    Encoder encoder(headers);
+    headers.append(signature);
+    encoder.PutFixed32(format_version);
+    encoder.PutFixed32(static_cast<uint32_t>(sessions.size() + 1));
+
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        throw std::runtime_error("Cannot open state file");
+    }
+    output.write(headers.data(), static_cast<std::streamsize>(headers.size()));
+
+    const auto write_section = [&](SectionKind kind, std::string_view data) {
+        headers.clear();
+        headers.push_back(static_cast<char>(kind));
+        encoder.PutFixed32(static_cast<uint32_t>(data.size()));
+        encoder.PutFixed32(Crc32(data));
+        output.write(
+            headers.data(), static_cast<std::streamsize>(headers.size())
+        );
+        output.write(data.data(), static_cast<std::streamsize>(data.size()));
+    };
+
+    for (const auto& session : sessions) {
+        write_section(SectionKind::session, session);
+    }
+
+    std::string position;
+    Encoder(position).PutFixed64(journal_position);
+    write_section(SectionKind::journal_position, position);
+
+    output.close();
+    if (!output) {
+        throw std::runtime_error("Cannot write state file");
+    }
+}
+
+void PublishSnapshot(
+    const std::filesystem::path& path, const std::vector<std::string>& sessions,
+    uint64_t journal_position
+) {
+    std::filesystem::path temp_path = path;
+    temp_path += ".tmp";
+
+    WriteSnapshot(temp_path, sessions, journal_position);
+    SyncPath(temp_path);
+    std::filesystem::rename(temp_path, path);
+
+    const auto directory = path.parent_path();
+    SyncPath(directory.empty() ? std::filesystem::path(".") : directory);
+}
+
+std::optional<MappedSnapshot>
+MappedSnapshot::Open(const std::filesystem::path& path) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec || size < file_header_size) {
+        return std::nullopt;
+    }
+
+    ip::file_mapping file(path.c_str(), ip::read_only);
+    ip::mapped_region region(file, ip::read_only);
+    const std::string_view data(
+        static_cast<const char*>(region.get_address()), region.get_size()
+    );
+    if (!data.starts_with(signature)) {
+        return std::nullopt;
+    }
+    return MappedSnapshot(std::move(file), std::move(region));
+}
+
+MappedSnapshot::MappedSnapshot(
+    ip::file_mapping file, ip::mapped_region region
+) :
+    file_(std::move(file)),
+    region_(std::move(region)) {
+    Decoder decoder(std::string_view(
+        static_cast<const char*>(region_.get_address()), region_.get_size()
+    ));
+    decoder.GetBytes(signature.size());
+    if (const uint32_t version = decoder.GetFixed32();
+        version != format_version) {
+        throw SnapshotError(
+            "Unsupported snapshot version " + std::to_string(version)
+        );
+    }
+
+    const uint32_t sections_count = decoder.GetFixed32();
+    for (uint32_t i = 0; i < sections_count; ++i) {
+        const auto kind = static_cast<SectionKind>(decoder.GetBytes(1)[0]);
+        const uint32_t size = decoder.GetFixed32();
+        const uint32_t crc = decoder.GetFixed32();
+        const std::string_view section = decoder.GetBytes(size);
+        if (Crc32(section) != crc) {
+            throw SnapshotError("Snapshot section checksum mismatch");
+        }
+        // Секции неизвестных видов пропускаются
+        if (kind == SectionKind::session) {
+            sessions_.push_back(section);
+        } else if (kind == SectionKind::journal_position) {
+            journal_position_ = Decoder(section).GetFixed64();
+        }
+    }
+}
+
+} // namespace serde::snapshot
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "app/player.h"
+#include "model/dog.h"
+#include "model/game_session.h"
+#include "model/lost_object.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace serde::snapshot {
+
+/*
+ *  Двоичный снимок состояния игры.
+ *
+ *  Заголовок файла: сигнатура "GSNP", версия формата и число секций.
+ *  Секция начинается с вида, размера данных и их CRC32. Поля заголовков
+ *  имеют фиксированную длину и записываются в little-endian.
+ *
+ *  Внутри секций целые числа записываются в LEB128, double - восемью
+ *  байтами, строки - длиной и содержимым. Секция сессии содержит
+ *  идентификатор карты, потерянные предметы и игроков с их собаками.
+ *  Секция позиции журнала хранит номер последней записи журнала, уже
+ *  учтённой в снимке.
+ */
+
+inline constexpr std::string_view signature = "GSNP";
+inline constexpr uint32_t format_version = 1;
+
+enum class SectionKind : uint8_t {
+    session = 1,
+    journal_position = 2,
+};
+
+// Снимок повреждён или записан в неподдерживаемой версии формата
+class SnapshotError : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+// Дописывает значения в конец строки
+class Encoder {
+  public:
+    explicit Encoder(std::string& out) : out_(out) {}
+
+    void PutFixed32(uint32_t value);
+    void PutFixed64(uint64_t value);
+    void PutVarint(uint64_t value);
+    void PutDouble(double value);
+    void PutBool(bool value);
+    void PutString(std::string_view value);
+
+  private:
+    std::string& out_;
+};
+
+// Читает значения, записанные Encoder. Бросает SnapshotError, если данные
+// закончились раньше времени
+class Decoder {
+  public:
+    explicit Decoder(std::string_view data) : data_(data) {}
+
+    uint32_t GetFixed32();
+    uint64_t GetFixed64();
+    uint64_t GetVarint();
+    double GetDouble();
+    bool GetBool();
+    std::string_view GetString();
+    std::string_view GetBytes(size_t size);
+
+    bool IsEmpty() const noexcept {
+        return data_.empty();
+    }
+
+  private:
+    std::string_view data_;
+};
+
+// Контрольная сумма CRC32 секции или записи журнала
+uint32_t Crc32(std::string_view data);
+
+// Сбрасывает на диск содержимое файла или каталога
+void SyncPath(const std::filesystem::path& path);
+
+// Кодирование объектов модели, общее для снимка и журнала
+void EncodeLostObject(Encoder& encoder, const model::LostObject& object);
+model::LostObject DecodeLostObject(Decoder& decoder);
+void EncodeDog(Encoder& encoder, const model::Dog& dog);
+model::Dog DecodeDog(Decoder& decoder);
+
+using SessionPlayers = std::vector<std::pair<app::Token, app::PlayerHolder>>;
+
+// Дописывает в out данные секции сессии. Должна вызываться на strand
+// сессии, так как читает состояние собак
+void EncodeSession(
+    std::string& out, const model::GameSession& session,
+    const SessionPlayers& players
+);
+
+struct PlayerState {
+    app::Player::Id id;
+    std::string name;
+    app::Token token;
+    model::Dog dog;
+};
+
+struct SessionState {
+    model::Map::Id map_id;
+    std::vector<model::LostObject> lost_objects;
+    std::vector<PlayerState> players;
+};
+
+SessionState DecodeSession(std::string_view data);
+
+// Записывает снимок из секций сессий, закодированных EncodeSession.
+// journal_position - номер последней записи журнала, учтённой в сессиях
+void WriteSnapshot(
+    const std::filesystem::path& path, const std::vector<std::string>& sessions,
+    uint64_t journal_position = 0
+);
+
+// Записывает снимок во временный файл рядом с path, сбрасывает его на диск
+// и атомарно заменяет им path
+void PublishSnapshot(
+    const std::filesystem::path& path, const std::vector<std::string>& sessions,
+    uint64_t journal_position = 0
+);
+
+// Файл снимка, отображённый в память. Секции указывают на отображение и
+// действительны, пока жив объект
+class MappedSnapshot {
+  public:
+    // Возвращает nullopt, если файла нет или он не является двоичным
+    // снимком. Бросает SnapshotError, если снимок повреждён
+    static std::optional<MappedSnapshot> Open(const std::filesystem::path& path
+    );
+
+    const std::vector<std::string_view>& GetSessions() const noexcept {
+        return sessions_;
+    }
+
+    // Записи журнала с большими номерами не учтены в снимке
+    uint64_t GetJournalPosition() const noexcept {
+        return journal_position_;
+    }
+
+  private:
+    MappedSnapshot(
+        boost::interprocess::file_mapping file,
+        boost::interprocess::mapped_region region
+    );
+
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+    std::vector<std::string_view> sessions_;
+    uint64_t journal_position_ = 0;
+};
+
+} // namespace serde::snapshot
@@ -0,0 +1,179 @@
+#include "utils/epoch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace utils::epoch {
+
+namespace {
+
+// Состояние потока-читателя. Записи никогда не удаляются: запись
+// завершившегося потока переиспользуется следующим
+struct alignas(64) Record {
+    // Эпоха, в которой поток вошёл в Guard, или 0 вне Guard
+    std::atomic<uint64_t> epoch {0};
+    std::atomic_bool in_use {false};
+    Record* next = nullptr;
+};
+
+struct RetiredObject {
+    void* ptr;
+    void (*deleter)(void*);
+    uint64_t epoch;
+};
+
+// Количество отложенных объектов, после которого Retire вызывает Collect
+constexpr size_t collect_threshold = 64;
+
+std::atomic<uint64_t> global_epoch {1};
+std::atomic<Record*> records {nullptr};
+
+std::mutex retired_mutex;
+std::vector<RetiredObject> retired;
+
+Record* AcquireRecord() {
+    for (Record* record = records.load(std::memory_order_acquire); record;
+         record = record->next) {
+        bool expected = false;
+        if (record->in_use.compare_exchange_strong(expected, true)) {
+            return record;
+        }
+    }
+
+    auto* record = new Record;
+    record->in_use.store(true, std::memory_order_relaxed);
+    Record* head = records.load(std::memory_order_relaxed);
+    do {
+        record->next = head;
+    } while (!records.compare_exchange_weak(
+        head, record, std::memory_order_release, std::memory_order_relaxed
+    ));
+    return record;
+}
+
+// Запись текущего потока, освобождаемая при его завершении
+class ThreadRecord {
+  public:
+    ThreadRecord() : record_(AcquireRecord()) {}
+
+    ~ThreadRecord() {
+        record_->epoch.store(0, std::memory_order_release);
+        record_->in_use.store(false, std::memory_order_release);
+    }
+
+    Record& Get() noexcept {
+        return *record_;
+    }
+
+    // Глубина вложенности Guard
+    unsigned depth = 0;
+
+  private:
+    Record* record_;
+};
+
+ThreadRecord& GetThreadRecord() {
+    thread_local ThreadRecord record;
+    return record;
+}
+
+// Продвигает эпоху, если все читатели её догнали, и извлекает из очереди
+// объекты, которые можно удалить. Вызывается под retired_mutex
+std::vector<RetiredObject> TakeReclaimable() {
+    uint64_t epoch = global_epoch.load(std::memory_order_seq_cst);
+
+    bool can_advance = true;
+    for (Record* record = records.load(std::memory_order_acquire); record;
+         record = record->next) {
+        const uint64_t record_epoch =
+            record->epoch.load(std::memory_order_seq_cst);
+        if (record_epoch != 0 && record_epoch != epoch) {
+            can_advance = false;
+            break;
+        }
+    }
+
+    if (can_advance &&
+        global_epoch.compare_exchange_strong(epoch, epoch + 1)) {
+        ++epoch;
+    }
+
+    const auto reclaimable_end = std::partition(
+        retired.begin(), retired.end(),
+        [epoch](const RetiredObject& object) {
+            return object.epoch + 2 <= epoch;
+        }
+    );
+    std::vector<RetiredObject> result(retired.begin(), reclaimable_end);
+    retired.erase(retired.begin(), reclaimable_end);
+    return result;
+}
+
+// Удаляет объекты вне retired_mutex, так как деструкторы могут сами
+// вызывать Retire
+void Reclaim(const std::vector<RetiredObject>& objects) {
+    for (const auto& object : objects) {
+        object.deleter(object.ptr);
+    }
+}
+
+} // namespace
+
+Guard::Guard() noexcept {
+    ThreadRecord& thread_record = GetThreadRecord();
+    if (thread_record.depth++ == 0) {
+        thread_record.Get().epoch.store(
+            global_epoch.load(std::memory_order_seq_cst),
+            std::memory_order_seq_cst
+        );
+    }
+}
+
+Guard::~Guard() {
+    ThreadRecord& thread_record = GetThreadRecord();
+    if (--thread_record.depth == 0) {
+        thread_record.Get().epoch.store(0, std::memory_order_release);
+    }
+}
+
+void Retire(void* ptr, void (*deleter)(void*)) {
+    std::vector<RetiredObject> reclaimable;
+    {
+        std::lock_guard lock(retired_mutex);
+        retired.push_back(RetiredObject {
+            .ptr = ptr,
+            .deleter = deleter,
+            .epoch = global_epoch.load(std::memory_order_seq_cst),
+        });
+
+        if (retired.size() >= collect_threshold) {
+            reclaimable = TakeReclaimable();
+        }
+    }
+    Reclaim(reclaimable);
+}
+
+void Collect() {
+    std::vector<RetiredObject> reclaimable;
+    {
+        std::lock_guard lock(retired_mutex);
+        reclaimable = TakeReclaimable();
+    }
+    Reclaim(reclaimable);
+}
+
+void CollectAll() {
+    // Объект удаляется, когда эпоха продвинется на две позиции
+    for (int i = 0; i < 2; ++i) {
+        Collect();
+    }
+}
+
+uint64_t PendingCount() {
+    std::lock_guard lock(retired_mutex);
+    return retired.size();
+}
+
+}  // namespace utils::epoch
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+namespace utils::epoch {
+
+/*
+ *  Освобождение памяти на основе эпох для структур данных с чтением без
+ *  блокировок.
+ *
+ *  Читатель обращается к разделяемым объектам только внутри Guard. Писатель,
+ *  исключив объект из структуры, передаёт его в Retire. Объект удаляется,
+ *  когда глобальная эпоха продвинется на две позиции: к этому моменту все
+ *  читатели, которые могли его видеть, уже покинули свои Guard.
+ *
+ *  Вход в Guard и выход из него не ждут других потоков.
+ */
+class Guard {
+  public:
+    Guard() noexcept;
+
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+    ~Guard();
+};
+
+// Ставит объект в очередь на удаление через deleter(ptr)
+void Retire(void* ptr, void (*deleter)(void*));
+
+template <typename T>
+void Retire(T* ptr) {
+    Retire(static_cast<void*>(ptr), [](void* p) {
+        delete static_cast<T*>(p);
+    });
+}
+
+// Пытается продвинуть эпоху и удаляет объекты, которые уже никто не видит
+void Collect();
+
+// Удаляет все отложенные объекты, если ни один поток не находится внутри
+// Guard. Вызывается при разрушении структур данных, когда читателей уже нет
+void CollectAll();
+
+// Количество объектов, ожидающих удаления
+uint64_t PendingCount();
+
+}  // namespace utils::epoch
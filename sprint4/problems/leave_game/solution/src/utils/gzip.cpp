@@ -0,0 +1,39 @@
+#include "utils/gzip.h"
+
+#include <zlib.h>
+
+#include <stdexcept>
+
+namespace utils {
+
+std::string GzipCompress(std::string_view data) {
+    // 15 бит окна и 16 сверху - заголовок gzip вместо zlib
+    constexpr int window_bits = 15 + 16;
+    constexpr int memory_level = 8;
+
+    z_stream stream {};
+    if (deflateInit2(
+            &stream, Z_BEST_COMPRESSION, Z_DEFLATED, window_bits,
+            memory_level, Z_DEFAULT_STRATEGY
+        ) != Z_OK) {
+        throw std::runtime_error("Failed to initialize gzip stream");
+    }
+
+    std::string result(deflateBound(&stream, data.size()), '\0');
+    stream.next_in =
+        reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(result.data());
+    stream.avail_out = static_cast<uInt>(result.size());
+
+    const int status = deflate(&stream, Z_FINISH);
+    result.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    if (status != Z_STREAM_END) {
+        throw std::runtime_error("Failed to compress data with gzip");
+    }
+    return result;
+}
+
+}  // namespace utils
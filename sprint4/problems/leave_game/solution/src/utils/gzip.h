@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace utils {
+
+// Сжимает данные в формате gzip. При ошибке zlib бросает
+// std::runtime_error
+std::string GzipCompress(std::string_view data);
+
+}  // namespace utils
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace utils {
+
+/*
+ *  Ограниченная очередь без блокировок для многих писателей и одного
+ *  читателя. У каждой ячейки есть номер последовательности: писатель
+ *  занимает ячейку, сдвигая общий счётчик head_, и публикует значение,
+ *  увеличивая номер ячейки. Читатель забирает значения по порядку занятия.
+ */
+template <typename T>
+class MpscRing {
+  public:
+    // Ёмкость округляется вверх до степени двойки
+    explicit MpscRing(size_t capacity) :
+        mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1),
+        cells_(std::make_unique<Cell[]>(mask_ + 1)) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // Добавляет значение, если в очереди есть место. При неудаче значение
+    // остаётся нетронутым
+    bool TryPush(T&& value) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            const size_t sequence =
+                cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) -
+                static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed
+                    )) {
+                    cell.value.emplace(std::move(value));
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // Ячейку ещё не освободил читатель: очередь заполнена
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Вызывается только из потока читателя
+    std::optional<T> TryPop() {
+        Cell& cell = cells_[tail_ & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+            return std::nullopt;
+        }
+        std::optional<T> value = std::move(cell.value);
+        cell.value.reset();
+        cell.sequence.store(tail_ + mask_ + 1, std::memory_order_release);
+        ++tail_;
+        return value;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return mask_ + 1;
+    }
+
+  private:
+    struct Cell {
+        std::atomic<size_t> sequence {0};
+        std::optional<T> value;
+    };
+
+    // Писатели и читатель меняют счётчики независимо, поэтому они лежат в
+    // разных строках кеша
+    static constexpr size_t cache_line = 64;
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(cache_line) std::atomic<size_t> head_ {0};
+    alignas(cache_line) size_t tail_ = 0;
+};
+
+} // namespace utils
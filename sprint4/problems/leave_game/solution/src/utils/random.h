@@ -1,19 +1,130 @@
 #pragma once
 
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
 #include <random>
+#include <span>
+#include <type_traits>
 
 namespace utils {
 
-template<typename T>
-T GenerateRandomNumber(T lhs, T rhs) {
-    std::random_device device;
-    std::default_random_engine engine(device());
+// Генератор для засева других генераторов
+class SplitMix64 {
+  public:
+    explicit SplitMix64(uint64_t seed) noexcept : state_(seed) {}
+
+    uint64_t operator()() noexcept {
+        uint64_t z = (state_ += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+  private:
+    uint64_t state_;
+};
+
+/*
+ *  Генератор xoshiro256** (Blackman, Vigna). Удовлетворяет требованиям
+ *  UniformRandomBitGenerator и может использоваться со стандартными
+ *  распределениями. Не подходит для криптографии.
+ */
+class Xoshiro256StarStar {
+  public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256StarStar(uint64_t seed) noexcept {
+        Seed(seed);
+    }
+
+    void Seed(uint64_t seed) noexcept {
+        SplitMix64 seeder(seed);
+        for (auto& word : state_) {
+            word = seeder();
+        }
+    }
+
+    static constexpr result_type min() noexcept {
+        return 0;
+    }
+
+    static constexpr result_type max() noexcept {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() noexcept {
+        const uint64_t result = std::rotl(state_[1] * 5, 7) * 9;
+        const uint64_t t = state_[1] << 17;
+
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = std::rotl(state_[3], 45);
+
+        return result;
+    }
+
+  private:
+    uint64_t state_[4];
+};
+
+using RandomEngine = Xoshiro256StarStar;
+
+namespace detail {
+
+inline std::atomic<bool> is_random_seed_set {false};
+inline std::atomic<uint64_t> random_seed {0};
+
+} // namespace detail
+
+/*
+ *  Делает засев генераторов детерминированным: MakeRandomSeed(stream)
+ *  возвращает число, зависящее только от seed и номера потока чисел
+ *  stream. Без вызова генераторы засеваются из std::random_device.
+ *  Вызывается до создания генераторов.
+ */
+inline void SetRandomSeed(uint64_t seed) noexcept {
+    detail::random_seed.store(seed, std::memory_order_relaxed);
+    detail::is_random_seed_set.store(true, std::memory_order_release);
+}
+
+// Засев генератора потока чисел с номером stream. Потоки чисел с разными
+// номерами не пересекаются на практике
+inline uint64_t MakeRandomSeed(uint64_t stream) {
+    if (!detail::is_random_seed_set.load(std::memory_order_acquire)) {
+        std::random_device device;
+        return (uint64_t(device()) << 32) ^ uint64_t(device());
+    }
+    return SplitMix64(
+        detail::random_seed.load(std::memory_order_relaxed) + stream
+    )();
+}
+
+// Равномерно распределённое число из отрезка [lhs, rhs] для целых T и из
+// полуинтервала [lhs, rhs) для вещественных
+template <typename T>
+T GenerateRandomNumber(RandomEngine& engine, T lhs, T rhs) noexcept {
     if constexpr (std::is_integral_v<T>) {
-        std::uniform_int_distribution<T> distribution(lhs, rhs);
-        return distribution(engine);
+        return std::uniform_int_distribution<T>(lhs, rhs)(engine);
     } else {
-        std::uniform_real_distribution<T> distribution(lhs, rhs);
-        return distribution(engine);
+        // 53 старших бита дают равномерное число из [0, 1) с шагом 2^-53
+        const T unit = static_cast<T>(engine() >> 11) * T(0x1.0p-53);
+        return lhs + (rhs - lhs) * unit;
+    }
+}
+
+// Заполняет output числами из того же диапазона, что и
+// GenerateRandomNumber
+template <typename T>
+void GenerateRandomNumbers(
+    RandomEngine& engine, T lhs, T rhs, std::span<T> output
+) noexcept {
+    for (auto& value : output) {
+        value = GenerateRandomNumber(engine, lhs, rhs);
     }
 }
 
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace utils {
+
+// Хешер строк для unordered-контейнеров с поиском по std::string_view без
+// создания временной строки. Используется вместе с std::equal_to<>
+struct StringHasher {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view value) const noexcept {
+        return std::hash<std::string_view> {}(value);
+    }
+
+    size_t operator()(const std::string& value) const noexcept {
+        return (*this)(std::string_view(value));
+    }
+
+    size_t operator()(const char* value) const noexcept {
+        return (*this)(std::string_view(value));
+    }
+};
+
+} // namespace utils
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <thread>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 namespace utils {
 
 template<typename Fn>
@@ -17,4 +23,69 @@ void RunWorkers(unsigned n, const Fn& fn) {
     fn();
 }
 
+// Ядра, на которых процессу разрешено выполняться. Пусто, если система
+// не сообщает об этом
+inline std::vector<unsigned> GetAvailableCores() {
+    std::vector<unsigned> cores;
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+        for (unsigned core = 0; core < CPU_SETSIZE; ++core) {
+            if (CPU_ISSET(core, &cpu_set)) {
+                cores.push_back(core);
+            }
+        }
+    }
+#endif
+    return cores;
+}
+
+// Ядра для рабочих потоков: доступные процессу или, если система не
+// сообщает о них, первые hardware_concurrency ядер
+inline std::vector<unsigned> GetWorkerCores() {
+    auto cores = GetAvailableCores();
+    if (cores.empty()) {
+        const unsigned count =
+            std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned core = 0; core < count; ++core) {
+            cores.push_back(core);
+        }
+    }
+    return cores;
+}
+
+// Закрепляет текущий поток за ядром core. Возвращает false, если привязка
+// не удалась или не поддерживается системой
+inline bool PinCurrentThread(unsigned core) {
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core, &cpu_set);
+    return pthread_setaffinity_np(
+               pthread_self(), sizeof(cpu_set), &cpu_set
+           ) == 0;
+#else
+    return false;
+#endif
+}
+
+// Как RunWorkers, но запускает по потоку на каждое ядро из cores и
+// закрепляет поток за его ядром. Вызывающий поток занимает первое ядро
+template<typename Fn>
+void RunPinnedWorkers(const std::vector<unsigned>& cores, const Fn& fn) {
+    std::vector<std::jthread> workers;
+    workers.reserve(cores.size());
+    for (size_t i = 1; i < cores.size(); ++i) {
+        workers.emplace_back([core = cores[i], &fn] {
+            PinCurrentThread(core);
+            fn();
+        });
+    }
+    if (!cores.empty()) {
+        PinCurrentThread(cores.front());
+    }
+    fn();
+}
+
 }  // namespace utils
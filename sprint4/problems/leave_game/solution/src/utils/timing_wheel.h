@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+/*
+ *  Иерархическое колесо таймеров с точностью в одну миллисекунду.
+ *
+ *  Время колеса отсчитывается от нуля и продвигается только вызовом
+ *  Advance. Каждый уровень состоит из 64 ячеек, ячейка уровня k покрывает
+ *  64^k миллисекунд. Запись попадает на уровень, определяемый старшим
+ *  различающимся разрядом её срока и текущего времени, и по мере
+ *  приближения срока переносится на нижние уровни. Поэтому Advance
+ *  посещает только непустые ячейки, а стоимость продвижения определяется
+ *  числом истёкших и перенесённых записей, а не общим их числом.
+ *
+ *  Отмены записей нет: владелец проверяет актуальность записи, когда она
+ *  истекает, и при необходимости планирует её заново.
+ */
+template <typename Value>
+class TimingWheel {
+  public:
+    using Time = std::chrono::milliseconds;
+
+    Time GetNow() const noexcept {
+        return Time(now_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    // Срок, который уже наступил, истечёт при ближайшем вызове Advance
+    void Schedule(Time deadline, Value value) {
+        Insert(Entry {ToTicks(deadline), std::move(value)});
+        ++size_;
+    }
+
+    // Продвигает время колеса до now и вызывает on_expired(Value&&) для
+    // каждой истёкшей записи в порядке сроков. on_expired может планировать
+    // новые записи
+    template <typename Fn>
+    void Advance(Time now, Fn&& on_expired) {
+        const uint64_t target = std::max(now_, ToTicks(now));
+
+        while (true) {
+            while (!ready_.empty()) {
+                std::vector<Entry> entries = std::move(ready_);
+                ready_.clear();
+                for (auto& entry : entries) {
+                    --size_;
+                    on_expired(std::move(entry.value));
+                }
+            }
+
+            const auto expiration = NextExpiration();
+            if (!expiration || expiration->time > target) {
+                break;
+            }
+
+            const auto [level, slot, time] = *expiration;
+            now_ = time;
+            std::vector<Entry> entries = std::move(levels_[level][slot]);
+            levels_[level][slot].clear();
+            occupied_[level] &= ~(uint64_t(1) << slot);
+
+            // Истёкшие записи попадают в ready_, остальные - на нижние уровни
+            for (auto& entry : entries) {
+                Insert(std::move(entry));
+            }
+        }
+
+        now_ = target;
+    }
+
+  private:
+    static constexpr unsigned slot_bits = 6;
+    static constexpr unsigned slots_count = 1u << slot_bits;
+    static constexpr unsigned levels_count = 4;
+    // Более далёкие сроки размещаются на верхнем уровне по кругу
+    static constexpr uint64_t max_span = uint64_t(1)
+        << (slot_bits * levels_count);
+
+    struct Entry {
+        uint64_t deadline;
+        Value value;
+    };
+
+    struct Expiration {
+        unsigned level;
+        unsigned slot;
+        uint64_t time;
+    };
+
+    static constexpr uint64_t SlotRange(unsigned level) noexcept {
+        return uint64_t(1) << (slot_bits * level);
+    }
+
+    static uint64_t ToTicks(Time time) noexcept {
+        return time.count() > 0 ? static_cast<uint64_t>(time.count()) : 0;
+    }
+
+    void Insert(Entry entry) {
+        if (entry.deadline <= now_) {
+            ready_.push_back(std::move(entry));
+            return;
+        }
+
+        uint64_t masked = (now_ ^ entry.deadline) | (slots_count - 1);
+        if (masked >= max_span) {
+            masked = max_span - 1;
+        }
+        const unsigned level = (63 - std::countl_zero(masked)) / slot_bits;
+        const unsigned slot =
+            (entry.deadline >> (slot_bits * level)) & (slots_count - 1);
+
+        levels_[level][slot].push_back(std::move(entry));
+        occupied_[level] |= uint64_t(1) << slot;
+    }
+
+    // Ближайшая непустая ячейка. Ячейки нижних уровней всегда истекают
+    // раньше ячеек верхних
+    std::optional<Expiration> NextExpiration() const noexcept {
+        for (unsigned level = 0; level < levels_count; ++level) {
+            if (!occupied_[level]) {
+                continue;
+            }
+
+            const uint64_t slot_range = SlotRange(level);
+            const uint64_t level_range = slot_range * slots_count;
+            // Поиск начинается со следующей ячейки: текущая ячейка может
+            // быть занята только на верхнем уровне записями следующего
+            // оборота, и тогда она просматривается последней
+            const uint64_t next_slot = now_ / slot_range + 1;
+            const unsigned zeros = std::countr_zero(std::rotr(
+                occupied_[level], static_cast<int>(next_slot % slots_count)
+            ));
+            const unsigned slot = (next_slot + zeros) % slots_count;
+
+            uint64_t time = (now_ & ~(level_range - 1)) + slot * slot_range;
+            if (time <= now_) {
+                assert(level + 1 == levels_count);
+                time += level_range;
+            }
+            return Expiration {level, slot, time};
+        }
+        return std::nullopt;
+    }
+
+    uint64_t now_ = 0;
+    size_t size_ = 0;
+    std::array<std::array<std::vector<Entry>, slots_count>, levels_count>
+        levels_;
+    std::array<uint64_t, levels_count> occupied_ {};
+    std::vector<Entry> ready_;
+};
+
+}  // namespace utils
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "web/request_arena.h"
+#include "web/shared_string_body.h"
+
 #include <boost/beast/http.hpp>
 
 namespace web {
@@ -13,10 +16,19 @@ using HttpRequest = http::request<Body, http::basic_fields<Allocator>>;
 template <typename Body, typename Allocator>
 using HttpResponse = http::response<Body, http::basic_fields<Allocator>>;
 
-using StringRequest = http::request<http::string_body>;
+// Запросы размещаются в арене соединения, см. RequestArena
+using RequestBody = http::basic_string_body<
+    char, std::char_traits<char>, RequestAllocator>;
+
+using StringRequest =
+    http::request<RequestBody, http::basic_fields<RequestAllocator>>;
+
+using RequestParser = http::request_parser<RequestBody, RequestAllocator>;
 
 using StringResponse = http::response<http::string_body>;
 
 using FileResponse = http::response<http::file_body>;
 
+using SharedStringResponse = http::response<SharedStringBody>;
+
 } // namespace web
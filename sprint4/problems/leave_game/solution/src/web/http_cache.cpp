@@ -0,0 +1,114 @@
+#include "web/http_cache.h"
+#include "utils/gzip.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <memory>
+
+namespace web {
+
+namespace {
+
+bool EqualsIgnoreCase(std::string_view lhs, std::string_view rhs) {
+    return std::ranges::equal(lhs, rhs, [](unsigned char l, unsigned char r) {
+        return std::tolower(l) == std::tolower(r);
+    });
+}
+
+std::string_view Trim(std::string_view text) {
+    const auto begin = text.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    const auto end = text.find_last_not_of(" \t");
+    return text.substr(begin, end - begin + 1);
+}
+
+// Вызывает fn для каждого элемента списка, разделённого запятыми.
+// Останавливается, если fn вернула true
+template <typename Fn>
+bool AnyListItem(std::string_view list, Fn&& fn) {
+    while (!list.empty()) {
+        const auto comma = list.find(',');
+        if (fn(Trim(list.substr(0, comma)))) {
+            return true;
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        list.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+std::string_view RemoveWeakPrefix(std::string_view etag) {
+    if (etag.starts_with("W/")) {
+        etag.remove_prefix(2);
+    }
+    return etag;
+}
+
+} // namespace
+
+std::string MakeStrongETag(std::string_view content) {
+    // FNV-1a: содержимое неизменяемо, и хэш нужен только для того, чтобы
+    // разные версии содержимого получали разные ETag
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char c : content) {
+        hash = (hash ^ c) * 0x100000001b3ull;
+    }
+
+    static constexpr char hex_digits[] = "0123456789abcdef";
+    std::string etag(18, '"');
+    for (int i = 16; i > 0; --i, hash >>= 4) {
+        etag[i] = hex_digits[hash & 0xf];
+    }
+    return etag;
+}
+
+bool IsETagMatched(std::string_view if_none_match, std::string_view etag) {
+    etag = RemoveWeakPrefix(etag);
+    return AnyListItem(if_none_match, [&](std::string_view item) {
+        return item == "*" || RemoveWeakPrefix(item) == etag;
+    });
+}
+
+bool IsEncodingAccepted(
+    std::string_view accept_encoding, std::string_view coding
+) {
+    return AnyListItem(accept_encoding, [&](std::string_view item) {
+        const auto semicolon = item.find(';');
+        if (!EqualsIgnoreCase(Trim(item.substr(0, semicolon)), coding)) {
+            return false;
+        }
+        if (semicolon == std::string_view::npos) {
+            return true;
+        }
+
+        // Кодирование с нулевым весом явно запрещено
+        std::string_view weight = Trim(item.substr(semicolon + 1));
+        if (!weight.starts_with("q=") && !weight.starts_with("Q=")) {
+            return true;
+        }
+        weight.remove_prefix(2);
+        return weight.find_first_not_of("0.") != std::string_view::npos;
+    });
+}
+
+PrecomputedBody PrecomputedBody::Make(std::string content) {
+    auto gzip_content = utils::GzipCompress(content);
+
+    PrecomputedBody result;
+    result.etag = MakeStrongETag(content);
+    // Уже сжатые форматы, например картинки, почти не уменьшаются
+    if (gzip_content.size() < content.size() - content.size() / 10) {
+        result.gzip_etag = MakeStrongETag(gzip_content);
+        result.gzip_body =
+            std::make_shared<const std::string>(std::move(gzip_content));
+    }
+    result.body = std::make_shared<const std::string>(std::move(content));
+    return result;
+}
+
+} // namespace web
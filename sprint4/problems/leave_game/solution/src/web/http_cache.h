@@ -0,0 +1,36 @@
+#pragma once
+
+#include "web/shared_string_body.h"
+
+#include <string>
+#include <string_view>
+
+namespace web {
+
+// Сильный ETag содержимого в кавычках
+std::string MakeStrongETag(std::string_view content);
+
+// Совпадает ли etag с одним из значений заголовка If-None-Match.
+// Сравнение слабое, как того требует RFC 9110 для этого заголовка
+bool IsETagMatched(std::string_view if_none_match, std::string_view etag);
+
+// Разрешает ли заголовок Accept-Encoding кодирование coding
+bool IsEncodingAccepted(
+    std::string_view accept_encoding, std::string_view coding
+);
+
+/*
+ *  Неизменяемое тело ответа, подготовленное заранее вместе со сжатой
+ *  версией и ETag обеих версий. Сжатой версии нет, если сжатие почти не
+ *  уменьшает тело.
+ */
+struct PrecomputedBody {
+    static PrecomputedBody Make(std::string content);
+
+    SharedStringBody::value_type body;
+    std::string etag;
+    SharedStringBody::value_type gzip_body;
+    std::string gzip_etag;
+};
+
+} // namespace web
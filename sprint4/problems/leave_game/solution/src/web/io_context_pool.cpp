@@ -0,0 +1,40 @@
+#include "web/io_context_pool.h"
+#include "utils/thread.h"
+
+namespace web {
+
+IoContextPool::IoContextPool() : IoContextPool(utils::GetWorkerCores()) {}
+
+IoContextPool::IoContextPool(std::vector<unsigned> cores) :
+    cores_(std::move(cores)) {
+    contexts_.reserve(cores_.size());
+    for (size_t i = 0; i < cores_.size(); ++i) {
+        // Подсказка планировщику: io_context выполняется одним потоком
+        contexts_.push_back(std::make_unique<net::io_context>(1));
+    }
+}
+
+IoContextPool::~IoContextPool() {
+    Stop();
+}
+
+void IoContextPool::Start() {
+    threads_.reserve(contexts_.size());
+    for (size_t i = 0; i < contexts_.size(); ++i) {
+        guards_.push_back(net::make_work_guard(*contexts_[i]));
+        threads_.emplace_back([this, i] {
+            utils::PinCurrentThread(cores_[i]);
+            contexts_[i]->run();
+        });
+    }
+}
+
+void IoContextPool::Stop() {
+    guards_.clear();
+    for (auto& context : contexts_) {
+        context->stop();
+    }
+    threads_.clear();
+}
+
+} // namespace web
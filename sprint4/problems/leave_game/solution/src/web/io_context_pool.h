@@ -0,0 +1,55 @@
+#pragma once
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace web {
+
+namespace net = boost::asio;
+
+/*
+ *  Набор io_context по одному на ядро. Каждый io_context выполняет
+ *  единственный поток, закреплённый за своим ядром, поэтому обработчики,
+ *  запущенные в io_context, не переходят между ядрами.
+ */
+class IoContextPool {
+  public:
+    // Пул по числу ядер, доступных процессу
+    IoContextPool();
+
+    explicit IoContextPool(std::vector<unsigned> cores);
+
+    IoContextPool(const IoContextPool&) = delete;
+    IoContextPool& operator=(const IoContextPool&) = delete;
+
+    ~IoContextPool();
+
+    size_t GetSize() const noexcept {
+        return contexts_.size();
+    }
+
+    net::io_context& Get(size_t index) {
+        return *contexts_.at(index);
+    }
+
+    // Запускает потоки пула. Потоки работают до вызова Stop, даже если
+    // в io_context нет асинхронных операций
+    void Start();
+
+    // Останавливает io_context и дожидается завершения потоков
+    void Stop();
+
+  private:
+    using WorkGuard = net::executor_work_guard<net::io_context::executor_type>;
+
+    std::vector<unsigned> cores_;
+    std::vector<std::unique_ptr<net::io_context>> contexts_;
+    std::vector<WorkGuard> guards_;
+    std::vector<std::jthread> threads_;
+};
+
+} // namespace web
@@ -10,6 +10,7 @@
 #include <boost/beast/http.hpp>
 
 #include <memory>
+#include <stdexcept>
 
 namespace web {
 
@@ -17,19 +18,55 @@ namespace net = boost::asio;
 using tcp = net::ip::tcp;
 namespace beast = boost::beast;
 
+#ifdef SO_REUSEPORT
+// Опция сокета SO_REUSEPORT в виде, который принимает set_option Asio
+class ReusePortOption {
+  public:
+    explicit ReusePortOption(bool enabled) : value_(enabled ? 1 : 0) {}
+
+    template <typename Protocol>
+    int level(const Protocol&) const {
+        return SOL_SOCKET;
+    }
+
+    template <typename Protocol>
+    int name(const Protocol&) const {
+        return SO_REUSEPORT;
+    }
+
+    template <typename Protocol>
+    const int* data(const Protocol&) const {
+        return &value_;
+    }
+
+    template <typename Protocol>
+    size_t size(const Protocol&) const {
+        return sizeof(value_);
+    }
+
+  private:
+    int value_;
+};
+#endif
+
 template <typename RequestHandler>
 class Listener : public std::enable_shared_from_this<Listener<RequestHandler>> {
   public:
+    // reuse_port позволяет нескольким акцепторам слушать один порт, а ядру
+    // ОС - распределять между ними входящие соединения
     template <typename Handler>
     Listener(
         net::io_context& io, const tcp::endpoint& endpoint,
-        Handler&& request_handler
+        Handler&& request_handler, bool reuse_port = false
     ) :
         io_(io),
         acceptor_(net::make_strand(io)),
         request_handler_(std::forward<Handler>(request_handler)) {
         acceptor_.open(endpoint.protocol());
         acceptor_.set_option(net::socket_base::reuse_address(true));
+        if (reuse_port) {
+            SetReusePort();
+        }
         acceptor_.bind(endpoint);
         acceptor_.listen(net::socket_base::max_listen_connections);
     }
@@ -39,6 +76,14 @@ class Listener : public std::enable_shared_from_this<Listener<RequestHandler>> {
     }
 
   private:
+    void SetReusePort() {
+#ifdef SO_REUSEPORT
+        acceptor_.set_option(ReusePortOption(true));
+#else
+        throw std::runtime_error("SO_REUSEPORT is not supported");
+#endif
+    }
+
     void DoAccept() {
         acceptor_.async_accept(
             net::make_strand(io_),
@@ -0,0 +1,32 @@
+#include "web/request_arena.h"
+
+#include <algorithm>
+
+namespace web {
+
+RequestArena& RequestArenaPool::Acquire(size_t sequence) {
+    std::unique_ptr<RequestArena> arena;
+    if (free_.empty()) {
+        arena = std::make_unique<RequestArena>(upstream_);
+    } else {
+        arena = std::move(free_.back());
+        free_.pop_back();
+    }
+
+    return *busy_.emplace_back(sequence, std::move(arena)).second;
+}
+
+void RequestArenaPool::Release(size_t sequence) {
+    auto it = std::find_if(busy_.begin(), busy_.end(), [&](const auto& item) {
+        return item.first == sequence;
+    });
+    if (it == busy_.end()) {
+        return;
+    }
+
+    it->second->Reset();
+    free_.push_back(std::move(it->second));
+    busy_.erase(it);
+}
+
+} // namespace web
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace web {
+
+/*
+ *  Аллокатор поверх std::pmr::memory_resource. В отличие от
+ *  std::pmr::polymorphic_allocator допускает присваивание, которого Beast
+ *  требует от аллокатора полей сообщения.
+ */
+template <typename T>
+class ArenaAllocator {
+  public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept :
+        resource_(std::pmr::get_default_resource()) {}
+
+    ArenaAllocator(std::pmr::memory_resource* resource) noexcept :
+        resource_(resource) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept :
+        resource_(other.GetResource()) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(
+            resource_->allocate(n * sizeof(T), alignof(T))
+        );
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    std::pmr::memory_resource* GetResource() const noexcept {
+        return resource_;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return resource_ == other.GetResource() ||
+            resource_->is_equal(*other.GetResource());
+    }
+
+  private:
+    std::pmr::memory_resource* resource_;
+};
+
+using RequestAllocator = ArenaAllocator<char>;
+
+/*
+ *  Арена одного запроса: заголовки, цель и тело размещаются в ней подряд
+ *  и освобождаются одним сбросом. Обычный запрос к API целиком помещается
+ *  во встроенный буфер, и куча не используется вовсе.
+ */
+class RequestArena {
+  public:
+    static constexpr size_t inline_size = 4096;
+
+    explicit RequestArena(
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource()
+    ) :
+        resource_(buffer_.data(), buffer_.size(), upstream) {}
+
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    RequestAllocator GetAllocator() noexcept {
+        return &resource_;
+    }
+
+    // Освобождает всю память запроса. Объекты, размещённые в арене,
+    // должны быть уже разрушены или больше не использоваться
+    void Reset() noexcept {
+        resource_.release();
+    }
+
+  private:
+    alignas(std::max_align_t) std::array<std::byte, inline_size> buffer_;
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+/*
+ *  Арены запросов одного соединения. Арена выдаётся под номер запроса и
+ *  возвращается в пул, когда ответ на запрос готов. Пул растёт до числа
+ *  одновременно обрабатываемых запросов соединения.
+ */
+class RequestArenaPool {
+  public:
+    explicit RequestArenaPool(
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource()
+    ) :
+        upstream_(upstream) {}
+
+    RequestArena& Acquire(size_t sequence);
+
+    void Release(size_t sequence);
+
+    size_t GetSize() const noexcept {
+        return free_.size() + busy_.size();
+    }
+
+  private:
+    std::pmr::memory_resource* upstream_;
+    std::vector<std::unique_ptr<RequestArena>> free_;
+    std::vector<std::pair<size_t, std::unique_ptr<RequestArena>>> busy_;
+};
+
+} // namespace web
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <charconv>
+#include <concepts>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace web {
+
+// Параметры запроса. Имена и значения используются без декодирования,
+// поэтому подходят для параметров из латинских букв и чисел
+class QueryString {
+  public:
+    QueryString() = default;
+
+    explicit QueryString(std::string_view query) : query_(query) {}
+
+    std::optional<std::string_view> Find(std::string_view name) const {
+        std::string_view rest = query_;
+        while (!rest.empty()) {
+            const size_t end = rest.find('&');
+            const std::string_view param = rest.substr(0, end);
+            rest = end == rest.npos ? std::string_view() : rest.substr(end + 1);
+
+            const size_t eq = param.find('=');
+            if (param.substr(0, eq) == name) {
+                return eq == param.npos ? std::string_view()
+                                        : param.substr(eq + 1);
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Числовой параметр или nullopt, если его нет в запросе. Если значение
+    // не является числом, бросает std::invalid_argument
+    template <std::integral T>
+    std::optional<T> GetNumber(std::string_view name) const {
+        const auto text = Find(name);
+        if (!text) {
+            return std::nullopt;
+        }
+
+        T value {};
+        const char* end = text->data() + text->size();
+        const auto [ptr, ec] = std::from_chars(text->data(), end, value);
+        if (text->empty() || ec != std::errc() || ptr != end) {
+            throw std::invalid_argument(
+                "Invalid value of query parameter " + std::string(name)
+            );
+        }
+        return value;
+    }
+
+  private:
+    std::string_view query_;
+};
+
+// Цель запроса, разделённая на путь и параметры
+struct RequestTarget {
+    std::string_view path;
+    QueryString query;
+
+    static RequestTarget Parse(std::string_view target) {
+        const size_t question = target.find('?');
+        if (question == target.npos) {
+            return {.path = target, .query = {}};
+        }
+        return {
+            .path = target.substr(0, question),
+            .query = QueryString(target.substr(question + 1)),
+        };
+    }
+};
+
+} // namespace web
@@ -60,6 +60,21 @@ class ResponseBuilder {
         }
     }
 
+    // Тело, уже записанное в JSON
+    void SetJsonText(std::string text, http::status status = http::status::ok) {
+        SetStatus(status);
+
+        res_.set(
+            http::field::content_type,
+            web::ContentType::application::json
+        );
+        res_.content_length(text.size());
+
+        if (config_.add_body) {
+            res_.body() = std::move(text);
+        }
+    }
+
     http::response<Body> MakeResponse() const {
         return res_;
     }
@@ -138,4 +153,28 @@ class JsonResponseBuilder : public ResponseBuilder<http::string_body> {
     }
 };
 
+// Ответ с телом, уже сериализованным в JSON и разделяемым с другими
+// ответами
+class SharedJsonResponseBuilder : public ResponseBuilder<SharedStringBody> {
+  public:
+    using ResponseBuilder::ResponseBuilder;
+
+    void SetJsonBody(
+        SharedStringBody::value_type body,
+        http::status status = http::status::ok
+    ) {
+        SetStatus(status);
+
+        res_.set(
+            http::field::content_type,
+            web::ContentType::application::json
+        );
+        res_.content_length(SharedStringBody::size(body));
+
+        if (config_.add_body) {
+            res_.body() = std::move(body);
+        }
+    }
+};
+
 }  // namespace web
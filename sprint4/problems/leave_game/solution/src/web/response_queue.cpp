@@ -0,0 +1,48 @@
+#include "web/response_queue.h"
+
+#include <cassert>
+
+namespace web {
+
+void ResponseQueue::Put(
+    size_t sequence, std::unique_ptr<PendingResponse> response
+) {
+    assert(sequence >= first_sequence_ && sequence < next_sequence_);
+
+    const size_t index = sequence - first_sequence_;
+    if (responses_.size() <= index) {
+        responses_.resize(index + 1);
+    }
+    responses_[index] = std::move(response);
+}
+
+ResponseBatch ResponseQueue::TakeReady() {
+    ResponseBatch batch;
+
+    while (!responses_.empty() && responses_.front() &&
+           batch.responses.size() < max_batch_size_) {
+        auto& response = responses_.front();
+        if (!response->IsGatherable()) {
+            // Такой ответ пишется отдельно, поэтому завершает пакет
+            if (!batch.IsEmpty()) {
+                break;
+            }
+        } else {
+            response->AppendBuffers(batch.buffers);
+        }
+
+        batch.close = response->NeedEof();
+        const bool gatherable = response->IsGatherable();
+        batch.responses.push_back(std::move(response));
+        responses_.pop_front();
+        ++first_sequence_;
+
+        if (batch.close || !gatherable) {
+            break;
+        }
+    }
+
+    return batch;
+}
+
+} // namespace web
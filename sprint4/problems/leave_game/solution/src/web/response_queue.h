@@ -0,0 +1,165 @@
+#pragma once
+
+#include "web/core.h"
+
+#include <boost/asio/buffer.hpp>
+#include <boost/beast/core/buffers_range.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace web {
+
+namespace net = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace sys = boost::system;
+
+// Ответ, ожидающий отправки клиенту
+class PendingResponse {
+  public:
+    using WriteHandler = std::function<void(sys::error_code, size_t)>;
+
+    virtual ~PendingResponse() = default;
+
+    // Нужно ли закрыть соединение после ответа
+    virtual bool NeedEof() const = 0;
+
+    // Можно ли отправить ответ готовыми буферами вместе с соседними
+    // ответами. Буферы остаются действительными, пока жив ответ
+    virtual bool IsGatherable() const = 0;
+
+    virtual void AppendBuffers(std::vector<net::const_buffer>& buffers) = 0;
+
+    // Отправка ответа отдельно от остальных через сериализатор Beast
+    virtual void AsyncWrite(beast::tcp_stream& stream, WriteHandler handler)
+        = 0;
+};
+
+namespace detail {
+
+// Тела, которые целиком лежат в памяти и не меняются при отправке
+template <typename Body>
+constexpr bool is_in_memory_body = std::is_same_v<Body, http::string_body> ||
+    std::is_same_v<Body, SharedStringBody> ||
+    std::is_same_v<Body, http::empty_body>;
+
+template <typename Body, typename Fields>
+class PendingResponseImpl final : public PendingResponse {
+  public:
+    explicit PendingResponseImpl(http::response<Body, Fields>&& response) :
+        response_(std::move(response)) {}
+
+    bool NeedEof() const override {
+        return response_.need_eof();
+    }
+
+    bool IsGatherable() const override {
+        return is_in_memory_body<Body> && !response_.chunked();
+    }
+
+    void AppendBuffers(std::vector<net::const_buffer>& buffers) override {
+        if constexpr (is_in_memory_body<Body>) {
+            std::ostringstream header;
+            header << response_.base();
+            header_ = std::move(header).str();
+            buffers.push_back(net::buffer(header_));
+
+            beast::error_code ec;
+            typename Body::writer writer(response_.base(), response_.body());
+            writer.init(ec);
+            while (auto result = writer.get(ec)) {
+                for (const auto& buffer : beast::buffers_range(result->first)) {
+                    if (buffer.size() != 0) {
+                        buffers.push_back(buffer);
+                    }
+                }
+                if (!result->second) {
+                    break;
+                }
+            }
+        }
+    }
+
+    void AsyncWrite(beast::tcp_stream& stream, WriteHandler handler) override {
+        http::async_write(stream, response_, std::move(handler));
+    }
+
+  private:
+    http::response<Body, Fields> response_;
+    std::string header_;
+};
+
+} // namespace detail
+
+template <typename Body, typename Fields>
+std::unique_ptr<PendingResponse> MakePendingResponse(
+    http::response<Body, Fields>&& response
+) {
+    return std::make_unique<detail::PendingResponseImpl<Body, Fields>>(
+        std::move(response)
+    );
+}
+
+// Ответы, отправляемые одной операцией записи
+struct ResponseBatch {
+    std::vector<std::unique_ptr<PendingResponse>> responses;
+    // Буферы всех ответов пакета. Пусты, если пакет состоит из одного
+    // ответа, который нужно отправить через PendingResponse::AsyncWrite
+    std::vector<net::const_buffer> buffers;
+    // После отправки пакета соединение нужно закрыть
+    bool close = false;
+
+    bool IsEmpty() const noexcept {
+        return responses.empty();
+    }
+};
+
+/*
+ *  Очередь ответов на конвейерные запросы одного соединения. Ответы могут
+ *  быть готовы в любом порядке, но отдаются строго в порядке запросов.
+ *  Готовые ответы подряд объединяются в один пакет для записи.
+ */
+class ResponseQueue {
+  public:
+    explicit ResponseQueue(size_t max_batch_size) :
+        max_batch_size_(max_batch_size) {}
+
+    // Номер очередного запроса, под который резервируется место в очереди
+    size_t Reserve() noexcept {
+        return next_sequence_++;
+    }
+
+    // Номер, который получит следующий запрос
+    size_t GetNextSequence() const noexcept {
+        return next_sequence_;
+    }
+
+    // Число запросов, ответы на которые ещё не забраны для отправки
+    size_t GetPendingCount() const noexcept {
+        return next_sequence_ - first_sequence_;
+    }
+
+    void Put(size_t sequence, std::unique_ptr<PendingResponse> response);
+
+    // Готовые ответы с начала очереди. Пакет пуст, если ответ на самый
+    // ранний запрос ещё не готов
+    ResponseBatch TakeReady();
+
+  private:
+    size_t max_batch_size_;
+    // Ответ на запрос first_sequence_ + i или nullptr, если он не готов
+    std::deque<std::unique_ptr<PendingResponse>> responses_;
+    size_t first_sequence_ = 0;
+    size_t next_sequence_ = 0;
+};
+
+} // namespace web
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "web/io_context_pool.h"
 #include "web/listener.h"
 
 namespace web {
@@ -18,4 +19,18 @@ void ServeHttp(
         ->Run();
 }
 
+// Принимает соединения в каждом io_context пула отдельным акцептором на
+// общем порту. Соединение обслуживается в том io_context, где его приняли
+template <typename RequestHandler>
+void ServeHttp(
+    IoContextPool& pool, const tcp::endpoint& endpoint,
+    const RequestHandler& handler
+) {
+    using MyListener = Listener<RequestHandler>;
+    for (size_t i = 0; i < pool.GetSize(); ++i) {
+        std::make_shared<MyListener>(pool.Get(i), endpoint, handler, true)
+            ->Run();
+    }
+}
+
 } // namespace web
@@ -2,6 +2,7 @@
 #include "web/utils.h"
 
 #include <boost/asio/dispatch.hpp>
+#include <boost/asio/write.hpp>
 #include <boost/json/value.hpp>
 #include <iostream>
 
@@ -16,26 +17,93 @@ void SessionBase::Run() {
 
 void SessionBase::Read() {
     using namespace std::literals;
-    request_ = {};
+    if (responses_.GetPendingCount() >= max_pipelined_requests) {
+        is_read_paused_ = true;
+        return;
+    }
+
+    const auto allocator =
+        arenas_.Acquire(responses_.GetNextSequence()).GetAllocator();
+    parser_.emplace(
+        std::piecewise_construct,
+        std::make_tuple(allocator),
+        std::make_tuple(allocator)
+    );
     stream_.expires_after(30s);
     http::async_read(
         stream_,
         buffer_,
-        request_,
+        *parser_,
         beast::bind_front_handler(&SessionBase::OnRead, GetSharedThis())
     );
 }
 
 void SessionBase::OnRead(sys::error_code ec, size_t bytes_read) {
     using namespace std::literals;
+    if (is_closed_) {
+        return;
+    }
     if (ec == http::error::end_of_stream) {
-        return Close();
+        // Ответы на уже прочитанные запросы отправляются до закрытия
+        is_read_finished_ = true;
+        if (responses_.GetPendingCount() == 0 && !is_writing_) {
+            Close();
+        }
+        return;
     }
     if (ec) {
+        is_read_finished_ = true;
         return logger::ReportError(ec, "read");
     }
 
-    HandleRequest(std::move(request_));
+    const bool keep_alive = parser_->get().keep_alive();
+    HandleRequest(responses_.Reserve(), parser_->release());
+
+    if (keep_alive) {
+        Read();
+    } else {
+        is_read_finished_ = true;
+    }
+}
+
+void SessionBase::OnResponse(
+    size_t sequence, std::unique_ptr<PendingResponse> response
+) {
+    if (is_closed_) {
+        return;
+    }
+
+    // Обработчик закончил работу с запросом, его память можно использовать
+    // для следующих запросов
+    arenas_.Release(sequence);
+    responses_.Put(sequence, std::move(response));
+    WriteReady();
+}
+
+void SessionBase::WriteReady() {
+    using namespace std::literals;
+    if (is_writing_ || is_closed_) {
+        return;
+    }
+
+    writing_ = responses_.TakeReady();
+    if (writing_.IsEmpty()) {
+        return;
+    }
+
+    is_writing_ = true;
+    stream_.expires_after(30s);
+    auto on_write = [self = GetSharedThis(), close = writing_.close](
+                        sys::error_code ec, size_t bytes_written
+                    ) {
+        self->OnWrite(close, ec, bytes_written);
+    };
+
+    if (writing_.buffers.empty()) {
+        writing_.responses.front()->AsyncWrite(stream_, std::move(on_write));
+    } else {
+        net::async_write(stream_, writing_.buffers, std::move(on_write));
+    }
 }
 
 void SessionBase::OnWrite(
@@ -43,17 +111,30 @@ void SessionBase::OnWrite(
     sys::error_code ec,
     size_t bytes_written
 ) {
+    is_writing_ = false;
+    writing_ = {};
+
     if (ec) {
         logger::ReportError(ec, "write");
     }
-    if (close) {
+    if (close || ec) {
         return Close();
     }
 
-    Read();
+    if (is_read_paused_) {
+        is_read_paused_ = false;
+        Read();
+    }
+
+    WriteReady();
+    if (!is_writing_ && is_read_finished_ &&
+        responses_.GetPendingCount() == 0) {
+        Close();
+    }
 }
 
 void SessionBase::Close() {
+    is_closed_ = true;
     sys::error_code ec;
     stream_.socket().shutdown(tcp::socket::shutdown_send, ec);
 }
@@ -1,12 +1,16 @@
 #pragma once
 
 #include "web/core.h"
+#include "web/response_queue.h"
 #include "logger/json.h"
 
+#include <boost/asio/dispatch.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 
+#include <optional>
+
 namespace web {
 
 namespace net = boost::asio;
@@ -17,29 +21,41 @@ namespace sys = boost::system;
 namespace logging = boost::log;
 namespace json = boost::json;
 
+/*
+ *  Соединение с клиентом. Запросы читаются и обрабатываются, пока ответы на
+ *  предыдущие запросы ещё не отправлены (конвейерная обработка HTTP/1.1).
+ *  Ответы отправляются в порядке запросов, готовые ответы объединяются в
+ *  одну запись.
+ */
 class SessionBase {
   public:
+    // Сколько запросов может ожидать отправки ответа, прежде чем сессия
+    // перестанет читать новые
+    static constexpr size_t max_pipelined_requests = 16;
+
     SessionBase(const SessionBase&) = delete;
     SessionBase& operator=(const SessionBase&) = delete;
 
     void Run();
 
+    // Отправляет ответ на запрос с номером sequence. Может вызываться из
+    // любого потока
     template <typename Body, typename Fields>
-    void Write(http::response<Body, Fields>&& response) {
-        auto safe_response =
-            std::make_shared<http::response<Body, Fields>>(std::move(response));
-
-        auto self = GetSharedThis();
-        http::async_write(
-            stream_, *safe_response,
-            [safe_response, self](sys::error_code ec, size_t bytes_written) {
-                self->OnWrite(safe_response->need_eof(), ec, bytes_written);
+    void Write(size_t sequence, http::response<Body, Fields>&& response) {
+        net::dispatch(
+            stream_.get_executor(),
+            [self = GetSharedThis(),
+             sequence,
+             pending = MakePendingResponse(std::move(response))]() mutable {
+                self->OnResponse(sequence, std::move(pending));
             }
         );
     }
 
   protected:
-    explicit SessionBase(tcp::socket&& socket) : stream_(std::move(socket)) {}
+    explicit SessionBase(tcp::socket&& socket) :
+        stream_(std::move(socket)),
+        responses_(max_pipelined_requests) {}
 
     ~SessionBase() = default;
 
@@ -47,6 +63,10 @@ class SessionBase {
 
     void OnRead(sys::error_code ec, size_t bytes_read);
 
+    void OnResponse(size_t sequence, std::unique_ptr<PendingResponse> response);
+
+    void WriteReady();
+
     void OnWrite(bool close, sys::error_code ec, size_t bytes_written);
 
     void Close();
@@ -55,14 +75,28 @@ class SessionBase {
         return stream_.socket().remote_endpoint();
     }
 
-    virtual void HandleRequest(StringRequest&& request) = 0;
+    virtual void HandleRequest(size_t sequence, StringRequest&& request) = 0;
 
     virtual std::shared_ptr<SessionBase> GetSharedThis() = 0;
 
   private:
     beast::tcp_stream stream_;
     beast::flat_buffer buffer_;
-    StringRequest request_;
+    // Разбор очередного запроса. Запрос размещается в арене из пула,
+    // которая освобождается, когда готов ответ на него
+    std::optional<RequestParser> parser_;
+    RequestArenaPool arenas_;
+
+    ResponseQueue responses_;
+    // Ответы, которые сейчас записываются в сокет
+    ResponseBatch writing_;
+    bool is_writing_ = false;
+    // Чтение приостановлено из-за переполнения очереди ответов
+    bool is_read_paused_ = false;
+    // Новых запросов не будет: клиент закрыл соединение или попросил
+    // закрыть его после ответа
+    bool is_read_finished_ = false;
+    bool is_closed_ = false;
 };
 
 template <typename RequestHandler>
@@ -94,10 +128,13 @@ class Session : public SessionBase,
     }
 
     template <typename Body, typename Allocator>
-    void LogResponse(const HttpResponse<Body, Allocator>& response) const {
+    void LogResponse(
+        const HttpResponse<Body, Allocator>& response,
+        std::chrono::system_clock::time_point receive_time
+    ) const {
         auto response_time =
             std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now() - receive_time_
+                std::chrono::system_clock::now() - receive_time
             );
 
         json::object response_log{
@@ -117,21 +154,23 @@ class Session : public SessionBase,
             << "response sent";
     }
 
-    void HandleRequest(StringRequest&& request) override {
+    void HandleRequest(size_t sequence, StringRequest&& request) override {
         LogRequest(request);
 
-        receive_time_ = std::chrono::system_clock::now();
         request_handler_(
             std::move(request),
-            [self = this->shared_from_this()](auto&& response) {
-                self->LogResponse(response);
-                self->Write(std::move(response));
+            [self = this->shared_from_this(),
+             sequence,
+             receive_time = std::chrono::system_clock::now()](
+                auto&& response
+            ) {
+                self->LogResponse(response, receive_time);
+                self->Write(sequence, std::move(response));
             }
         );
     }
 
     RequestHandler request_handler_;
-    std::chrono::system_clock::time_point receive_time_;
 };
 
 } // namespace web
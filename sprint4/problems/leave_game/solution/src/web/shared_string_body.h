@@ -0,0 +1,57 @@
+#pragma once
+
+#include <boost/asio/buffer.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/optional.hpp>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace web {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+
+/*
+ *  Тело ответа, разделяющее неизменяемую строку с другими ответами.
+ *  Отправка такого ответа не копирует строку, поэтому одно и то же
+ *  отрисованное тело может одновременно отдаваться нескольким клиентам.
+ */
+struct SharedStringBody {
+    using value_type = std::shared_ptr<const std::string>;
+
+    static uint64_t size(const value_type& body) noexcept {
+        return body ? body->size() : 0;
+    }
+
+    class writer {
+      public:
+        using const_buffers_type = net::const_buffer;
+
+        template <bool isRequest, typename Fields>
+        writer(
+            const http::header<isRequest, Fields>&, const value_type& body
+        ) :
+            body_(body) {}
+
+        void init(beast::error_code& ec) {
+            ec = {};
+        }
+
+        boost::optional<std::pair<const_buffers_type, bool>>
+        get(beast::error_code& ec) {
+            ec = {};
+            if (!body_) {
+                return boost::none;
+            }
+            return {{net::buffer(*body_), false}};
+        }
+
+      private:
+        const value_type& body_;
+    };
+};
+
+} // namespace web
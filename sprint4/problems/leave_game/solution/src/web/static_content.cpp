@@ -0,0 +1,250 @@
+#include "web/static_content.h"
+#include "web/utils.h"
+
+#include <charconv>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+namespace web {
+
+namespace {
+
+// Файлы редко меняются без перезапуска сервера, а ETag позволяет
+// проверить актуальность копии и после истечения срока
+constexpr std::string_view cache_control = "public, max-age=3600";
+
+std::string ReadFile(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open static file " + path.string());
+    }
+    return std::string(
+        std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()
+    );
+}
+
+// Время изменения файла в формате даты HTTP
+std::string GetLastModified(const fs::path& path) {
+    const auto file_time = fs::last_write_time(path);
+    const std::time_t time = std::chrono::system_clock::to_time_t(
+        std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+            fs::file_time_type::clock::to_sys(file_time)
+        )
+    );
+
+    std::tm tm {};
+    gmtime_r(&time, &tm);
+    char buffer[32];
+    const size_t size = std::strftime(
+        buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm
+    );
+    return std::string(buffer, size);
+}
+
+std::optional<size_t> ParseNumber(std::string_view text) {
+    size_t value = 0;
+    const char* end = text.data() + text.size();
+    const auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    if (text.empty() || ec != std::errc() || ptr != end) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+// Полуинтервал байтов [begin, end) или признак того, что диапазон
+// выходит за пределы файла
+struct ByteRange {
+    bool satisfiable = true;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+// nullopt, если заголовок Range нужно проигнорировать: он не разобран или
+// запрашивает несколько диапазонов
+std::optional<ByteRange> ParseRange(std::string_view header, size_t size) {
+    constexpr std::string_view unit = "bytes=";
+    if (!header.starts_with(unit) || header.find(',') != header.npos) {
+        return std::nullopt;
+    }
+    header.remove_prefix(unit.size());
+
+    const size_t dash = header.find('-');
+    if (dash == header.npos) {
+        return std::nullopt;
+    }
+    const std::string_view first = header.substr(0, dash);
+    const std::string_view last = header.substr(dash + 1);
+
+    // Последние last байтов файла
+    if (first.empty()) {
+        const auto length = ParseNumber(last);
+        if (!length) {
+            return std::nullopt;
+        }
+        if (*length == 0 || size == 0) {
+            return ByteRange {.satisfiable = false};
+        }
+        return ByteRange {
+            .begin = size - std::min(*length, size),
+            .end = size,
+        };
+    }
+
+    // Без второй границы диапазон продолжается до конца файла
+    const auto begin = ParseNumber(first);
+    const auto end = last.empty() ? std::optional(size) : ParseNumber(last);
+    if (!begin || !end || (!last.empty() && *end < *begin)) {
+        return std::nullopt;
+    }
+    if (*begin >= size) {
+        return ByteRange {.satisfiable = false};
+    }
+    return ByteRange {
+        .begin = *begin,
+        .end = last.empty() ? size : std::min(*end + 1, size),
+    };
+}
+
+std::string_view FindHeader(const StringRequest& req, http::field field) {
+    auto it = req.find(field);
+    return it == req.end() ? std::string_view() : std::string_view(it->value());
+}
+
+} // namespace
+
+StaticContent::StaticContent(const fs::path& root, size_t max_file_size) {
+    if (!fs::is_directory(root)) {
+        return;
+    }
+
+    for (const auto& entry : fs::recursive_directory_iterator(root)) {
+        if (!entry.is_regular_file() || entry.file_size() > max_file_size) {
+            continue;
+        }
+
+        const fs::path& path = entry.path();
+        files_.emplace(
+            "/" + fs::relative(path, root).generic_string(),
+            File {
+                .content = PrecomputedBody::Make(ReadFile(path)),
+                .content_type = GetMimeType(path.string()),
+                .last_modified = GetLastModified(path),
+            }
+        );
+    }
+}
+
+const StaticContent::File* StaticContent::Find(std::string_view path) const {
+    std::string key(path);
+    if (auto it = files_.find(key); it != files_.end()) {
+        return &it->second;
+    }
+
+    if (!key.ends_with('/')) {
+        key.push_back('/');
+    }
+    key += "index.html";
+    if (auto it = files_.find(key); it != files_.end()) {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+StaticResponse MakeStaticResponse(
+    const StringRequest& req, const StaticContent::File& file
+) {
+    const PrecomputedBody& content = file.content;
+    const bool add_body = req.method() == http::verb::get;
+    const bool use_gzip = content.gzip_body &&
+        IsEncodingAccepted(
+            FindHeader(req, http::field::accept_encoding), "gzip"
+        );
+    const std::string& etag = use_gzip ? content.gzip_etag : content.etag;
+
+    const auto set_headers = [&](auto& res, http::status status) {
+        res.result(status);
+        res.version(req.version());
+        res.keep_alive(req.keep_alive());
+        res.set(http::field::content_type, file.content_type);
+        res.set(http::field::cache_control, cache_control);
+        res.set(http::field::etag, etag);
+        res.set(http::field::last_modified, file.last_modified);
+        res.set(http::field::accept_ranges, "bytes");
+        res.set(http::field::vary, "Accept-Encoding");
+    };
+
+    // If-Modified-Since учитывается, только если нет If-None-Match, и
+    // сравнивается с датой, которую сервер отдал ранее
+    const std::string_view if_none_match =
+        FindHeader(req, http::field::if_none_match);
+    const bool not_modified = !if_none_match.empty()
+        ? IsETagMatched(if_none_match, etag)
+        : FindHeader(req, http::field::if_modified_since) ==
+              file.last_modified;
+    if (not_modified) {
+        SharedStringResponse res;
+        set_headers(res, http::status::not_modified);
+        return res;
+    }
+
+    // Диапазоны относятся к несжатому содержимому. If-Range отменяет
+    // диапазон, если файл изменился
+    const std::string_view range = FindHeader(req, http::field::range);
+    const std::string_view if_range = FindHeader(req, http::field::if_range);
+    const size_t size = content.body->size();
+    const auto byte_range = !range.empty() &&
+            (if_range.empty() || if_range == content.etag ||
+             if_range == file.last_modified)
+        ? ParseRange(range, size)
+        : std::nullopt;
+
+    if (byte_range && !byte_range->satisfiable) {
+        StringResponse res;
+        set_headers(res, http::status::range_not_satisfiable);
+        res.set(http::field::etag, content.etag);
+        res.set(http::field::content_range, "bytes */" + std::to_string(size));
+        res.content_length(0);
+        return res;
+    }
+
+    if (byte_range) {
+        const size_t length = byte_range->end - byte_range->begin;
+        StringResponse res;
+        set_headers(res, http::status::partial_content);
+        res.set(http::field::etag, content.etag);
+        res.set(
+            http::field::content_range,
+            "bytes " + std::to_string(byte_range->begin) + "-" +
+                std::to_string(byte_range->end - 1) + "/" +
+                std::to_string(size)
+        );
+        res.content_length(length);
+        if (add_body) {
+            res.body() = content.body->substr(byte_range->begin, length);
+        }
+        return res;
+    }
+
+    const auto& body = use_gzip ? content.gzip_body : content.body;
+    SharedStringResponse res;
+    set_headers(res, http::status::ok);
+    if (use_gzip) {
+        res.set(http::field::content_encoding, "gzip");
+    }
+    res.content_length(body->size());
+    if (add_body) {
+        res.body() = body;
+    }
+    return res;
+}
+
+std::string GetStaticPath(std::string_view target) {
+    return DecodeUrl(target.substr(0, target.find('?')));
+}
+
+} // namespace web
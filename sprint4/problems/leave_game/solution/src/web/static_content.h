@@ -0,0 +1,60 @@
+#pragma once
+
+#include "web/core.h"
+#include "web/http_cache.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+
+namespace web {
+
+namespace fs = std::filesystem;
+
+/*
+ *  Статические файлы, загруженные в память при запуске сервера вместе со
+ *  сжатыми версиями и заголовками кэширования. Файлы больше
+ *  max_file_size и файлы, появившиеся после запуска, в кэш не попадают и
+ *  должны отдаваться с диска.
+ */
+class StaticContent {
+  public:
+    struct File {
+        PrecomputedBody content;
+        std::string_view content_type;
+        std::string last_modified;
+    };
+
+    static constexpr size_t default_max_file_size = 16 << 20;
+
+    explicit StaticContent(
+        const fs::path& root, size_t max_file_size = default_max_file_size
+    );
+
+    // Файл по декодированному пути запроса без параметров. Для каталога
+    // возвращается его index.html
+    const File* Find(std::string_view path) const;
+
+    size_t Size() const noexcept {
+        return files_.size();
+    }
+
+  private:
+    std::unordered_map<std::string, File> files_;
+};
+
+using StaticResponse = std::variant<StringResponse, SharedStringResponse>;
+
+// Ответ на запрос файла из кэша с учётом Accept-Encoding, условных
+// заголовков и Range
+StaticResponse MakeStaticResponse(
+    const StringRequest& req, const StaticContent::File& file
+);
+
+// Путь запроса без параметров с декодированными символами
+std::string GetStaticPath(std::string_view target);
+
+} // namespace web
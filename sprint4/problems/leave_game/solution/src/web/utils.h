@@ -15,8 +15,10 @@ std::string_view GetMimeType(std::string_view path);
 
 std::string DecodeUrl(std::string_view url);
 
+// Текстовая форма токена из заголовка Authorization. Возвращаемая строка
+// ссылается на заголовок запроса
 template<typename Body, typename Allocator>
-std::optional<app::Token> TryExtractToken(
+std::optional<std::string_view> TryExtractTokenText(
     const web::HttpRequest<Body, Allocator>& req
 ) {
     auto it = req.find(http::field::authorization);
@@ -31,11 +33,11 @@ std::optional<app::Token> TryExtractToken(
     }
     header.remove_prefix(bearer_prefix.size());
 
-    if (header.size() != 32) {
+    if (header.size() != app::Token::text_size) {
         return std::nullopt;
     }
 
-    return app::Token(std::string(header));
+    return header;
 }
 
 }  // namespace web
@@ -0,0 +1,98 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "handlers/api_route.h"
+#include "web/request_target.h"
+
+using handlers::ApiEndpoint;
+using handlers::RouteApiTarget;
+
+namespace {
+
+const std::string TAG = "[ApiRoute]";
+
+} // namespace
+
+SCENARIO("API requests are routed by their path", TAG) {
+    GIVEN("targets of API endpoints") {
+        THEN("every path finds its endpoint") {
+            CHECK(RouteApiTarget("/api/v1/game/join").endpoint ==
+                  ApiEndpoint::join);
+            CHECK(RouteApiTarget("/api/v1/game/state?since=3").endpoint ==
+                  ApiEndpoint::state);
+            CHECK(RouteApiTarget("/api/v1/game/player/action/").endpoint ==
+                  ApiEndpoint::action);
+            CHECK(RouteApiTarget("/api/v1/game/records?start=1").endpoint ==
+                  ApiEndpoint::records);
+            CHECK(RouteApiTarget("/api/v1/maps").endpoint ==
+                  ApiEndpoint::maps_list);
+            CHECK(RouteApiTarget("/api/v1/maps/").endpoint ==
+                  ApiEndpoint::maps_list);
+        }
+
+        WHEN("a map is requested") {
+            const auto route = RouteApiTarget("/api/v1/maps/map1");
+
+            THEN("the map id is taken from the path without copying") {
+                CHECK(route.endpoint == ApiEndpoint::map_info);
+                CHECK(route.map_id == "map1");
+            }
+        }
+
+        WHEN("a map id contains a slash") {
+            const auto route = RouteApiTarget("/api/v1/maps/a/b");
+
+            THEN("it is still a map request, answered with 404") {
+                CHECK(route.endpoint == ApiEndpoint::map_info);
+                CHECK(route.map_id == "a/b");
+            }
+        }
+
+        THEN("unknown paths have no endpoint") {
+            for (std::string_view target :
+                 {"", "/api", "/api/v1", "/api/v1/game", "/api/v1/game/joinx",
+                  "/api/v1/mapsx", "/api/v1/metrics/1", "/api/v2/game/join"}) {
+                CAPTURE(target);
+                CHECK_FALSE(RouteApiTarget(target).endpoint);
+            }
+        }
+    }
+}
+
+TEST_CASE("Query parameters are parsed once", TAG) {
+    auto target =
+        web::RequestTarget::Parse("/api/v1/game/records?start=10&maxItems=5");
+    CHECK(target.path == "/api/v1/game/records");
+    CHECK(target.query.GetNumber<size_t>("start") == 10);
+    CHECK(target.query.GetNumber<size_t>("maxItems") == 5);
+    CHECK_FALSE(target.query.GetNumber<size_t>("max"));
+
+    auto invalid = web::RequestTarget::Parse("/game/state?since=1x&flag");
+    CHECK_THROWS_AS(
+        invalid.query.GetNumber<uint64_t>("since"), std::invalid_argument
+    );
+    CHECK(invalid.query.Find("flag") == "");
+    CHECK_FALSE(web::RequestTarget::Parse("/game/state").query.Find("since"));
+}
+
+TEST_CASE("API routing cost", TAG + "[.][benchmark]") {
+    constexpr std::array targets = {
+        "/api/v1/game/state",
+        "/api/v1/game/player/action",
+        "/api/v1/maps/town",
+        "/api/v1/maps",
+    };
+
+    BENCHMARK("string comparisons") {
+        size_t found = 0;
+        for (std::string_view target : targets) {
+            found += RouteApiTarget(target).endpoint.has_value();
+        }
+        return found;
+    };
+}
@@ -0,0 +1,225 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <boost/log/core/core.hpp>
+#include <boost/log/expressions/message.hpp>
+#include <boost/log/sinks/sync_frontend.hpp>
+#include <boost/log/sinks/text_ostream_backend.hpp>
+#include <boost/log/sinks/unlocked_frontend.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/log/utility/manipulators/add_value.hpp>
+#include <boost/make_shared.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger/async_sink.h"
+
+using namespace std::literals;
+
+namespace logging = boost::log;
+namespace sinks = boost::log::sinks;
+namespace expr = boost::log::expressions;
+
+namespace {
+
+const std::string TAG = "[AsyncSink]";
+
+void MessageFormatter(
+    const logging::record_view& record, logging::formatting_ostream& strm
+) {
+    strm << record[expr::smessage];
+}
+
+// Форматирование, похожее по объёму работы на JSON-журнал сервера
+void RequestFormatter(
+    const logging::record_view& record, logging::formatting_ostream& strm
+) {
+    strm << R"({"message":")" << record[expr::smessage]
+         << R"(","data":{"URI":")"
+         << record.attribute_values()["URI"].extract_or_default(""s)
+         << R"(","method":"GET"}})";
+}
+
+// Подключает бэкенд к ядру Boost.Log на время жизни объекта
+template <typename Frontend>
+class ScopedSink {
+  public:
+    template <typename Backend>
+    explicit ScopedSink(boost::shared_ptr<Backend> backend) :
+        sink_(boost::make_shared<Frontend>(std::move(backend))) {
+        logging::core::get()->add_sink(sink_);
+    }
+
+    ScopedSink(const ScopedSink&) = delete;
+    ScopedSink& operator=(const ScopedSink&) = delete;
+
+    ~ScopedSink() {
+        logging::core::get()->remove_sink(sink_);
+    }
+
+  private:
+    boost::shared_ptr<Frontend> sink_;
+};
+
+using AsyncFrontend = sinks::unlocked_sink<logger::AsyncSink>;
+
+std::vector<std::string> ReadLines(const std::ostringstream& out) {
+    std::istringstream in(out.str());
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+} // namespace
+
+SCENARIO("Records are written by the background thread", TAG) {
+    GIVEN("an asynchronous sink") {
+        std::ostringstream out;
+        auto backend = boost::make_shared<logger::AsyncSink>(
+            out, &MessageFormatter,
+            logger::AsyncSinkConfig{.flush_period = 1h}
+        );
+        ScopedSink<AsyncFrontend> sink(backend);
+
+        WHEN("records are logged and the sink is stopped") {
+            for (int i = 0; i < 100; ++i) {
+                BOOST_LOG_TRIVIAL(info) << "record " << i;
+            }
+            backend->Stop();
+
+            THEN("every record is written on its own line in order") {
+                const auto lines = ReadLines(out);
+                REQUIRE(lines.size() == 100);
+                CHECK(lines.front() == "record 0");
+                CHECK(lines.back() == "record 99");
+                CHECK(backend->GetDroppedCount() == 0);
+            }
+
+            AND_WHEN("a record is logged after stop") {
+                BOOST_LOG_TRIVIAL(info) << "late";
+
+                THEN("it is written synchronously") {
+                    CHECK(ReadLines(out).back() == "late");
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Overflow of the record queue", TAG) {
+    std::ostringstream out;
+
+    GIVEN("a full queue with the drop policy") {
+        auto backend = boost::make_shared<logger::AsyncSink>(
+            out, &MessageFormatter,
+            logger::AsyncSinkConfig{
+                .queue_size = 2,
+                .flush_period = 1h,
+                .overflow = logger::OverflowPolicy::drop,
+            }
+        );
+        ScopedSink<AsyncFrontend> sink(backend);
+        // Фоновый поток успевает уснуть до следующего сброса
+        std::this_thread::sleep_for(20ms);
+
+        WHEN("more records are logged than fit into the queue") {
+            for (int i = 0; i < 5; ++i) {
+                BOOST_LOG_TRIVIAL(info) << "record " << i;
+            }
+            backend->Stop();
+
+            THEN("extra records are dropped and counted") {
+                CHECK(backend->GetDroppedCount() == 3);
+                CHECK(ReadLines(out).size() == 2);
+            }
+        }
+    }
+
+    GIVEN("a small queue with the block policy") {
+        auto backend = boost::make_shared<logger::AsyncSink>(
+            out, &MessageFormatter,
+            logger::AsyncSinkConfig{
+                .queue_size = 2,
+                .flush_period = 1h,
+                .overflow = logger::OverflowPolicy::block,
+            }
+        );
+        ScopedSink<AsyncFrontend> sink(backend);
+
+        WHEN("several threads log concurrently") {
+            {
+                std::vector<std::jthread> threads;
+                for (int t = 0; t < 4; ++t) {
+                    threads.emplace_back([] {
+                        for (int i = 0; i < 500; ++i) {
+                            BOOST_LOG_TRIVIAL(info) << "record " << i;
+                        }
+                    });
+                }
+            }
+            backend->Stop();
+
+            THEN("no record is lost") {
+                CHECK(backend->GetDroppedCount() == 0);
+                CHECK(ReadLines(out).size() == 2000);
+            }
+        }
+    }
+}
+
+TEST_CASE("Per-request logging overhead", TAG + "[.][benchmark]") {
+    // Запись в настоящий файл: у /dev/null нет стоимости системного вызова
+    const auto path =
+        std::filesystem::temp_directory_path() / "async_sink_benchmark.log";
+    std::ofstream out(path);
+    const std::string uri = "/api/v1/game/state";
+
+    const auto log_request = [&uri] {
+        BOOST_LOG_TRIVIAL(info)
+            << logging::add_value("URI", uri) << "request received";
+    };
+
+    {
+        // Прежняя настройка: синхронная запись со сбросом каждой записи
+        auto backend = boost::make_shared<sinks::text_ostream_backend>();
+        backend->add_stream(boost::shared_ptr<std::ostream>(&out, [](auto*) {
+        }));
+        backend->auto_flush(true);
+        using SyncFrontend =
+            sinks::synchronous_sink<sinks::text_ostream_backend>;
+        auto frontend = boost::make_shared<SyncFrontend>(backend);
+        frontend->set_formatter(&RequestFormatter);
+        logging::core::get()->add_sink(frontend);
+
+        BENCHMARK("synchronous sink with auto flush") {
+            log_request();
+        };
+
+        logging::core::get()->remove_sink(frontend);
+    }
+
+    {
+        auto backend = boost::make_shared<logger::AsyncSink>(
+            out, &RequestFormatter,
+            logger::AsyncSinkConfig{.overflow = logger::OverflowPolicy::block}
+        );
+        ScopedSink<AsyncFrontend> sink(backend);
+
+        BENCHMARK("asynchronous sink") {
+            log_request();
+        };
+
+        backend->Stop();
+        CHECK(backend->GetDroppedCount() == 0);
+    }
+
+    out.close();
+    std::filesystem::remove(path);
+}
@@ -1,9 +1,11 @@
 #define _USE_MATH_DEFINES
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
 #include <cmath>
 #include <limits>
+#include <random>
 
 #include "model/physics/collision.h"
 
@@ -399,3 +401,91 @@ TEST_CASE("Gatherers with different collection times", TAG) {
     CHECK(events[1].gatherer_id == 2);
     CHECK(events[2].gatherer_id == 0);
 }
+
+namespace {
+
+TestItemGathererProvider MakeRandomProvider(
+    std::mt19937& engine, size_t items_count, size_t gatherers_count,
+    double field_size
+) {
+    std::uniform_real_distribution<double> coord(0.0, field_size);
+    std::uniform_real_distribution<double> item_width(0.0, 0.5);
+    std::uniform_real_distribution<double> step(-3.0, 3.0);
+    std::uniform_int_distribution<int> movement(0, 3);
+
+    TestItemGathererProvider::Items items;
+    for (size_t i = 0; i < items_count; ++i) {
+        items.push_back(Item {
+            .position = Point {coord(engine), coord(engine)},
+            .width = item_width(engine),
+        });
+    }
+
+    TestItemGathererProvider::Gatherers gatherers;
+    for (size_t i = 0; i < gatherers_count; ++i) {
+        const Point start {coord(engine), coord(engine)};
+        Point end = start;
+        switch (movement(engine)) {
+        case 0:
+            end.x += step(engine);
+            break;
+        case 1:
+            end.y += step(engine);
+            break;
+        case 2:
+            end.x += step(engine);
+            end.y += step(engine);
+            break;
+        default:
+            break;
+        }
+        gatherers.push_back(Gatherer {
+            .start_pos = start,
+            .end_pos = end,
+            .width = 0.6,
+        });
+    }
+
+    return TestItemGathererProvider(std::move(items), std::move(gatherers));
+}
+
+} // namespace
+
+TEST_CASE("Broad phase finds the same events as brute force", TAG) {
+    std::mt19937 engine(42);
+
+    for (double field_size : {5.0, 50.0, 500.0}) {
+        for (size_t attempt = 0; attempt < 20; ++attempt) {
+            const auto provider =
+                MakeRandomProvider(engine, 300, 100, field_size);
+
+            const auto expected = FindGatherEventsBruteForce(provider);
+            const auto actual = FindGatherEvents(provider);
+
+            INFO("field size: " << field_size << ", attempt: " << attempt);
+            REQUIRE(actual.size() == expected.size());
+            for (size_t i = 0; i < actual.size(); ++i) {
+                CHECK(actual[i].item_id == expected[i].item_id);
+                CHECK(actual[i].gatherer_id == expected[i].gatherer_id);
+                CHECK(actual[i].sq_distance == expected[i].sq_distance);
+                CHECK(actual[i].time == expected[i].time);
+            }
+        }
+    }
+}
+
+TEST_CASE(
+    "Gather events search with many items and gatherers",
+    TAG + "[.][benchmark]"
+) {
+    std::mt19937 engine(42);
+    const auto provider = MakeRandomProvider(engine, 5000, 5000, 1000.0);
+
+    BENCHMARK("brute force") {
+        return FindGatherEventsBruteForce(provider);
+    };
+
+    BENCHMARK("broad phase") {
+        return FindGatherEvents(provider);
+    };
+}
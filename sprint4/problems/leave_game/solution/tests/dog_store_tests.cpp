@@ -0,0 +1,199 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <boost/asio/io_context.hpp>
+
+#include <random>
+
+#include "model/dog.h"
+#include "model/game_session.h"
+#include "model/map.h"
+
+using namespace model;
+using namespace std::literals;
+
+namespace {
+
+const std::string TAG = "[DogStore]";
+
+} // namespace
+
+SCENARIO("Dog store keeps motion of attached dogs", TAG) {
+    GIVEN("a dog store and a dog") {
+        DogStore store;
+        Dog dog({1, 2}, 3);
+        dog.SetSpeed({1.5, 0});
+        dog.SetLiveTime(10ms);
+
+        WHEN("dog is attached") {
+            store.Attach(dog);
+
+            THEN("dog reads its motion from the store") {
+                REQUIRE(dog.IsAttached());
+                REQUIRE(store.Size() == 1);
+                CHECK(store.GetPosition(0) == Point{1, 2});
+                CHECK(store.GetSpeed(0) == Speed(1.5, 0));
+                CHECK(store.GetLiveTime(0) == 10ms);
+
+                store.SetPosition(0, {3, 2});
+                CHECK(dog.GetPosition() == Point{3, 2});
+                CHECK(dog.GetPrevPosition() == Point{1, 2});
+            }
+
+            AND_WHEN("store integrates movement") {
+                store.Integrate(1000ms);
+
+                THEN("target point and timers are updated") {
+                    CHECK(store.GetTarget(0) == Point{2.5, 2});
+                    CHECK(dog.GetPosition() == Point{1, 2});
+                    CHECK(dog.GetLiveTime() == 1010ms);
+                    CHECK(dog.GetInactiveTime() == 0ms);
+                }
+            }
+
+            AND_WHEN("dog is detached") {
+                dog.SetSpeed({0, 0});
+                store.Integrate(100ms);
+                store.Detach(dog);
+
+                THEN("dog keeps its motion") {
+                    CHECK_FALSE(dog.IsAttached());
+                    CHECK(store.Size() == 0);
+                    CHECK(dog.GetSpeed() == Speed(0, 0));
+                    CHECK(dog.GetLiveTime() == 110ms);
+                    CHECK(dog.GetInactiveTime() == 100ms);
+                }
+            }
+        }
+    }
+
+    GIVEN("several attached dogs") {
+        Dog first({0, 0}, 3);
+        Dog second({1, 0}, 3);
+        Dog third({2, 0}, 3);
+
+        DogStore store;
+        store.Attach(first);
+        store.Attach(second);
+        store.Attach(third);
+
+        WHEN("a dog in the middle is detached") {
+            store.Detach(second);
+
+            THEN("the last dog takes its slot") {
+                REQUIRE(store.Size() == 2);
+                CHECK(&store.GetDog(0) == &first);
+                CHECK(&store.GetDog(1) == &third);
+                CHECK(store.GetSlot(third) == 1);
+                CHECK(third.GetPosition() == Point{2, 0});
+                CHECK(first.GetPosition() == Point{0, 0});
+            }
+        }
+
+        WHEN("the first dog is detached") {
+            store.Detach(first);
+
+            THEN("the last dog moves to the first slot") {
+                REQUIRE(store.Size() == 2);
+                CHECK(&store.GetDog(0) == &third);
+                CHECK(&store.GetDog(1) == &second);
+                CHECK(store.GetSlot(third) == 0);
+                CHECK(store.GetPosition(0) == Point{2, 0});
+                CHECK_FALSE(store.Contains(first));
+            }
+        }
+
+        WHEN("the store is destroyed before the dogs") {
+            auto dog = std::make_shared<Dog>(Point{5, 5}, 3);
+            {
+                DogStore temporary_store;
+                temporary_store.Attach(*dog);
+                temporary_store.SetPosition(0, {6, 5});
+            }
+
+            THEN("dogs are detached with their last motion") {
+                CHECK_FALSE(dog->IsAttached());
+                CHECK(dog->GetPosition() == Point{6, 5});
+            }
+        }
+    }
+
+    GIVEN("a copy of an attached dog") {
+        DogStore store;
+        Dog dog({1, 1}, 3);
+        store.Attach(dog);
+        store.SetPosition(0, {2, 1});
+
+        const Dog copy = dog;
+
+        THEN("copy is detached and has the same motion") {
+            CHECK_FALSE(copy.IsAttached());
+            CHECK(copy.GetPosition() == Point{2, 1});
+            CHECK(copy.GetPrevPosition() == Point{1, 1});
+            CHECK(store.Size() == 1);
+        }
+    }
+}
+
+SCENARIO("Session keeps its dogs in store slots", TAG) {
+    GIVEN("a session with three dogs") {
+        boost::asio::io_context io;
+        Map map(Map::Id("map"s), "Map"s, Map::Config{.dog_speed = 1});
+        map.AddRoad(Road(Road::HORIZONTAL, Point{0, 0}, 100));
+        map.BuildRoadIndex();
+        LootGenerator loot_generator({1s, 0.0});
+        auto session =
+            std::make_shared<GameSession>(io, map, loot_generator, 60s);
+
+        std::vector<DogHolder> dogs;
+        for (size_t i = 0; i < 3; ++i) {
+            dogs.push_back(std::make_shared<Dog>(Point{10.0 * i, 0}, 3));
+            dogs.back()->SetId(Dog::Id(i));
+            session->AddDog(dogs.back());
+        }
+
+        WHEN("the first dog is removed and the last one picks up loot") {
+            session->RemoveDog(dogs[0]);
+            session->AddLostObject(
+                LostObject(LostObject::Id(7), Point{21, 0}, 0, 5)
+            );
+            dogs[2]->SetSpeed(Speed(2.0, Direction::EAST));
+            session->UpdateGameState(1s);
+
+            THEN("the loot goes to the dog that moved") {
+                CHECK(session->GetDogs().size() == 2);
+                CHECK(dogs[2]->GetBag().GetContent().size() == 1);
+                CHECK(dogs[1]->GetBag().GetContent().empty());
+                CHECK_FALSE(dogs[0]->IsAttached());
+            }
+        }
+    }
+}
+
+TEST_CASE("Tick of a session with 10k dogs", TAG + "[.][benchmark]") {
+    constexpr size_t dogs_count = 10'000;
+
+    boost::asio::io_context io;
+    Map map(Map::Id("map"s), "Map"s, Map::Config{});
+    for (Coord offset = 0; offset <= 100; offset += 10) {
+        map.AddRoad(Road(Road::HORIZONTAL, Point{0, offset}, 100));
+        map.AddRoad(Road(Road::VERTICAL, Point{offset, 0}, 100));
+    }
+    map.BuildRoadIndex();
+
+    LootGenerator loot_generator({1s, 0.5});
+    auto session = std::make_shared<GameSession>(io, map, loot_generator, 60s);
+
+    std::mt19937 engine(42);
+    std::uniform_int_distribution<int> direction(
+        Direction::NORTH, Direction::EAST
+    );
+    for (size_t i = 0; i < dogs_count; ++i) {
+        auto dog = session->CreateDog(true);
+        dog->SetSpeed(Speed(1.0, Direction(direction(engine))));
+    }
+
+    BENCHMARK("tick") {
+        session->UpdateGameState(10ms);
+    };
+}
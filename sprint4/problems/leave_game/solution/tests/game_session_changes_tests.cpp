@@ -0,0 +1,192 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <boost/asio/io_context.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "model/game_session.h"
+
+using namespace model;
+using namespace std::literals;
+
+namespace net = boost::asio;
+
+namespace {
+
+const std::string TAG = "[GameSessionChanges]";
+
+Map MakeMap() {
+    Map map(Map::Id("map"), "map", Map::Config{.dog_speed = 1});
+    map.AddRoad(Road(Road::HORIZONTAL, Point{0, 0}, 1000));
+    return map;
+}
+
+DogHolder AddDog(GameSession& session, size_t id, double x) {
+    auto dog = std::make_shared<Dog>(Point{x, 0}, 3);
+    dog->SetId(Dog::Id(id));
+    session.AddDog(dog);
+    return dog;
+}
+
+std::vector<size_t> GetDogIds(const GameSession::Dogs& dogs) {
+    std::vector<size_t> ids;
+    for (const auto& dog : dogs) {
+        ids.push_back(*dog->GetId());
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+template <typename Ids>
+std::vector<size_t> GetIds(const Ids& ids) {
+    std::vector<size_t> result;
+    for (const auto& id : ids) {
+        result.push_back(*id);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // namespace
+
+SCENARIO("Game session reports changes since a tick", TAG) {
+    GIVEN("a session with a standing and a running dog") {
+        net::io_context io;
+        Map map = MakeMap();
+        LootGenerator loot_generator({1s, 0.0});
+        auto session_holder = std::make_shared<GameSession>(
+            io, map, loot_generator, 60s
+        );
+        GameSession& session = *session_holder;
+
+        auto standing = AddDog(session, 1, 0);
+        auto running = AddDog(session, 2, 10);
+        running->SetSpeed(Speed(1.0, Direction::EAST));
+        session.UpdateGameState(100ms);
+        const auto tick = session.GetTick();
+
+        THEN("a new client gets both dogs") {
+            auto changes = session.GetChangesSince(0);
+            REQUIRE(changes);
+            CHECK(changes->tick == tick);
+            CHECK(
+                GetDogIds(changes->changed_dogs) == std::vector<size_t> {1, 2}
+            );
+        }
+
+        WHEN("the game is ticked") {
+            session.UpdateGameState(100ms);
+
+            THEN("only the running dog is reported") {
+                auto changes = session.GetChangesSince(tick);
+                REQUIRE(changes);
+                CHECK(changes->tick == tick + 1);
+                CHECK(
+                    GetDogIds(changes->changed_dogs) ==
+                    std::vector<size_t> {2}
+                );
+                CHECK(changes->removed_dogs.empty());
+            }
+
+            THEN("nothing is reported to an up-to-date client") {
+                auto changes = session.GetChangesSince(tick + 1);
+                REQUIRE(changes);
+                CHECK(changes->changed_dogs.empty());
+            }
+        }
+
+        WHEN("the running dog picks up loot and the standing dog is removed") {
+            LostObject loot(LostObject::Id(100), Point{10.5, 0}, 0, 1);
+            LostObject other(LostObject::Id(101), Point{500, 0}, 0, 1);
+            session.AddLostObject(loot);
+            session.AddLostObject(other);
+            session.UpdateGameState(100ms);
+            const auto loot_tick = session.GetTick();
+            session.UpdateGameState(1s);
+            session.RemoveDog(standing);
+
+            THEN("the loot appears and disappears in the changes") {
+                auto changes = session.GetChangesSince(tick);
+                REQUIRE(changes);
+                CHECK(GetIds(changes->removed_lost_objects) ==
+                      std::vector<size_t> {100});
+                REQUIRE(changes->added_lost_objects.size() == 1);
+                CHECK(*changes->added_lost_objects.front().GetId() == 101);
+                CHECK(GetIds(changes->removed_dogs) == std::vector<size_t> {1});
+            }
+
+            THEN("later clients see only the pickup") {
+                auto changes = session.GetChangesSince(loot_tick);
+                REQUIRE(changes);
+                CHECK(GetIds(changes->removed_lost_objects) ==
+                      std::vector<size_t> {100});
+                CHECK(changes->added_lost_objects.empty());
+            }
+        }
+
+        WHEN("the standing dog is moved by its player") {
+            standing->SetSpeed(Speed(1.0, Direction::WEST));
+            session.MarkDogChanged(*standing);
+
+            THEN("it is reported before the next tick") {
+                auto changes = session.GetChangesSince(tick);
+                REQUIRE(changes);
+                CHECK(changes->tick == tick);
+                CHECK(
+                    GetDogIds(changes->changed_dogs) ==
+                    std::vector<size_t> {1}
+                );
+            }
+        }
+
+        WHEN("the client is too far behind or ahead") {
+            for (size_t i = 0; i <= GameSession::changes_history_size; ++i) {
+                session.UpdateGameState(10ms);
+            }
+
+            THEN("it needs the full state") {
+                CHECK_FALSE(session.GetChangesSince(tick));
+                CHECK_FALSE(session.GetChangesSince(session.GetTick() + 1));
+                CHECK(session.GetChangesSince(session.GetTick() - 1));
+            }
+        }
+    }
+}
+
+TEST_CASE("Game state changes cost", TAG + "[.][benchmark]") {
+    constexpr size_t dogs_count = 2'000;
+    constexpr size_t running_count = 20;
+
+    net::io_context io;
+    Map map = MakeMap();
+    LootGenerator loot_generator({1s, 0.0});
+    auto session_holder =
+        std::make_shared<GameSession>(io, map, loot_generator, 1h);
+    GameSession& session = *session_holder;
+
+    for (size_t i = 0; i < dogs_count; ++i) {
+        auto dog = AddDog(session, i, double(i % 1000));
+        if (i < running_count) {
+            dog->SetSpeed(Speed(0.001, Direction::EAST));
+        }
+    }
+    session.UpdateGameState(1ms);
+
+    // Клиент, получающий состояние после каждого тика, сравнивается с
+    // клиентом, каждый раз получающим всё состояние
+    BENCHMARK("full state") {
+        session.UpdateGameState(1ms);
+        GameSession::Dogs dogs = session.GetDogs();
+        return dogs.size();
+    };
+
+    BENCHMARK("changes since the previous tick") {
+        const auto tick = session.GetTick();
+        session.UpdateGameState(1ms);
+        return session.GetChangesSince(tick)->changed_dogs.size();
+    };
+}
@@ -0,0 +1,304 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <algorithm>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "app/controllers/game_sessions_controller.h"
+#include "model/game.h"
+
+using namespace model;
+using namespace std::literals;
+
+namespace net = boost::asio;
+
+namespace {
+
+const std::string TAG = "[GameSessionsController]";
+
+Game MakeGame(size_t maps_count) {
+    // Без трофеев: на картах нет типов предметов
+    Game game(LootGenerator({1s, 0.0}), 60s);
+    for (size_t i = 0; i < maps_count; ++i) {
+        const std::string id = "map" + std::to_string(i);
+        Map map(Map::Id(id), id, Map::Config{});
+        map.AddRoad(Road(Road::HORIZONTAL, Point{0, 0}, 1000));
+        game.AddMap(std::move(map));
+    }
+    return game;
+}
+
+// Пул потоков, обслуживающий io_context на время теста
+class ThreadPool {
+  public:
+    ThreadPool(net::io_context& io, unsigned threads_count) :
+        io_(io),
+        work_(net::make_work_guard(io)) {
+        for (unsigned i = 0; i < threads_count; ++i) {
+            threads_.emplace_back([&io] {
+                io.run();
+            });
+        }
+    }
+
+    ~ThreadPool() {
+        work_.reset();
+        io_.stop();
+    }
+
+  private:
+    net::io_context& io_;
+    net::executor_work_guard<net::io_context::executor_type> work_;
+    std::vector<std::jthread> threads_;
+};
+
+// Выполняет fn на strand и дожидается завершения
+template <typename Strand, typename Fn>
+void RunOn(Strand& strand, Fn&& fn) {
+    std::promise<void> done;
+    net::post(strand, [&] {
+        fn();
+        done.set_value();
+    });
+    done.get_future().get();
+}
+
+} // namespace
+
+SCENARIO("Game sessions are ticked in parallel", TAG) {
+    constexpr unsigned threads_count = 4;
+    constexpr size_t dogs_per_session = 10;
+
+    GIVEN("several game sessions served by a thread pool") {
+        net::io_context io(threads_count);
+        auto strand = net::make_strand(io);
+        Game game = MakeGame(8);
+        app::GameSessionsController controller(
+            io, strand, game, 60s, threads_count
+        );
+
+        std::vector<DogHolder> dogs;
+        for (const auto& map : game.GetMaps()) {
+            auto session = controller.AddGameSession(map);
+            for (size_t i = 0; i < dogs_per_session; ++i) {
+                auto dog = session->CreateDog(false);
+                dog->SetSpeed(Speed(1.0, Direction::EAST));
+                dogs.push_back(std::move(dog));
+            }
+        }
+
+        ThreadPool pool(io, threads_count);
+
+        WHEN("state is updated from the application strand") {
+            RunOn(strand, [&] {
+                controller.UpdateGameState(500ms);
+            });
+
+            THEN("every session is updated before the call returns") {
+                for (const auto& dog : dogs) {
+                    CHECK(dog->GetPosition() == Point{0.5, 0});
+                    CHECK(dog->GetLiveTime() == 500ms);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Game sessions are ticked inline without a thread pool", TAG) {
+    GIVEN("game sessions and a stopped io_context") {
+        net::io_context io;
+        auto strand = net::make_strand(io);
+        Game game = MakeGame(3);
+        app::GameSessionsController controller(io, strand, game, 60s, 4);
+
+        std::vector<DogHolder> dogs;
+        for (const auto& map : game.GetMaps()) {
+            auto dog = controller.AddGameSession(map)->CreateDog(false);
+            dog->SetSpeed(Speed(1.0, Direction::EAST));
+            dogs.push_back(std::move(dog));
+        }
+        io.stop();
+
+        WHEN("state is updated") {
+            controller.UpdateGameState(1s);
+
+            THEN("sessions are updated on the calling thread") {
+                for (const auto& dog : dogs) {
+                    CHECK(dog->GetPosition() == Point{1, 0});
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Stopping the io_context releases a waiting tick", TAG) {
+    constexpr unsigned threads_count = 3;
+
+    GIVEN("a tick waiting for a session whose strand is busy") {
+        net::io_context io(threads_count);
+        auto strand = net::make_strand(io);
+        Game game = MakeGame(2);
+        app::GameSessionsController controller(
+            io, strand, game, 60s, threads_count
+        );
+        for (const auto& map : game.GetMaps()) {
+            controller.AddGameSession(map);
+        }
+
+        ThreadPool pool(io, threads_count);
+
+        std::promise<void> busy;
+        std::promise<void> release;
+        auto released = release.get_future().share();
+        net::post(controller.GetSessions().front()->GetStrand(), [&] {
+            busy.set_value();
+            released.wait();
+        });
+        busy.get_future().wait();
+
+        // Вторая сессия обновляется, а первая ждёт освобождения strand
+        std::promise<void> second_updated;
+        std::promise<void> tick_done;
+        net::post(strand, [&] {
+            controller.UpdateGameState(1ms, [&](size_t index, auto&) {
+                if (index == 1) {
+                    second_updated.set_value();
+                }
+            });
+            tick_done.set_value();
+        });
+        second_updated.get_future().wait();
+
+        WHEN("the io_context is stopped") {
+            io.stop();
+            controller.Stop();
+            auto tick = tick_done.get_future();
+            const auto status = tick.wait_for(5s);
+            release.set_value();
+
+            THEN("the tick stops waiting for tasks that will never run") {
+                CHECK(status == std::future_status::ready);
+            }
+        }
+    }
+}
+
+SCENARIO("Inactive dogs are retired by the tick", TAG) {
+    constexpr unsigned threads_count = 2;
+
+    GIVEN("sessions with standing and running dogs") {
+        net::io_context io(threads_count);
+        auto strand = net::make_strand(io);
+        Game game = MakeGame(2);
+        app::GameSessionsController controller(
+            io, strand, game, 60s, threads_count
+        );
+
+        std::vector<DogHolder> standing;
+        std::vector<DogHolder> running;
+        for (const auto& map : game.GetMaps()) {
+            auto session = controller.AddGameSession(map);
+            standing.push_back(session->CreateDog(false));
+            auto dog = session->CreateDog(false);
+            dog->SetSpeed(Speed(1.0, Direction::EAST));
+            running.push_back(std::move(dog));
+        }
+
+        ThreadPool pool(io, threads_count);
+
+        WHEN("standing dogs exceed the inactivity limit") {
+            GameSession::Dogs retired;
+            RunOn(strand, [&] {
+                retired = controller.UpdateGameState(60s);
+            });
+
+            THEN("only they are returned and removed from the sessions") {
+                std::sort(retired.begin(), retired.end());
+                std::sort(standing.begin(), standing.end());
+                CHECK(retired == standing);
+
+                for (const auto& dog : standing) {
+                    CHECK_FALSE(dog->IsAttached());
+                }
+                for (const auto& dog : running) {
+                    CHECK(dog->IsAttached());
+                }
+                for (const auto& session : controller.GetSessions()) {
+                    CHECK(session->GetDogs().size() == 1);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Dogs are retired on the tick their inactivity hits the limit", TAG) {
+    GIVEN("a session with two standing dogs and a stopped io_context") {
+        net::io_context io;
+        auto strand = net::make_strand(io);
+        Game game = MakeGame(1);
+        app::GameSessionsController controller(io, strand, game, 60s);
+        auto session = controller.AddGameSession(game.GetMaps().front());
+        auto idle_dog = session->CreateDog(false);
+        auto active_dog = session->CreateDog(false);
+        io.stop();
+
+        WHEN("one of them becomes active halfway through the limit") {
+            std::vector<std::chrono::milliseconds> idle_retired_at;
+            std::vector<std::chrono::milliseconds> active_retired_at;
+            for (auto now = 0s; now < 120s; now += 10s) {
+                if (now == 30s) {
+                    active_dog->SetInactiveTime(0ms);
+                }
+                for (const auto& dog : controller.UpdateGameState(10s)) {
+                    auto& retired_at =
+                        dog == idle_dog ? idle_retired_at : active_retired_at;
+                    retired_at.push_back(now + 10s);
+                }
+            }
+
+            THEN("each dog is retired once, when its own limit is hit") {
+                CHECK(idle_retired_at == std::vector {60000ms});
+                CHECK(active_retired_at == std::vector {90000ms});
+                CHECK(session->GetDogs().empty());
+            }
+        }
+    }
+}
+
+TEST_CASE("Game sessions tick cost against threads", TAG + "[.][benchmark]") {
+    constexpr size_t sessions_count = 16;
+    constexpr size_t dogs_per_session = 2000;
+
+    for (unsigned threads_count : {1u, 2u, 4u, 8u}) {
+        net::io_context io(threads_count);
+        auto strand = net::make_strand(io);
+        Game game = MakeGame(sessions_count);
+        app::GameSessionsController controller(
+            io, strand, game, 60s, threads_count
+        );
+
+        for (const auto& map : game.GetMaps()) {
+            auto session = controller.AddGameSession(map);
+            for (size_t i = 0; i < dogs_per_session; ++i) {
+                auto dog = session->CreateDog(true);
+                dog->SetSpeed(Speed(0.001, Direction::EAST));
+            }
+        }
+
+        ThreadPool pool(io, threads_count);
+
+        BENCHMARK("tick, threads: " + std::to_string(threads_count)) {
+            RunOn(strand, [&] {
+                controller.UpdateGameState(1ms);
+            });
+        };
+    }
+}
@@ -0,0 +1,126 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <boost/asio/io_context.hpp>
+
+#include <memory>
+#include <string>
+
+#include "app/game_state_cache.h"
+
+using namespace model;
+using namespace std::literals;
+
+namespace net = boost::asio;
+
+namespace {
+
+const std::string TAG = "[GameStateCache]";
+
+Map MakeMap() {
+    Map map(Map::Id("map"), "map", Map::Config{});
+    map.AddRoad(Road(Road::HORIZONTAL, Point{0, 0}, 1000));
+    return map;
+}
+
+// Упрощённая отрисовка состояния: координаты всех собак сессии
+std::string RenderState(const GameSession& session) {
+    std::string result;
+    for (const auto& dog : session.GetDogs()) {
+        const Point position = dog->GetPosition();
+        result += std::to_string(position.x) + ',' +
+                  std::to_string(position.y) + ';';
+    }
+    return result;
+}
+
+} // namespace
+
+SCENARIO("Game state cache", TAG) {
+    GIVEN("a session and a cache") {
+        net::io_context io;
+        Map map = MakeMap();
+        LootGenerator loot_generator({1s, 0.0});
+        auto session =
+            std::make_shared<GameSession>(io, map, loot_generator, 60s);
+        auto dog = session->CreateDog(false);
+        app::GameStateCache cache;
+
+        auto& registry = metrics::Registry::Instance();
+        auto& hits = registry.GetCounter("game_state_cache_hits");
+        auto& misses = registry.GetCounter("game_state_cache_misses");
+        const auto initial_hits = hits.Get();
+        const auto initial_misses = misses.Get();
+
+        size_t renders_count = 0;
+        const auto render = [&] {
+            ++renders_count;
+            return RenderState(*session);
+        };
+
+        auto body = cache.Get(*session, render);
+
+        WHEN("the state is requested again") {
+            auto other_body = cache.Get(*session, render);
+
+            THEN("the same body is shared without rendering") {
+                CHECK(other_body == body);
+                CHECK(renders_count == 1);
+                CHECK(hits.Get() == initial_hits + 1);
+                CHECK(misses.Get() == initial_misses + 1);
+            }
+        }
+
+        WHEN("the session is ticked") {
+            dog->SetSpeed(Speed(1.0, Direction::EAST));
+            session->UpdateGameState(1s);
+            auto other_body = cache.Get(*session, render);
+
+            THEN("the state is rendered again") {
+                CHECK(other_body != body);
+                CHECK(*other_body != *body);
+                CHECK(renders_count == 2);
+            }
+        }
+
+        WHEN("a dog is changed or the owner marks the state changed") {
+            session->MarkDogChanged(*dog);
+            cache.Get(*session, render);
+            session->MarkStateChanged();
+            cache.Get(*session, render);
+
+            THEN("each change leads to a new render") {
+                CHECK(renders_count == 3);
+                CHECK(misses.Get() == initial_misses + 3);
+            }
+        }
+    }
+}
+
+TEST_CASE("Game state cost per request", TAG + "[.][benchmark]") {
+    constexpr size_t dogs_count = 100;
+
+    net::io_context io;
+    Map map = MakeMap();
+    LootGenerator loot_generator({1s, 0.0});
+    auto session = std::make_shared<GameSession>(io, map, loot_generator, 60s);
+    for (size_t i = 0; i < dogs_count; ++i) {
+        session->CreateDog(true);
+    }
+    app::GameStateCache cache;
+
+    BENCHMARK("render per request") {
+        return RenderState(*session).size();
+    };
+
+    BENCHMARK("cached render") {
+        return cache
+            .Get(
+                *session,
+                [&] {
+                    return RenderState(*session);
+                }
+            )
+            ->size();
+    };
+}
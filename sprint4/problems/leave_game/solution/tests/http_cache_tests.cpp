@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <zlib.h>
+
+#include <string>
+
+#include "web/http_cache.h"
+
+namespace {
+
+const std::string TAG = "[HttpCache]";
+
+std::string GzipDecompress(const std::string& data) {
+    z_stream stream {};
+    inflateInit2(&stream, 15 + 16);
+
+    std::string result(data.size() * 20 + 64, '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(result.data());
+    stream.avail_out = static_cast<uInt>(result.size());
+
+    const int status = inflate(&stream, Z_FINISH);
+    result.resize(stream.total_out);
+    inflateEnd(&stream);
+
+    REQUIRE(status == Z_STREAM_END);
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("If-None-Match is compared with the ETag", TAG) {
+    const std::string etag = web::MakeStrongETag("body");
+
+    CHECK(etag.size() == 18);
+    CHECK(etag.front() == '"');
+    CHECK(etag.back() == '"');
+    CHECK(etag != web::MakeStrongETag("body2"));
+
+    CHECK(web::IsETagMatched(etag, etag));
+    CHECK(web::IsETagMatched("\"other\", " + etag, etag));
+    CHECK(web::IsETagMatched("W/" + etag, etag));
+    CHECK(web::IsETagMatched("*", etag));
+    CHECK_FALSE(web::IsETagMatched("\"other\"", etag));
+    CHECK_FALSE(web::IsETagMatched("", etag));
+}
+
+TEST_CASE("Accept-Encoding is parsed with weights", TAG) {
+    CHECK(web::IsEncodingAccepted("gzip", "gzip"));
+    CHECK(web::IsEncodingAccepted("deflate, GZIP;q=0.5", "gzip"));
+    CHECK(web::IsEncodingAccepted("br, gzip ; q=1", "gzip"));
+    CHECK_FALSE(web::IsEncodingAccepted("gzip;q=0", "gzip"));
+    CHECK_FALSE(web::IsEncodingAccepted("gzip;q=0.000", "gzip"));
+    CHECK_FALSE(web::IsEncodingAccepted("deflate, br", "gzip"));
+    CHECK_FALSE(web::IsEncodingAccepted("", "gzip"));
+}
+
+TEST_CASE("Precomputed body keeps a gzip copy", TAG) {
+    std::string content;
+    for (int i = 0; i < 1000; ++i) {
+        content += R"({"x":)" + std::to_string(i) + "},";
+    }
+
+    const auto payload = web::PrecomputedBody::Make(content);
+
+    CHECK(*payload.body == content);
+    CHECK(payload.gzip_body->size() < content.size());
+    CHECK(GzipDecompress(*payload.gzip_body) == content);
+    CHECK(payload.etag == web::MakeStrongETag(content));
+    CHECK(payload.gzip_etag != payload.etag);
+
+    const auto small_payload = web::PrecomputedBody::Make("{}");
+    CHECK(*small_payload.body == "{}");
+    CHECK_FALSE(small_payload.gzip_body);
+}
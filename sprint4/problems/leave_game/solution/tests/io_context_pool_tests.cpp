@@ -0,0 +1,82 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <boost/asio/post.hpp>
+
+#include <future>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "utils/thread.h"
+#include "web/io_context_pool.h"
+
+namespace net = boost::asio;
+
+namespace {
+
+const std::string TAG = "[IoContextPool]";
+
+} // namespace
+
+SCENARIO("Each io_context of the pool runs on its own thread", TAG) {
+    GIVEN("a started pool over the available cores") {
+        const auto cores = utils::GetAvailableCores();
+        REQUIRE_FALSE(cores.empty());
+
+        web::IoContextPool pool;
+        REQUIRE(pool.GetSize() == cores.size());
+        pool.Start();
+
+        WHEN("a handler is posted to every io_context") {
+            std::set<std::thread::id> threads;
+            for (size_t i = 0; i < pool.GetSize(); ++i) {
+                std::promise<std::thread::id> promise;
+                auto future = promise.get_future();
+                net::post(pool.Get(i), [&promise] {
+                    promise.set_value(std::this_thread::get_id());
+                });
+                threads.insert(future.get());
+            }
+
+            THEN("handlers run on different threads") {
+                CHECK(threads.size() == pool.GetSize());
+                CHECK_FALSE(threads.contains(std::this_thread::get_id()));
+            }
+        }
+
+        WHEN("the pool is idle") {
+            THEN("it keeps running until stopped") {
+                CHECK_FALSE(pool.Get(0).stopped());
+                pool.Stop();
+                CHECK(pool.Get(0).stopped());
+            }
+        }
+    }
+}
+
+SCENARIO("Pinned workers run one thread per core", TAG) {
+    GIVEN("the cores available for workers") {
+        const auto cores = utils::GetWorkerCores();
+        REQUIRE_FALSE(cores.empty());
+
+        WHEN("workers are run on them") {
+            // Вызывающий поток тоже закрепляется, поэтому это не поток теста
+            std::mutex mutex;
+            std::set<std::thread::id> threads;
+            std::thread::id caller;
+            std::jthread([&] {
+                caller = std::this_thread::get_id();
+                utils::RunPinnedWorkers(cores, [&] {
+                    std::lock_guard lock(mutex);
+                    threads.insert(std::this_thread::get_id());
+                });
+            }).join();
+
+            THEN("every core gets its own thread, the caller included") {
+                CHECK(threads.size() == cores.size());
+                CHECK(threads.contains(caller));
+            }
+        }
+    }
+}
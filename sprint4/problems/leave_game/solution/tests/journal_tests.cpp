@@ -0,0 +1,461 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <boost/asio/io_context.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "app/journal.h"
+#include "model/game_session.h"
+#include "serde/journal.h"
+
+using namespace model;
+using namespace std::literals;
+
+namespace fs = std::filesystem;
+namespace net = boost::asio;
+namespace journal = serde::journal;
+
+namespace {
+
+const std::string TAG = "[Journal]";
+
+Map MakeMap() {
+    Map map(Map::Id("map"), "map", Map::Config{.dog_speed = 1});
+    map.AddRoad(Road(Road::HORIZONTAL, Point{0, 0}, 1000));
+    return map;
+}
+
+// Каталог для файлов состояния, удаляемый в конце теста
+struct TempDirectory {
+    TempDirectory() {
+        fs::remove_all(path);
+        fs::create_directories(path);
+    }
+
+    ~TempDirectory() {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+
+    fs::path path = fs::temp_directory_path() / "journal_tests";
+};
+
+// Сессия с собаками на остановленном io_context
+struct Session {
+    explicit Session(size_t dogs_count) {
+        io.stop();
+        for (size_t i = 0; i < dogs_count; ++i) {
+            auto dog = std::make_shared<Dog>(Point{10.0 * i, 0}, 3);
+            dog->SetId(Dog::Id(i));
+            session->AddDog(dog);
+        }
+    }
+
+    net::io_context io;
+    Map map = MakeMap();
+    LootGenerator loot_generator {{1s, 0.0}};
+    GameSessionHolder session =
+        std::make_shared<GameSession>(io, map, loot_generator, 60s);
+};
+
+std::string EncodeMove(size_t player) {
+    std::string data;
+    journal::EncodeMove(data, app::Token(player, ~player), Direction::EAST);
+    return data;
+}
+
+// Номера записей журнала и игроки из записей о движении
+std::vector<std::pair<uint64_t, uint64_t>>
+ReadMoves(const fs::path& state_file, uint64_t position) {
+    std::vector<std::pair<uint64_t, uint64_t>> moves;
+    journal::ReadJournal(
+        state_file, position,
+        [&](uint64_t number, std::string_view data) {
+            const auto record = journal::DecodeRecord(data);
+            const auto& move = std::get<journal::MoveRecord>(record);
+            moves.emplace_back(number, move.token.GetHigh());
+        }
+    );
+    return moves;
+}
+
+} // namespace
+
+SCENARIO("Session ticks are replayed from the journal", TAG) {
+    GIVEN("a session and its copy taken before a tick") {
+        Session source(3);
+        Session copy(3);
+
+        auto& dogs = source.session->GetDogs();
+        dogs[0]->SetSpeed(Speed(1.0, Direction::EAST));
+        dogs[0]->GetBag().Add(LostObject(LostObject::Id(7), {1, 0}, 1, 5));
+        dogs[0]->SetScore(3);
+        source.session->AddLostObject(
+            LostObject(LostObject::Id(42), Point{500, 0}, 0, 10)
+        );
+        source.session->UpdateGameState(1s);
+
+        WHEN("the tick result is encoded, decoded and applied twice") {
+            const auto changes = source.session->GetChangesSince(
+                source.session->GetTick() - 1
+            );
+            REQUIRE(changes);
+            std::string data;
+            journal::EncodeSessionTick(data, *source.session, *changes);
+
+            auto record = std::get<journal::SessionTickRecord>(
+                journal::DecodeRecord(data)
+            );
+            CHECK(*record.map_id == "map");
+            for (int i = 0; i < 2; ++i) {
+                copy.session->ApplyChanges(
+                    record.changed_dogs, record.removed_dogs,
+                    record.added_lost_objects, record.removed_lost_objects
+                );
+            }
+
+            THEN("the copy matches the session") {
+                const auto& restored = copy.session->GetDogs();
+                REQUIRE(restored.size() == dogs.size());
+                for (size_t i = 0; i < dogs.size(); ++i) {
+                    CHECK(restored[i]->GetPosition() == dogs[i]->GetPosition());
+                    CHECK(
+                        restored[i]->GetPrevPosition() ==
+                        dogs[i]->GetPrevPosition()
+                    );
+                    CHECK(restored[i]->GetSpeed() == dogs[i]->GetSpeed());
+                    CHECK(restored[i]->GetScore() == dogs[i]->GetScore());
+                    CHECK(
+                        restored[i]->GetBag().GetContent() ==
+                        dogs[i]->GetBag().GetContent()
+                    );
+                }
+                CHECK(
+                    copy.session->GetLostObjects() ==
+                    source.session->GetLostObjects()
+                );
+            }
+        }
+
+        WHEN("a dog is retired and a lost object is picked up") {
+            const std::vector<Dog::Id> removed_dogs {Dog::Id(1)};
+            const std::vector<LostObject::Id> removed_lost_objects {
+                LostObject::Id(42)
+            };
+            copy.session->AddLostObject(
+                LostObject(LostObject::Id(42), Point{500, 0}, 0, 10)
+            );
+            const auto retired = copy.session->ApplyChanges(
+                {}, removed_dogs, {}, removed_lost_objects
+            );
+
+            THEN("they are removed once") {
+                REQUIRE(retired.size() == 1);
+                CHECK(*retired.front()->GetId() == 1);
+                CHECK(copy.session->GetDogs().size() == 2);
+                CHECK(copy.session->GetLostObjects().empty());
+                const auto retired_again = copy.session->ApplyChanges(
+                    {}, removed_dogs, {}, removed_lost_objects
+                );
+                CHECK(retired_again.empty());
+            }
+        }
+    }
+}
+
+TEST_CASE("Join and move records keep player data", TAG) {
+    Session session(0);
+    app::Player player(app::Player::Id(5), "Rex");
+    player.SetGameSession(session.session);
+    player.SetDog(std::make_shared<Dog>(Point{3, 0}, 4));
+    const app::Token token(1, 2);
+
+    std::string data;
+    journal::EncodeJoin(data, token, player);
+    const auto join =
+        std::get<journal::JoinRecord>(journal::DecodeRecord(data));
+    CHECK(join.token == token);
+    CHECK(join.player_id == player.GetId());
+    CHECK(join.name == "Rex");
+    CHECK(*join.map_id == "map");
+    CHECK(join.dog.GetPosition() == Point{3, 0});
+    CHECK(join.dog.GetBag().Capacity() == 4);
+
+    const auto move =
+        std::get<journal::MoveRecord>(journal::DecodeRecord(EncodeMove(9)));
+    CHECK(move.token == app::Token(9, ~9ull));
+    CHECK(move.direction == Direction::EAST);
+
+    CHECK_THROWS_AS(
+        journal::DecodeRecord(data.substr(0, data.size() - 1)),
+        serde::snapshot::SnapshotError
+    );
+}
+
+SCENARIO("Journal segments follow snapshots", TAG) {
+    GIVEN("a journal with committed records") {
+        TempDirectory directory;
+        const fs::path state_file = directory.path / "state";
+        uint64_t position = 0;
+        {
+            app::Journal writer(state_file, 1, 1h);
+            for (size_t i = 1; i <= 3; ++i) {
+                writer.Append([i](std::string& out) {
+                    out += EncodeMove(i);
+                });
+            }
+            position = writer.Rotate();
+            writer.Append([](std::string& out) {
+                out += EncodeMove(4);
+            });
+            writer.Flush();
+
+            THEN("records are read back in order") {
+                CHECK(position == 3);
+                CHECK(journal::ListSegments(state_file).size() == 2);
+                CHECK(
+                    ReadMoves(state_file, 0) ==
+                    std::vector<std::pair<uint64_t, uint64_t>> {
+                        {1, 1}, {2, 2}, {3, 3}, {4, 4}
+                    }
+                );
+            }
+
+            WHEN("a snapshot covers the first segment") {
+                writer.Discard(position);
+                writer.Flush();
+
+                THEN("only later records remain") {
+                    const auto segments = journal::ListSegments(state_file);
+                    REQUIRE(segments.size() == 1);
+                    CHECK(segments.front().start == 4);
+                    CHECK(
+                        ReadMoves(state_file, position) ==
+                        std::vector<std::pair<uint64_t, uint64_t>> {{4, 4}}
+                    );
+                }
+            }
+        }
+
+        WHEN("the last record is torn by a crash") {
+            const auto segment = journal::ListSegments(state_file).back();
+            fs::resize_file(segment.path, fs::file_size(segment.path) - 1);
+
+            THEN("reading stops before it") {
+                CHECK(
+                    ReadMoves(state_file, 0) ==
+                    std::vector<std::pair<uint64_t, uint64_t>> {
+                        {1, 1}, {2, 2}, {3, 3}
+                    }
+                );
+            }
+
+            THEN("a reopened journal continues after the intact records") {
+                const uint64_t last =
+                    journal::ReadJournal(state_file, 0, [](auto, auto) {});
+                CHECK(last == 3);
+                {
+                    app::Journal writer(state_file, last + 1, 1h);
+                    writer.Append([](std::string& out) {
+                        out += EncodeMove(5);
+                    });
+                }
+                CHECK(
+                    ReadMoves(state_file, 2) ==
+                    std::vector<std::pair<uint64_t, uint64_t>> {
+                        {3, 3}, {4, 5}
+                    }
+                );
+            }
+        }
+    }
+}
+
+SCENARIO("Records after a gap in the journal are discarded", TAG) {
+    GIVEN("a journal whose middle segment is lost") {
+        TempDirectory directory;
+        const fs::path state_file = directory.path / "state";
+        {
+            app::Journal writer(state_file, 1, 1h);
+            for (size_t i = 1; i <= 6; ++i) {
+                writer.Append([i](std::string& out) {
+                    out += EncodeMove(i);
+                });
+                if (i == 3 || i == 5) {
+                    writer.Rotate();
+                }
+            }
+        }
+        REQUIRE(journal::ListSegments(state_file).size() == 3);
+        fs::remove(journal::GetSegmentPath(state_file, 4));
+
+        WHEN("the journal is read and reopened") {
+            const uint64_t last =
+                journal::ReadJournal(state_file, 0, [](auto, auto) {});
+            {
+                app::Journal writer(state_file, last + 1, 1h);
+                writer.Append([](std::string& out) {
+                    out += EncodeMove(7);
+                });
+            }
+
+            THEN("numbering continues after the last applied record") {
+                CHECK(last == 3);
+                CHECK(
+                    ReadMoves(state_file, 0) ==
+                    std::vector<std::pair<uint64_t, uint64_t>> {
+                        {1, 1}, {2, 2}, {3, 3}, {4, 7}
+                    }
+                );
+            }
+        }
+    }
+}
+
+SCENARIO("A failed journal commit requests a snapshot", TAG) {
+    GIVEN("a journal whose directory disappears") {
+        TempDirectory directory;
+        const fs::path state_file = directory.path / "state";
+        app::Journal writer(state_file, 1, 1h);
+        fs::remove_all(directory.path);
+
+        writer.Append([](std::string& out) {
+            out += EncodeMove(1);
+        });
+        writer.Flush();
+        REQUIRE(writer.HasFailed());
+
+        WHEN("the directory comes back") {
+            fs::create_directories(directory.path);
+            writer.Append([](std::string& out) {
+                out += EncodeMove(2);
+            });
+            writer.Flush();
+
+            THEN("the failed segment is not continued") {
+                CHECK(writer.HasFailed());
+                CHECK(journal::ListSegments(state_file).empty());
+            }
+
+            AND_WHEN("a snapshot rotates the journal") {
+                CHECK(writer.Rotate() == 2);
+                writer.Append([](std::string& out) {
+                    out += EncodeMove(3);
+                });
+                writer.Flush();
+
+                THEN("records after the snapshot are written again") {
+                    CHECK_FALSE(writer.HasFailed());
+                    CHECK(
+                        ReadMoves(state_file, 2) ==
+                        std::vector<std::pair<uint64_t, uint64_t>> {{3, 3}}
+                    );
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Journal size is counted from the last rotation", TAG) {
+    TempDirectory directory;
+    app::Journal writer(directory.path / "state", 1, 1h);
+    CHECK(writer.GetSizeSinceRotate() == 0);
+
+    for (size_t i = 1; i <= 3; ++i) {
+        writer.Append([i](std::string& out) {
+            out += EncodeMove(i);
+        });
+    }
+    CHECK(writer.GetSizeSinceRotate() == 3 * EncodeMove(1).size());
+
+    writer.Rotate();
+    CHECK(writer.GetSizeSinceRotate() == 0);
+    writer.Append([](std::string& out) {
+        out += EncodeMove(4);
+    });
+    CHECK(writer.GetSizeSinceRotate() == EncodeMove(4).size());
+}
+
+TEST_CASE("Journal throughput and replay", TAG + "[.][benchmark]") {
+    TempDirectory directory;
+    const fs::path state_file = directory.path / "state";
+
+    // Сессия из 2000 собак, все из которых двигаются
+    Session source(2000);
+    for (const auto& dog : source.session->GetDogs()) {
+        dog->SetSpeed(Speed(1.0, Direction::EAST));
+    }
+    source.session->UpdateGameState(10ms);
+    const auto changes =
+        source.session->GetChangesSince(source.session->GetTick() - 1);
+    std::string tick;
+    journal::EncodeSessionTick(tick, *source.session, *changes);
+    const std::string move = EncodeMove(1);
+
+    constexpr size_t moves_count = 100'000;
+    constexpr size_t ticks_count = 200;
+
+    BENCHMARK("append 100000 moves with 10ms group commit") {
+        fs::remove_all(directory.path);
+        fs::create_directories(directory.path);
+        app::Journal writer(state_file, 1, 10ms);
+        for (size_t i = 0; i < moves_count; ++i) {
+            writer.Append([&](std::string& out) {
+                out += move;
+            });
+        }
+        writer.Flush();
+    };
+
+    BENCHMARK("append 1000 moves with a commit per record") {
+        fs::remove_all(directory.path);
+        fs::create_directories(directory.path);
+        app::Journal writer(state_file, 1, 10ms);
+        for (size_t i = 0; i < moves_count / 100; ++i) {
+            writer.Append([&](std::string& out) {
+                out += move;
+            });
+            writer.Flush();
+        }
+    };
+
+    fs::remove_all(directory.path);
+    fs::create_directories(directory.path);
+    {
+        app::Journal writer(state_file, 1, 10ms);
+        for (size_t i = 0; i < ticks_count; ++i) {
+            writer.Append([&](std::string& out) {
+                out += tick;
+            });
+        }
+    }
+    WARN(
+        "journal of " << ticks_count << " ticks of 2000 moving dogs: "
+                      << fs::file_size(journal::ListSegments(state_file)
+                                           .front()
+                                           .path)
+                      << " bytes"
+    );
+
+    Session replica(2000);
+    BENCHMARK("replay 200 ticks of 2000 moving dogs") {
+        return journal::ReadJournal(
+            state_file, 0,
+            [&](uint64_t, std::string_view data) {
+                auto record = std::get<journal::SessionTickRecord>(
+                    journal::DecodeRecord(data)
+                );
+                replica.session->ApplyChanges(
+                    record.changed_dogs, record.removed_dogs,
+                    record.added_lost_objects, record.removed_lost_objects
+                );
+            }
+        );
+    };
+}
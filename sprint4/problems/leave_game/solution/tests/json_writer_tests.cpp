@@ -0,0 +1,153 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/json/serialize.hpp>
+#include <boost/json/value.hpp>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "serde/json.h"
+#include "serde/json_writer.h"
+
+using namespace std::literals;
+
+namespace json = boost::json;
+namespace net = boost::asio;
+
+namespace {
+
+const std::string TAG = "[JsonWriter]";
+
+std::string Write(auto&& fn) {
+    std::string output;
+    serde::json::Writer writer(output);
+    fn(writer);
+    return output;
+}
+
+} // namespace
+
+TEST_CASE("Json writer separates and nests values", TAG) {
+    const auto output = Write([](serde::json::Writer& writer) {
+        writer.BeginObject();
+        writer.Key("ids"sv);
+        writer.BeginArray();
+        writer.Number(1);
+        writer.Number(size_t(2));
+        writer.BeginObject();
+        writer.EndObject();
+        writer.EndArray();
+        writer.Key(42);
+        writer.Bool(false);
+        writer.Key("empty"sv);
+        writer.BeginArray();
+        writer.EndArray();
+        writer.Key("null"sv);
+        writer.Null();
+        writer.EndObject();
+    });
+
+    CHECK(output == R"({"ids":[1,2,{}],"42":false,"empty":[],"null":null})");
+}
+
+TEST_CASE("Json writer escapes strings", TAG) {
+    const auto output = Write([](serde::json::Writer& writer) {
+        writer.String("a\"b\\c\n\t\x01 Бобик"s);
+    });
+
+    CHECK(output == R"("a\"b\\c\n\t\u0001 Бобик")");
+}
+
+TEST_CASE("Json writer keeps doubles real and exact", TAG) {
+    const auto write_number = [](double value) {
+        return Write([&](serde::json::Writer& writer) {
+            writer.Number(value);
+        });
+    };
+
+    CHECK(write_number(1.0) == "1.0");
+    CHECK(write_number(-0.5) == "-0.5");
+    CHECK(write_number(0.1) == "0.1");
+    CHECK(write_number(1e21) == "1e+21");
+    CHECK(std::stod(write_number(2.0 / 3.0)) == 2.0 / 3.0);
+}
+
+TEST_CASE("Json writer writes non-finite doubles as null", TAG) {
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+    const auto output = Write([&](serde::json::Writer& writer) {
+        writer.BeginArray();
+        writer.Number(infinity);
+        writer.Number(-infinity);
+        writer.Number(std::numeric_limits<double>::quiet_NaN());
+        writer.Number(1.5);
+        writer.EndArray();
+    });
+
+    CHECK(output == "[null,null,null,1.5]");
+}
+
+TEST_CASE("Game state writing cost", TAG + "[.][benchmark]") {
+    constexpr size_t players_count = 100;
+
+    net::io_context io;
+    model::Map map(model::Map::Id("map"), "map", model::Map::Config{});
+    map.AddRoad(
+        model::Road(model::Road::HORIZONTAL, model::Point{0, 0}, 1000)
+    );
+    model::LootGenerator loot_generator({1s, 0.0});
+    auto session =
+        std::make_shared<model::GameSession>(io, map, loot_generator, 60s);
+
+    app::Application::Players players;
+    model::GameSession::LostObjects lost_objects;
+    for (size_t i = 0; i < players_count; ++i) {
+        auto player = std::make_shared<app::Player>(
+            app::Player::Id(i), "player" + std::to_string(i)
+        );
+        auto dog = session->CreateDog(true);
+        dog->SetSpeed(model::Speed(1.0, model::Direction::EAST));
+        player->SetDog(std::move(dog));
+        players.push_back(std::move(player));
+        lost_objects.emplace_back(model::Point{double(i), 0}, i % 3, 10);
+    }
+
+    // Прежний способ: дерево json::value и его сериализация
+    BENCHMARK("json::value tree") {
+        json::object players_object;
+        for (const auto& player : players) {
+            const auto& dog = player->GetDog();
+            const auto position = dog->GetPosition();
+            const auto speed = dog->GetSpeed();
+            players_object[std::to_string(*player->GetId())] = json::object{
+                {"pos", json::array{position.x, position.y}},
+                {"speed", json::array{speed.x, speed.y}},
+                {"dir", "R"},
+                {"bag", json::array{}},
+                {"score", dog->GetScore()},
+            };
+        }
+
+        json::object lost_objects_object;
+        for (const auto& lost_object : lost_objects) {
+            const auto position = lost_object.GetPosition();
+            lost_objects_object[std::to_string(*lost_object.GetId())] =
+                json::object{
+                    {"type", lost_object.GetType()},
+                    {"pos", json::array{position.x, position.y}},
+                };
+        }
+
+        return json::serialize(json::object{
+            {"players", std::move(players_object)},
+            {"lostObjects", std::move(lost_objects_object)},
+        });
+    };
+
+    BENCHMARK("streaming writer") {
+        return serde::json::WriteGameState(players, lost_objects);
+    };
+}
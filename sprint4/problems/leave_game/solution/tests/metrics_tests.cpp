@@ -0,0 +1,80 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "metrics/metrics.h"
+
+using namespace std::literals;
+
+namespace {
+
+const std::string TAG = "[Metrics]";
+
+} // namespace
+
+SCENARIO("Duration statistics", TAG) {
+    GIVEN("a duration statistic") {
+        metrics::DurationStat stat;
+
+        WHEN("durations are recorded") {
+            stat.Record(3ms);
+            stat.Record(5ms);
+            stat.Record(1ms);
+
+            THEN("count, total, max and last value are kept") {
+                const auto snapshot = stat.GetSnapshot();
+                CHECK(snapshot.count == 3);
+                CHECK(snapshot.total == 9ms);
+                CHECK(snapshot.max == 5ms);
+                CHECK(snapshot.last == 1ms);
+            }
+        }
+
+        WHEN("durations are recorded from several threads") {
+            {
+                std::vector<std::jthread> threads;
+                for (int i = 1; i <= 4; ++i) {
+                    threads.emplace_back([&stat, i] {
+                        for (int j = 0; j < 1000; ++j) {
+                            stat.Record(std::chrono::microseconds(i));
+                        }
+                    });
+                }
+            }
+
+            THEN("no record is lost") {
+                const auto snapshot = stat.GetSnapshot();
+                CHECK(snapshot.count == 4000);
+                CHECK(snapshot.total == 10ms);
+                CHECK(snapshot.max == 4us);
+            }
+        }
+    }
+}
+
+SCENARIO("Metrics registry", TAG) {
+    GIVEN("the process registry") {
+        auto& registry = metrics::Registry::Instance();
+
+        WHEN("a metric is requested twice by the same name") {
+            auto& counter = registry.GetCounter("test.registry.counter");
+            const uint64_t initial = counter.Get();
+            counter.Increment(2);
+            registry.GetCounter("test.registry.counter").Increment();
+
+            THEN("the same metric is returned and collected") {
+                CHECK(counter.Get() == initial + 3);
+
+                const auto snapshot = registry.Collect();
+                CHECK(std::count(
+                    snapshot.counters.begin(), snapshot.counters.end(),
+                    std::pair<std::string, uint64_t>{
+                        "test.registry.counter", initial + 3
+                    }
+                ) == 1);
+            }
+        }
+    }
+}
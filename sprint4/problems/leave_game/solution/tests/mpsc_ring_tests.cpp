@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/mpsc_ring.h"
+
+namespace {
+
+const std::string TAG = "[MpscRing]";
+
+} // namespace
+
+SCENARIO("Values pass through the ring in order", TAG) {
+    GIVEN("a ring with capacity rounded up to a power of two") {
+        utils::MpscRing<std::string> ring(3);
+        REQUIRE(ring.GetCapacity() == 4);
+
+        WHEN("the ring is filled") {
+            for (int i = 0; i < 4; ++i) {
+                REQUIRE(ring.TryPush(std::to_string(i)));
+            }
+
+            THEN("the next value is rejected and left intact") {
+                std::string value = "rejected";
+                CHECK_FALSE(ring.TryPush(std::move(value)));
+                CHECK(value == "rejected");
+            }
+
+            THEN("values are popped in order and free their cells") {
+                for (int i = 0; i < 4; ++i) {
+                    CHECK(ring.TryPop() == std::to_string(i));
+                }
+                CHECK_FALSE(ring.TryPop());
+                CHECK(ring.TryPush("next"));
+                CHECK(ring.TryPop() == "next");
+            }
+        }
+    }
+}
+
+TEST_CASE("Values of every producer are delivered exactly once", TAG) {
+    constexpr int producers = 4;
+    constexpr int per_producer = 50'000;
+    utils::MpscRing<int> ring(256);
+
+    std::vector<int> last(producers, -1);
+    int received = 0;
+    bool in_order = true;
+    {
+        std::vector<std::jthread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&ring, p] {
+                for (int i = 0; i < per_producer; ++i) {
+                    while (!ring.TryPush(p * per_producer + i)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        while (received < producers * per_producer) {
+            const auto value = ring.TryPop();
+            if (!value) {
+                std::this_thread::yield();
+                continue;
+            }
+            const int producer = *value / per_producer;
+            in_order = in_order && *value % per_producer > last[producer];
+            last[producer] = *value % per_producer;
+            ++received;
+        }
+    }
+
+    CHECK(in_order);
+    CHECK_FALSE(ring.TryPop());
+    for (int p = 0; p < producers; ++p) {
+        CHECK(last[p] == per_producer - 1);
+    }
+}
@@ -0,0 +1,85 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <pqxx/connection>
+#include <pqxx/transaction>
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "postgres/consts.h"
+#include "postgres/database.h"
+#include "postgres/player_record.h"
+
+using namespace std::literals;
+
+namespace {
+
+const std::string TAG = "[PlayerRecords]";
+
+std::vector<app::PlayerRecord> MakeRecords(size_t count) {
+    std::vector<app::PlayerRecord> records;
+    for (size_t i = 0; i < count; ++i) {
+        records.emplace_back(
+            "player \"" + std::to_string(i) + "\"", i % 1000,
+            std::chrono::milliseconds(i)
+        );
+    }
+    return records;
+}
+
+} // namespace
+
+// Нужна база данных: адрес берётся из переменной окружения GAME_DB_URL.
+// Записи делаются в транзакциях, которые не фиксируются. Рекордов в
+// секунду - размер пакета, делённый на время замера
+TEST_CASE("Hall of fame batch writes", TAG + "[.][benchmark]") {
+    const char* url = std::getenv(postgres::db_url.c_str());
+    if (!url) {
+        WARN(postgres::db_url << " is not set");
+        return;
+    }
+
+    postgres::Database database(postgres::DatabaseConfig {.url = url});
+    pqxx::connection connection(url);
+
+    const auto count_rows = [&](pqxx::work& work) {
+        return work.query_value<size_t>("SELECT count(*) FROM hall_of_fame;");
+    };
+
+    for (const size_t batch_size : {10, 100, 1000, 10000}) {
+        const auto records = MakeRecords(batch_size);
+        const std::string suffix = " x" + std::to_string(batch_size);
+
+        {
+            pqxx::work work(connection);
+            postgres::PlayerRecordRepositoryImpl repository(work);
+            const size_t before = count_rows(work);
+            repository.InsertRows(records);
+            repository.CopyRows(records);
+            CHECK(count_rows(work) == before + 2 * batch_size);
+        }
+
+        BENCHMARK("INSERT per row" + suffix) {
+            pqxx::work work(connection);
+            postgres::PlayerRecordRepositoryImpl repository(work);
+            for (const auto& record : records) {
+                repository.Save(record);
+            }
+        };
+
+        BENCHMARK("INSERT with unnest" + suffix) {
+            pqxx::work work(connection);
+            postgres::PlayerRecordRepositoryImpl repository(work);
+            repository.InsertRows(records);
+        };
+
+        BENCHMARK("COPY" + suffix) {
+            pqxx::work work(connection);
+            postgres::PlayerRecordRepositoryImpl repository(work);
+            repository.CopyRows(records);
+        };
+    }
+}
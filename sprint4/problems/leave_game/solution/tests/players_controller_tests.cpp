@@ -0,0 +1,215 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <boost/asio/io_context.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "app/controllers/player_controller.h"
+#include "model/loot_generator.h"
+#include "model/map.h"
+#include "utils/epoch.h"
+#include "utils/random.h"
+
+using namespace app;
+using namespace std::literals;
+
+namespace net = boost::asio;
+
+namespace {
+
+const std::string TAG = "[PlayersController]";
+
+// Сессии на отдельных картах, в которые добавляются игроки с собаками
+class Fixture {
+  public:
+    explicit Fixture(size_t sessions_count) {
+        maps_.reserve(sessions_count);
+        for (size_t i = 0; i < sessions_count; ++i) {
+            const std::string id = "map" + std::to_string(i);
+            auto& map = maps_.emplace_back(
+                model::Map::Id(id), id, model::Map::Config {}
+            );
+            map.AddRoad(model::Road(
+                model::Road::HORIZONTAL, model::Point {0, 0}, 1000
+            ));
+            sessions_.push_back(std::make_shared<model::GameSession>(
+                io_, map, loot_generator_, 60s
+            ));
+        }
+    }
+
+    // Удалённые из таблицы токенов игроки удерживаются utils::epoch и
+    // ссылаются на сессии, поэтому освобождаются раньше них
+    ~Fixture() {
+        players_.reset();
+        for (int i = 0; i < 3; ++i) {
+            utils::epoch::Collect();
+        }
+    }
+
+    PlayersController& Players() {
+        return *players_;
+    }
+
+    PlayerHolder AddPlayer(size_t session_index) {
+        const auto& session = sessions_[session_index];
+        auto player = std::make_shared<Player>(
+            players_->GetFreePlayerId(), "player"
+        );
+        player->SetGameSession(session);
+        player->SetDog(session->MakeDog(false, engine_));
+        tokens_.push_back(players_->AddPlayer(player));
+        return player;
+    }
+
+    const Token& GetToken(size_t index) const {
+        return tokens_[index];
+    }
+
+  private:
+    net::io_context io_;
+    model::LootGenerator loot_generator_ {{1s, 0.0}};
+    utils::RandomEngine engine_ {0};
+    std::vector<model::Map> maps_;
+    std::vector<model::GameSessionHolder> sessions_;
+    std::vector<Token> tokens_;
+    std::unique_ptr<PlayersController> players_ =
+        std::make_unique<PlayersController>();
+};
+
+bool Contains(const Players& players, const PlayerHolder& player) {
+    return std::find(players.begin(), players.end(), player) !=
+        players.end();
+}
+
+} // namespace
+
+SCENARIO("Players are found and removed by their dogs", TAG) {
+    GIVEN("players in two sessions") {
+        Fixture fixture(2);
+        auto& controller = fixture.Players();
+        std::vector<PlayerHolder> players;
+        for (size_t i = 0; i < 6; ++i) {
+            players.push_back(fixture.AddPlayer(i % 2));
+        }
+
+        THEN("every player is found by its dog") {
+            for (const auto& player : players) {
+                CHECK(controller.GetPlayerByDog(player->GetDog()) == player);
+            }
+            CHECK(controller.GetPlayers(fixture.GetToken(0)).size() == 3);
+        }
+
+        WHEN("some players are removed by their dogs") {
+            const auto removed = controller.RemovePlayersByDogs({
+                players[0]->GetDog(),
+                players[3]->GetDog(),
+                players[4]->GetDog(),
+            });
+
+            THEN("only they are removed") {
+                CHECK(removed.size() == 3);
+                for (size_t i = 0; i < players.size(); ++i) {
+                    INFO("player index: " << i);
+                    const bool is_removed = i == 0 || i == 3 || i == 4;
+                    const auto& dog = players[i]->GetDog();
+                    CHECK(
+                        (controller.GetPlayerByDog(dog) == nullptr) ==
+                        is_removed
+                    );
+                    CHECK(
+                        controller.HasPlayer(fixture.GetToken(i)) ==
+                        !is_removed
+                    );
+                }
+            }
+
+            THEN("session lists contain the remaining players") {
+                const auto first = controller.GetPlayers(
+                    fixture.GetToken(2)
+                );
+                CHECK(first.size() == 1);
+                CHECK(Contains(first, players[2]));
+
+                const auto second = controller.GetPlayers(
+                    fixture.GetToken(1)
+                );
+                CHECK(second.size() == 2);
+                CHECK(Contains(second, players[1]));
+                CHECK(Contains(second, players[5]));
+            }
+
+            AND_WHEN("the moved players are removed too") {
+                controller.RemovePlayersByDogs({players[5]->GetDog()});
+
+                THEN("their session list stays consistent") {
+                    const auto second = controller.GetPlayers(
+                        fixture.GetToken(1)
+                    );
+                    CHECK(second.size() == 1);
+                    CHECK(Contains(second, players[1]));
+                }
+            }
+        }
+
+        WHEN("an unknown dog is removed") {
+            const auto removed = controller.RemovePlayersByDogs({
+                std::make_shared<model::Dog>(
+                    model::Point {0, 0}, model::Speed(0, 0),
+                    model::Direction::NORTH, 3
+                ),
+            });
+
+            THEN("nothing is removed") {
+                CHECK(removed.empty());
+                CHECK(controller.GetPlayers(fixture.GetToken(0)).size() == 3);
+            }
+        }
+    }
+}
+
+TEST_CASE("Retiring players among many", TAG + "[.][benchmark]") {
+    constexpr size_t players_count = 50'000;
+    constexpr size_t retired_count = 16;
+
+    BENCHMARK_ADVANCED("remove by dogs")(
+        Catch::Benchmark::Chronometer meter
+    ) {
+        Fixture fixture(4);
+        auto& controller = fixture.Players();
+        std::vector<PlayerHolder> players;
+        for (size_t i = 0; i < players_count; ++i) {
+            players.push_back(fixture.AddPlayer(i % 4));
+        }
+
+        std::vector<model::GameSession::Dogs> batches(meter.runs());
+        for (size_t run = 0; run < batches.size(); ++run) {
+            for (size_t i = 0; i < retired_count; ++i) {
+                const size_t index = (run * retired_count + i) % players_count;
+                batches[run].push_back(players[index]->GetDog());
+            }
+        }
+
+        meter.measure([&](int run) {
+            return controller.RemovePlayersByDogs(batches[run]).size();
+        });
+    };
+
+    BENCHMARK_ADVANCED("find by dog")(Catch::Benchmark::Chronometer meter) {
+        Fixture fixture(4);
+        auto& controller = fixture.Players();
+        std::vector<PlayerHolder> players;
+        for (size_t i = 0; i < players_count; ++i) {
+            players.push_back(fixture.AddPlayer(i % 4));
+        }
+
+        meter.measure([&](int run) {
+            const auto& dog = players[run % players_count]->GetDog();
+            return controller.GetPlayerByDog(dog) != nullptr;
+        });
+    };
+}
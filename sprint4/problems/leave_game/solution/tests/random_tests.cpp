@@ -0,0 +1,137 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <boost/asio/io_context.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "model/game_session.h"
+#include "utils/random.h"
+
+using namespace std::literals;
+
+namespace {
+
+const std::string TAG = "[Random]";
+
+std::vector<double> GenerateSequence(uint64_t stream, size_t count) {
+    utils::RandomEngine engine(utils::MakeRandomSeed(stream));
+    std::vector<double> result;
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(utils::GenerateRandomNumber(engine, 0.0, 1.0));
+    }
+    return result;
+}
+
+// Точки появления собак сессии с засевом seed, созданных в другом потоке
+std::vector<model::Point> MakeSpawnPoints(uint64_t seed, size_t count) {
+    boost::asio::io_context io;
+    model::Map map(model::Map::Id("map"), "map", model::Map::Config {});
+    map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, 0}, 100));
+    map.AddRoad(model::Road(model::Road::VERTICAL, {0, 0}, 100));
+    model::LootGenerator loot_generator({1s, 0.0});
+    auto session = std::make_shared<model::GameSession>(
+        io, map, loot_generator, 60s, seed
+    );
+
+    std::vector<model::Point> points;
+    std::thread([&] {
+        for (size_t i = 0; i < count; ++i) {
+            points.push_back(session->CreateDog(true)->GetPosition());
+        }
+    }).join();
+    return points;
+}
+
+} // namespace
+
+TEST_CASE("Random numbers stay within the requested range", TAG) {
+    utils::RandomEngine engine(utils::MakeRandomSeed(0));
+    for (int i = 0; i < 10'000; ++i) {
+        const auto integer = utils::GenerateRandomNumber<int>(engine, -3, 3);
+        CHECK((integer >= -3 && integer <= 3));
+
+        const auto real = utils::GenerateRandomNumber<double>(engine, 2.5, 4.0);
+        CHECK((real >= 2.5 && real < 4.0));
+    }
+
+    CHECK(utils::GenerateRandomNumber<size_t>(engine, 7, 7) == 7);
+    CHECK(utils::GenerateRandomNumber<double>(engine, 1.0, 1.0) == 1.0);
+}
+
+SCENARIO("Seeded random generators are reproducible", TAG) {
+    GIVEN("a random seed") {
+        utils::SetRandomSeed(42);
+        const auto first = GenerateSequence(1, 100);
+
+        WHEN("the same seed is set again") {
+            utils::SetRandomSeed(42);
+
+            THEN("the same numbers are generated") {
+                CHECK(GenerateSequence(1, 100) == first);
+            }
+        }
+
+        WHEN("another seed is set") {
+            utils::SetRandomSeed(43);
+
+            THEN("other numbers are generated") {
+                CHECK(GenerateSequence(1, 100) != first);
+            }
+        }
+
+        WHEN("another stream is used") {
+            THEN("other numbers are generated") {
+                CHECK(GenerateSequence(2, 100) != first);
+            }
+        }
+
+        WHEN("numbers are generated in a batch") {
+            utils::RandomEngine engine(utils::MakeRandomSeed(1));
+            std::vector<double> batch(100);
+            utils::GenerateRandomNumbers<double>(engine, 0.0, 1.0, batch);
+
+            THEN("they match the ones generated one by one") {
+                CHECK(batch == first);
+            }
+        }
+    }
+
+    GIVEN("two sessions with the same seed") {
+        const uint64_t seed = 7;
+
+        WHEN("their dogs are spawned by different threads") {
+            const auto first = MakeSpawnPoints(seed, 20);
+            const auto second = MakeSpawnPoints(seed, 20);
+
+            THEN("the dogs appear at the same points") {
+                CHECK(first == second);
+                CHECK(MakeSpawnPoints(seed + 1, 20) != first);
+            }
+        }
+    }
+}
+
+TEST_CASE("Random number generation cost", TAG + "[.][benchmark]") {
+    BENCHMARK("random_device + default_random_engine per call") {
+        std::random_device device;
+        std::default_random_engine engine(device());
+        return std::uniform_real_distribution<double>(0.0, 100.0)(engine);
+    };
+
+    utils::RandomEngine engine(utils::MakeRandomSeed(0));
+    BENCHMARK("xoshiro256**") {
+        return utils::GenerateRandomNumber<double>(engine, 0.0, 100.0);
+    };
+
+    std::vector<size_t> batch(1024);
+    BENCHMARK("xoshiro256**, batch of 1024") {
+        utils::GenerateRandomNumbers<size_t>(engine, 0, 9, batch);
+        return batch.back();
+    };
+}
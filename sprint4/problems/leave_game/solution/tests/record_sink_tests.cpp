@@ -0,0 +1,155 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "app/record_sink.h"
+
+using namespace std::literals;
+
+namespace {
+
+const std::string TAG = "[RecordSink]";
+
+// Запоминает размеры записанных пакетов. Первые failures попыток записи
+// завершаются ошибкой. Пока закрыта, запись ждёт открытия
+class FakeUseCases : public app::UseCases {
+  public:
+    explicit FakeUseCases(size_t failures = 0) : failures_(failures) {}
+
+    void SavePlayerRecords(const std::vector<app::PlayerRecord>& records
+    ) override {
+        std::unique_lock lock(mutex_);
+        is_writing_ = true;
+        changed_.notify_all();
+        changed_.wait(lock, [this] {
+            return is_open_;
+        });
+        if (failures_ != 0) {
+            --failures_;
+            throw std::runtime_error("Database is unavailable");
+        }
+        batches_.push_back(records.size());
+    }
+
+    std::vector<app::PlayerRecord>
+    GetPlayerRecords(size_t, size_t) override {
+        return {};
+    }
+
+    void Close() {
+        std::lock_guard lock(mutex_);
+        is_open_ = false;
+    }
+
+    void Open() {
+        std::lock_guard lock(mutex_);
+        is_open_ = true;
+        changed_.notify_all();
+    }
+
+    // Дожидается начала записи
+    void WaitWriting() {
+        std::unique_lock lock(mutex_);
+        changed_.wait(lock, [this] {
+            return is_writing_;
+        });
+    }
+
+    std::vector<size_t> GetBatches() {
+        std::lock_guard lock(mutex_);
+        return batches_;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    size_t failures_;
+    bool is_open_ = true;
+    bool is_writing_ = false;
+    std::vector<size_t> batches_;
+};
+
+std::vector<app::PlayerRecord> MakeRecords(size_t count) {
+    return std::vector<app::PlayerRecord>(
+        count, app::PlayerRecord("player", 10, 1s)
+    );
+}
+
+uint64_t GetDropped() {
+    return metrics::Registry::Instance()
+        .GetCounter("player_records_dropped")
+        .Get();
+}
+
+} // namespace
+
+SCENARIO("Player records are written in batches", TAG) {
+    GIVEN("a sink whose database is busy with the first batch") {
+        FakeUseCases use_cases;
+        use_cases.Close();
+        app::RecordSink sink(use_cases, {.queue_size = 10, .max_batch = 4});
+        sink.Enqueue(MakeRecords(1));
+        use_cases.WaitWriting();
+
+        WHEN("more records are enqueued meanwhile") {
+            sink.Enqueue(MakeRecords(3));
+            sink.Enqueue(MakeRecords(3));
+            use_cases.Open();
+            sink.Flush();
+
+            THEN("they are written in batches of at most max_batch") {
+                CHECK(use_cases.GetBatches() == std::vector<size_t> {1, 4, 2});
+            }
+        }
+
+        WHEN("the queue overflows") {
+            const uint64_t dropped = GetDropped();
+            sink.Enqueue(MakeRecords(8));
+            sink.Enqueue(MakeRecords(4));
+            use_cases.Open();
+            sink.Flush();
+
+            THEN("records that do not fit are dropped") {
+                CHECK(GetDropped() == dropped + 2);
+                CHECK(
+                    use_cases.GetBatches() == std::vector<size_t> {1, 4, 4, 2}
+                );
+            }
+        }
+    }
+}
+
+SCENARIO("Failed writes are retried", TAG) {
+    const app::RecordSinkConfig config {
+        .max_attempts = 3,
+        .retry_delay = 1ms,
+    };
+
+    GIVEN("a database that recovers after two failures") {
+        FakeUseCases use_cases(2);
+        app::RecordSink sink(use_cases, config);
+        sink.Enqueue(MakeRecords(5));
+        sink.Flush();
+
+        THEN("the batch is written by the third attempt") {
+            CHECK(use_cases.GetBatches() == std::vector<size_t> {5});
+        }
+    }
+
+    GIVEN("a database that stays unavailable") {
+        FakeUseCases use_cases(3);
+        app::RecordSink sink(use_cases, config);
+        const uint64_t dropped = GetDropped();
+        sink.Enqueue(MakeRecords(5));
+        sink.Flush();
+
+        THEN("the batch is dropped after the last attempt") {
+            CHECK(use_cases.GetBatches().empty());
+            CHECK(GetDropped() == dropped + 5);
+        }
+    }
+}
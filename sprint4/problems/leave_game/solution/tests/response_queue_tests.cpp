@@ -0,0 +1,145 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <boost/beast/core/buffers_to_string.hpp>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "web/response_queue.h"
+
+namespace http = web::http;
+
+namespace {
+
+const std::string TAG = "[ResponseQueue]";
+
+web::StringResponse MakeStringResponse(
+    const std::string& body, bool keep_alive = true
+) {
+    web::StringResponse res(http::status::ok, 11);
+    res.set(http::field::content_type, "text/plain");
+    res.body() = body;
+    res.prepare_payload();
+    res.keep_alive(keep_alive);
+    return res;
+}
+
+web::SharedStringResponse MakeSharedResponse(const std::string& body) {
+    web::SharedStringResponse res(http::status::ok, 11);
+    res.body() = std::make_shared<const std::string>(body);
+    res.content_length(body.size());
+    res.keep_alive(true);
+    return res;
+}
+
+// Тело, которое нельзя отправить готовыми буферами
+http::response<http::vector_body<char>> MakeVectorResponse() {
+    http::response<http::vector_body<char>> res(http::status::ok, 11);
+    res.body() = {'a', 'b'};
+    res.prepare_payload();
+    res.keep_alive(true);
+    return res;
+}
+
+template <typename Response>
+std::string Serialize(const Response& res) {
+    std::ostringstream out;
+    out << res;
+    return out.str();
+}
+
+std::string Concat(const std::vector<web::net::const_buffer>& buffers) {
+    return web::beast::buffers_to_string(buffers);
+}
+
+} // namespace
+
+SCENARIO("Pipelined responses are sent in request order", TAG) {
+    GIVEN("a queue with three requests") {
+        web::ResponseQueue queue(16);
+        const size_t first = queue.Reserve();
+        const size_t second = queue.Reserve();
+        const size_t third = queue.Reserve();
+        CHECK(queue.GetPendingCount() == 3);
+
+        WHEN("later responses are ready before the first one") {
+            auto res2 = MakeSharedResponse("second");
+            auto res3 = MakeStringResponse("third");
+            const std::string expected = Serialize(res2) + Serialize(res3);
+            queue.Put(third, web::MakePendingResponse(std::move(res3)));
+            queue.Put(second, web::MakePendingResponse(std::move(res2)));
+
+            THEN("nothing is sent") {
+                CHECK(queue.TakeReady().IsEmpty());
+                CHECK(queue.GetPendingCount() == 3);
+            }
+
+            AND_WHEN("the first response is ready") {
+                auto res1 = MakeStringResponse("first");
+                const std::string expected_all = Serialize(res1) + expected;
+                queue.Put(first, web::MakePendingResponse(std::move(res1)));
+                auto batch = queue.TakeReady();
+
+                THEN("all responses are sent in one write") {
+                    CHECK(batch.responses.size() == 3);
+                    CHECK(Concat(batch.buffers) == expected_all);
+                    CHECK_FALSE(batch.close);
+                    CHECK(queue.GetPendingCount() == 0);
+                    CHECK(queue.TakeReady().IsEmpty());
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Response batches are limited", TAG) {
+    web::ResponseQueue queue(2);
+    for (int i = 0; i < 3; ++i) {
+        queue.Put(
+            queue.Reserve(),
+            web::MakePendingResponse(MakeStringResponse(std::to_string(i)))
+        );
+    }
+
+    CHECK(queue.TakeReady().responses.size() == 2);
+    CHECK(queue.TakeReady().responses.size() == 1);
+    CHECK(queue.TakeReady().IsEmpty());
+}
+
+TEST_CASE("Closing response ends the batch", TAG) {
+    web::ResponseQueue queue(16);
+    queue.Put(
+        queue.Reserve(),
+        web::MakePendingResponse(MakeStringResponse("bye", false))
+    );
+    queue.Put(
+        queue.Reserve(), web::MakePendingResponse(MakeStringResponse("next"))
+    );
+
+    auto batch = queue.TakeReady();
+    CHECK(batch.responses.size() == 1);
+    CHECK(batch.close);
+}
+
+TEST_CASE("Responses without buffers are written separately", TAG) {
+    web::ResponseQueue queue(16);
+    queue.Put(
+        queue.Reserve(), web::MakePendingResponse(MakeStringResponse("1"))
+    );
+    queue.Put(queue.Reserve(), web::MakePendingResponse(MakeVectorResponse()));
+    queue.Put(
+        queue.Reserve(), web::MakePendingResponse(MakeStringResponse("3"))
+    );
+
+    auto first = queue.TakeReady();
+    CHECK(first.responses.size() == 1);
+    CHECK_FALSE(first.buffers.empty());
+
+    auto second = queue.TakeReady();
+    CHECK(second.responses.size() == 1);
+    CHECK(second.buffers.empty());
+
+    CHECK(queue.TakeReady().responses.size() == 1);
+}
@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <boost/asio/io_context.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "model/game_session.h"
+#include "model/map.h"
+
+using namespace model;
+using namespace std::literals;
+
+namespace {
+
+const std::string TAG = "[RoadIndex]";
+
+// Сетка из пересекающихся горизонтальных и вертикальных дорог
+Map MakeTownMap(size_t roads_count, bool build_index = true) {
+    Map map(Map::Id("town"s), "Town"s, Map::Config{});
+
+    const size_t lines = std::max<size_t>(1, roads_count / 2);
+    const Coord step = 10;
+    const Coord length = step * static_cast<Coord>(lines);
+
+    for (size_t i = 0; i < lines; ++i) {
+        const Coord offset = step * static_cast<Coord>(i);
+        map.AddRoad(Road(Road::HORIZONTAL, Point{0, offset}, length));
+        map.AddRoad(Road(Road::VERTICAL, Point{offset, 0}, length));
+    }
+
+    if (build_index) {
+        map.BuildRoadIndex();
+    }
+    return map;
+}
+
+std::vector<const Road*> FindRoadsBruteForce(const Map& map, Point point) {
+    std::vector<const Road*> result;
+    for (const auto& road : map.GetRoads()) {
+        if (road.Contains(point)) {
+            result.push_back(&road);
+        }
+    }
+    return result;
+}
+
+std::vector<const Road*> FindRoadsWithIndex(const Map& map, Point point) {
+    std::vector<const Road*> result;
+    map.ForEachRoadContaining(point, [&](const Road& road) {
+        result.push_back(&road);
+    });
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Road index finds the same roads as a linear scan", TAG) {
+    const Map map = MakeTownMap(40);
+
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<double> coord(-5.0, 205.0);
+
+    for (size_t i = 0; i < 10'000; ++i) {
+        const Point point{coord(engine), coord(engine)};
+        INFO("point: " << point.x << ", " << point.y);
+        CHECK(FindRoadsWithIndex(map, point) == FindRoadsBruteForce(map, point));
+    }
+}
+
+TEST_CASE("Road index handles points on road bounds", TAG) {
+    const Map map = MakeTownMap(4);
+
+    for (const auto& road : map.GetRoads()) {
+        for (const Point& point :
+             {road.GetStart(), road.GetEnd(), road.GetLeftBottomCorner(),
+              road.GetRightTopCorner()}) {
+            CHECK(
+                FindRoadsWithIndex(map, point) ==
+                FindRoadsBruteForce(map, point)
+            );
+        }
+    }
+}
+
+TEST_CASE("Map without road index falls back to a linear scan", TAG) {
+    const Map map = MakeTownMap(10, false);
+    const Point point{10, 0};
+
+    CHECK(FindRoadsWithIndex(map, point) == FindRoadsBruteForce(map, point));
+    CHECK(FindRoadsWithIndex(map, point).size() == 2);
+}
+
+TEST_CASE("Game session tick cost against road count", TAG + "[.][benchmark]") {
+    constexpr size_t dogs_count = 1000;
+
+    for (size_t roads_count : {10, 100, 1000, 10'000}) {
+        boost::asio::io_context io;
+        const Map map = MakeTownMap(roads_count);
+        LootGenerator loot_generator({1s, 0.5});
+        auto session =
+            std::make_shared<GameSession>(io, map, loot_generator, 60s);
+
+        std::mt19937 engine(42);
+        std::uniform_int_distribution<int> direction(
+            Direction::NORTH, Direction::EAST
+        );
+        for (size_t i = 0; i < dogs_count; ++i) {
+            auto dog = session->CreateDog(true);
+            dog->SetSpeed(Speed(1.0, Direction(direction(engine))));
+        }
+
+        BENCHMARK("tick, roads: " + std::to_string(roads_count)) {
+            session->UpdateGameState(10ms);
+        };
+    }
+}
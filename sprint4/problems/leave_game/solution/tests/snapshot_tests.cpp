@@ -0,0 +1,281 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "app/controllers/game_sessions_controller.h"
+#include "model/game.h"
+#include "serde/archive.h"
+#include "serde/snapshot.h"
+
+using namespace model;
+using namespace std::literals;
+
+namespace fs = std::filesystem;
+namespace net = boost::asio;
+namespace snapshot = serde::snapshot;
+
+namespace {
+
+const std::string TAG = "[Snapshot]";
+
+Game MakeGame(size_t maps_count) {
+    Game game(LootGenerator({1s, 0.0}), 60s);
+    for (size_t i = 0; i < maps_count; ++i) {
+        const std::string id = "map" + std::to_string(i);
+        Map map(Map::Id(id), id, Map::Config{});
+        map.AddRoad(Road(Road::HORIZONTAL, Point{0, 0}, 1000));
+        game.AddMap(std::move(map));
+    }
+    return game;
+}
+
+// Сессии с игроками, собаками и предметами на остановленном io_context
+struct World {
+    World(size_t maps_count, size_t players_per_session) :
+        game(MakeGame(maps_count)),
+        sessions(io, strand, game, 60s, 1) {
+        io.stop();
+
+        size_t player_id = 0;
+        for (const auto& map : game.GetMaps()) {
+            auto session = sessions.AddGameSession(map);
+            auto& players = session_players.emplace_back();
+            for (size_t i = 0; i < players_per_session; ++i, ++player_id) {
+                session->AddLostObject(LostObject(
+                    LostObject::Id(player_id), Point{0.5 * i, 0}, i % 3, 10
+                ));
+
+                auto dog = session->CreateDog(false);
+                dog->SetSpeed(Speed(1.5, Direction::EAST));
+                dog->SetDirection(Direction::EAST);
+                dog->SetScore(player_id);
+                dog->GetBag().Add(LostObject(
+                    LostObject::Id(1'000'000 + player_id), Point{1, 0}, 1, 5
+                ));
+
+                auto player = std::make_shared<app::Player>(
+                    app::Player::Id(player_id),
+                    "player " + std::to_string(player_id)
+                );
+                player->SetGameSession(session);
+                player->SetDog(std::move(dog));
+                players.emplace_back(
+                    app::Token(player_id, ~player_id), std::move(player)
+                );
+            }
+        }
+    }
+
+    std::vector<std::string> Encode() const {
+        std::vector<std::string> sections;
+        const auto& game_sessions = sessions.GetSessions();
+        for (size_t i = 0; i < game_sessions.size(); ++i) {
+            snapshot::EncodeSession(
+                sections.emplace_back(), *game_sessions[i], session_players[i]
+            );
+        }
+        return sections;
+    }
+
+    net::io_context io;
+    net::strand<net::io_context::executor_type> strand =
+        net::make_strand(io);
+    Game game;
+    app::GameSessionsController sessions;
+    std::vector<snapshot::SessionPlayers> session_players;
+};
+
+// Временный файл, удаляемый в конце теста
+struct TempFile {
+    ~TempFile() {
+        std::error_code ec;
+        fs::remove(path, ec);
+    }
+
+    fs::path path = fs::temp_directory_path() / "snapshot_tests.bin";
+};
+
+} // namespace
+
+SCENARIO("Game sessions survive a binary snapshot", TAG) {
+    GIVEN("sessions with players, dogs and lost objects") {
+        World world(2, 3);
+        TempFile file;
+
+        WHEN("the snapshot is written and mapped back") {
+            snapshot::WriteSnapshot(file.path, world.Encode());
+            const auto mapped = snapshot::MappedSnapshot::Open(file.path);
+
+            THEN("every session is restored") {
+                REQUIRE(mapped);
+                REQUIRE(mapped->GetSessions().size() == 2);
+
+                const auto state =
+                    snapshot::DecodeSession(mapped->GetSessions()[1]);
+                CHECK(*state.map_id == "map1");
+                CHECK(
+                    state.lost_objects ==
+                    world.sessions.GetSessions()[1]->GetLostObjects()
+                );
+
+                REQUIRE(state.players.size() == 3);
+                const auto& [token, player] = world.session_players[1][2];
+                const auto& restored = state.players[2];
+                CHECK(restored.id == player->GetId());
+                CHECK(restored.name == player->GetName());
+                CHECK(restored.token == token);
+
+                const Dog& dog = *player->GetDog();
+                CHECK(restored.dog.GetPosition() == dog.GetPosition());
+                CHECK(restored.dog.GetPrevPosition() == dog.GetPrevPosition());
+                CHECK(restored.dog.GetSpeed() == dog.GetSpeed());
+                CHECK(restored.dog.GetDirection() == dog.GetDirection());
+                CHECK(restored.dog.GetScore() == dog.GetScore());
+                CHECK(
+                    restored.dog.GetBag().GetContent() ==
+                    dog.GetBag().GetContent()
+                );
+                CHECK(
+                    restored.dog.GetBag().Capacity() == dog.GetBag().Capacity()
+                );
+            }
+        }
+
+        WHEN("a byte of a section is damaged") {
+            snapshot::WriteSnapshot(file.path, world.Encode());
+            {
+                std::fstream stream(
+                    file.path, std::ios::in | std::ios::out | std::ios::binary
+                );
+                stream.seekp(-1, std::ios::end);
+                stream.put('\x7f');
+            }
+
+            THEN("the checksum mismatch is reported") {
+                CHECK_THROWS_AS(
+                    snapshot::MappedSnapshot::Open(file.path),
+                    snapshot::SnapshotError
+                );
+            }
+        }
+    }
+
+    GIVEN("a file that is not a binary snapshot") {
+        TempFile file;
+        std::ofstream(file.path) << "22 serialization::archive 19";
+
+        THEN("it is left to the text archive") {
+            CHECK_FALSE(snapshot::MappedSnapshot::Open(file.path));
+            CHECK_FALSE(snapshot::MappedSnapshot::Open(file.path / "missing"));
+        }
+    }
+}
+
+TEST_CASE("Truncated section data is rejected", TAG) {
+    std::string data;
+    snapshot::Encoder encoder(data);
+    encoder.PutString("map1");
+    encoder.PutVarint(300);
+
+    snapshot::Decoder decoder(data);
+    CHECK(decoder.GetString() == "map1");
+    CHECK(decoder.GetVarint() == 300);
+    CHECK(decoder.IsEmpty());
+    CHECK_THROWS_AS(decoder.GetDouble(), snapshot::SnapshotError);
+    CHECK_THROWS_AS(
+        snapshot::DecodeSession(data.substr(0, 3)), snapshot::SnapshotError
+    );
+}
+
+TEST_CASE("Game state save and restore", TAG + "[.][benchmark]") {
+    using namespace serde::archive;
+
+    World world(8, 2000);
+    TempFile text_file;
+    TempFile binary_file;
+    text_file.path += ".txt";
+
+    const auto save_text = [&] {
+        std::vector<GameSessionRepr> game_sessions;
+        std::vector<PlayerRepr> players;
+        for (const auto& session : world.sessions.GetSessions()) {
+            game_sessions.emplace_back(*session);
+        }
+        for (const auto& session_players : world.session_players) {
+            for (const auto& [token, player] : session_players) {
+                players.emplace_back(*player, token);
+            }
+        }
+        std::ofstream output(text_file.path);
+        boost::archive::text_oarchive oarchive{output};
+        oarchive << game_sessions;
+        oarchive << players;
+    };
+
+    std::vector<std::string> sections;
+    const auto save_binary = [&] {
+        const auto& game_sessions = world.sessions.GetSessions();
+        sections.resize(game_sessions.size());
+        for (size_t i = 0; i < game_sessions.size(); ++i) {
+            sections[i].clear();
+            snapshot::EncodeSession(
+                sections[i], *game_sessions[i], world.session_players[i]
+            );
+        }
+        snapshot::WriteSnapshot(binary_file.path, sections);
+    };
+
+    save_text();
+    save_binary();
+    WARN(
+        "state file size: " << fs::file_size(text_file.path)
+                            << " bytes as text archive, "
+                            << fs::file_size(binary_file.path)
+                            << " bytes as binary snapshot"
+    );
+
+    BENCHMARK("save text archive") {
+        save_text();
+    };
+
+    BENCHMARK("save binary snapshot") {
+        save_binary();
+    };
+
+    BENCHMARK("restore text archive") {
+        std::ifstream input(text_file.path);
+        boost::archive::text_iarchive iarchive{input};
+        std::vector<GameSessionRepr> game_sessions;
+        std::vector<PlayerRepr> players;
+        iarchive >> game_sessions;
+        iarchive >> players;
+
+        size_t dogs = 0;
+        for (const auto& player : players) {
+            dogs += player.RestoreDog().GetBag().Size();
+        }
+        return dogs;
+    };
+
+    BENCHMARK("restore binary snapshot") {
+        const auto mapped = snapshot::MappedSnapshot::Open(binary_file.path);
+        size_t dogs = 0;
+        for (const auto section : mapped->GetSessions()) {
+            const auto state = snapshot::DecodeSession(section);
+            for (const auto& player : state.players) {
+                dogs += player.dog.GetBag().Size();
+            }
+        }
+        return dogs;
+    };
+}
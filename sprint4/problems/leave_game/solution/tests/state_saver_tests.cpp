@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "app/state_saver.h"
+
+using namespace std::literals;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const std::string TAG = "[StateSaver]";
+
+using Clock = app::StateSaver::Clock;
+
+// Каталог для файлов состояния, удаляемый в конце теста
+struct TempDirectory {
+    TempDirectory() {
+        fs::create_directories(path);
+    }
+
+    ~TempDirectory() {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+
+    fs::path path = fs::temp_directory_path() / "state_saver_tests";
+};
+
+std::vector<std::string> ReadSessions(const fs::path& path) {
+    const auto snapshot = serde::snapshot::MappedSnapshot::Open(path);
+    REQUIRE(snapshot);
+    return {snapshot->GetSessions().begin(), snapshot->GetSessions().end()};
+}
+
+} // namespace
+
+SCENARIO("Snapshots are published by the background thread", TAG) {
+    GIVEN("a state saver") {
+        TempDirectory directory;
+        const fs::path state_file = directory.path / "state";
+        app::StateSaver saver(state_file, 2);
+        CHECK_FALSE(saver.GetSnapshotAge());
+
+        WHEN("snapshots are enqueued and flushed") {
+            const auto captured_at = Clock::now();
+            saver.Enqueue({"first"}, captured_at - 1s);
+            saver.Enqueue({"second", "third"}, captured_at);
+            saver.Flush();
+
+            THEN("the latest snapshot is in the state file") {
+                CHECK(
+                    ReadSessions(state_file) ==
+                    std::vector{"second"s, "third"s}
+                );
+                CHECK_FALSE(fs::exists(fs::path(state_file) += ".tmp"));
+            }
+
+            THEN("the snapshot age counts from its capture") {
+                const auto age = saver.GetSnapshotAge();
+                REQUIRE(age);
+                CHECK(*age >= Clock::now() - captured_at - 1ms);
+                CHECK(*age < 1s);
+            }
+
+            THEN("buffers of a written snapshot are reused") {
+                CHECK_FALSE(saver.TakeBuffers().empty());
+                CHECK(saver.TakeBuffers().empty());
+            }
+        }
+
+        WHEN("a snapshot is written synchronously after enqueued ones") {
+            saver.Enqueue({"old"}, Clock::now());
+            saver.Write({"new"}, Clock::now());
+
+            THEN("the written snapshot is not overwritten") {
+                CHECK(ReadSessions(state_file) == std::vector{"new"s});
+            }
+        }
+    }
+
+    GIVEN("a saver that is destroyed with pending snapshots") {
+        TempDirectory directory;
+        const fs::path state_file = directory.path / "state";
+        {
+            app::StateSaver saver(state_file, 1);
+            for (int i = 0; i < 10; ++i) {
+                saver.Enqueue({std::to_string(i)}, Clock::now());
+            }
+        }
+
+        THEN("the last snapshot is written") {
+            CHECK(ReadSessions(state_file) == std::vector{"9"s});
+        }
+    }
+}
@@ -0,0 +1,216 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <variant>
+
+#include "utils/path.h"
+#include "web/static_content.h"
+
+namespace fs = std::filesystem;
+namespace http = web::http;
+
+namespace {
+
+const std::string TAG = "[StaticContent]";
+
+// Каталог со статическими файлами, удаляемый после теста
+class StaticRoot {
+  public:
+    StaticRoot() :
+        path_(fs::temp_directory_path() /
+              ("static_content_" + std::to_string(std::random_device()()))) {
+        fs::create_directories(path_ / "js");
+    }
+
+    ~StaticRoot() {
+        fs::remove_all(path_);
+    }
+
+    void AddFile(const std::string& name, const std::string& content) {
+        std::ofstream(path_ / name, std::ios::binary) << content;
+    }
+
+    const fs::path& GetPath() const {
+        return path_;
+    }
+
+  private:
+    fs::path path_;
+};
+
+std::string MakeScript(size_t size) {
+    std::string result;
+    while (result.size() < size) {
+        result += "function f" + std::to_string(result.size()) + "() {}\n";
+    }
+    return result;
+}
+
+web::StringRequest MakeRequest(const std::string& target) {
+    web::StringRequest req(http::verb::get, target, 11);
+    req.keep_alive(true);
+    return req;
+}
+
+template <typename Response>
+const Response& Get(const web::StaticResponse& res) {
+    REQUIRE(std::holds_alternative<Response>(res));
+    return std::get<Response>(res);
+}
+
+} // namespace
+
+SCENARIO("Static content is served from memory", TAG) {
+    GIVEN("a static root with an index page and a script") {
+        StaticRoot root;
+        const std::string script = MakeScript(10'000);
+        root.AddFile("index.html", "<html></html>");
+        root.AddFile("js/game.js", script);
+        web::StaticContent content(root.GetPath());
+
+        THEN("files are found by request paths") {
+            CHECK(content.Size() == 2);
+            CHECK(content.Find("/js/game.js"));
+            CHECK(content.Find("/") == content.Find("/index.html"));
+            CHECK_FALSE(content.Find("/js"));
+            CHECK_FALSE(content.Find("/missing.js"));
+            CHECK(web::GetStaticPath("/js/game%2Ejs?v=1") == "/js/game.js");
+        }
+
+        const auto& file = *content.Find("/js/game.js");
+
+        WHEN("the script is requested") {
+            auto res = Get<web::SharedStringResponse>(
+                web::MakeStaticResponse(MakeRequest("/js/game.js"), file)
+            );
+
+            THEN("it is sent with caching headers and without a copy") {
+                CHECK(res.result() == http::status::ok);
+                CHECK(res.body() == file.content.body);
+                CHECK(res[http::field::content_type] == "text/javascript");
+                CHECK(res[http::field::etag] == file.content.etag);
+                CHECK(res.count(http::field::last_modified) == 1);
+                CHECK(res.count(http::field::cache_control) == 1);
+            }
+        }
+
+        WHEN("the script is requested with gzip") {
+            auto req = MakeRequest("/js/game.js");
+            req.set(http::field::accept_encoding, "gzip, deflate");
+            auto res = Get<web::SharedStringResponse>(
+                web::MakeStaticResponse(req, file)
+            );
+
+            THEN("the compressed copy is sent") {
+                CHECK(res[http::field::content_encoding] == "gzip");
+                CHECK(res.body() == file.content.gzip_body);
+                CHECK(res[http::field::etag] == file.content.gzip_etag);
+            }
+        }
+
+        WHEN("the client already has the script") {
+            auto req = MakeRequest("/js/game.js");
+            req.set(http::field::if_none_match, file.content.etag);
+            auto res = Get<web::SharedStringResponse>(
+                web::MakeStaticResponse(req, file)
+            );
+
+            THEN("the body is not sent") {
+                CHECK(res.result() == http::status::not_modified);
+                CHECK_FALSE(res.body());
+            }
+        }
+
+        WHEN("a part of the script is requested") {
+            auto req = MakeRequest("/js/game.js");
+            req.set(http::field::range, "bytes=100-199");
+            auto res = Get<web::StringResponse>(
+                web::MakeStaticResponse(req, file)
+            );
+
+            THEN("only that part is sent") {
+                CHECK(res.result() == http::status::partial_content);
+                CHECK(res.body() == script.substr(100, 100));
+                CHECK(
+                    res[http::field::content_range] ==
+                    "bytes 100-199/" + std::to_string(script.size())
+                );
+            }
+        }
+
+        WHEN("the tail of the script or a range past its end is requested") {
+            auto req = MakeRequest("/js/game.js");
+            req.set(http::field::range, "bytes=-10");
+            auto tail = Get<web::StringResponse>(
+                web::MakeStaticResponse(req, file)
+            );
+            req.set(http::field::range, "bytes=100000-");
+            auto past_end = Get<web::StringResponse>(
+                web::MakeStaticResponse(req, file)
+            );
+
+            THEN("the tail is sent and the range past the end is refused") {
+                CHECK(tail.body() == script.substr(script.size() - 10));
+                CHECK(
+                    past_end.result() == http::status::range_not_satisfiable
+                );
+                CHECK(past_end.body().empty());
+            }
+        }
+
+        WHEN("the script is requested with HEAD") {
+            auto req = MakeRequest("/js/game.js");
+            req.method(http::verb::head);
+            auto res = Get<web::SharedStringResponse>(
+                web::MakeStaticResponse(req, file)
+            );
+
+            THEN("only its headers are sent") {
+                CHECK(res.result() == http::status::ok);
+                CHECK_FALSE(res.body());
+                CHECK(
+                    res[http::field::content_length] ==
+                    std::to_string(script.size())
+                );
+            }
+        }
+    }
+}
+
+TEST_CASE("Static file serving cost", TAG + "[.][benchmark]") {
+    StaticRoot root;
+    root.AddFile("js/three.js", MakeScript(1'000'000));
+    web::StaticContent content(root.GetPath());
+    const std::string root_path = root.GetPath().string();
+
+    // Прежний путь: проверки файловой системы и чтение файла целиком
+    BENCHMARK("disk read per request") {
+        fs::path path = root_path + web::GetStaticPath("/js/three.js");
+        if (fs::is_directory(path)) {
+            path /= "index.html";
+        }
+        if (!utils::IsSubPath(path, root_path)) {
+            return size_t(0);
+        }
+        std::ifstream file(path, std::ios::binary);
+        return std::string(
+                   std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>()
+        )
+            .size();
+    };
+
+    BENCHMARK("in-memory static content") {
+        const auto* file = content.Find(web::GetStaticPath("/js/three.js"));
+        return std::get<web::SharedStringResponse>(
+                   web::MakeStaticResponse(MakeRequest("/js/three.js"), *file)
+        )
+            .body()
+            ->size();
+    };
+}
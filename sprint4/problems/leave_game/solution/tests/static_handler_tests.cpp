@@ -0,0 +1,131 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <boost/asio/buffer.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "handlers/static_handler.h"
+#include "web/request_arena.h"
+
+namespace fs = std::filesystem;
+namespace http = web::http;
+
+namespace {
+
+const std::string TAG = "[StaticHandler]";
+
+// Ресурс, затирающий освобождённую память. Память возвращается в кучу
+// только при разрушении ресурса, поэтому обращение к освобождённому
+// запросу читает мусор вместо чужих данных
+class PoisoningResource : public std::pmr::memory_resource {
+  public:
+    ~PoisoningResource() {
+        for (const auto& block : freed_) {
+            std::pmr::new_delete_resource()->deallocate(
+                block.ptr, block.bytes, block.alignment
+            );
+        }
+    }
+
+  private:
+    struct Block {
+        void* ptr;
+        size_t bytes;
+        size_t alignment;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        std::memset(ptr, 0xdd, bytes);
+        freed_.push_back({ptr, bytes, alignment});
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::vector<Block> freed_;
+};
+
+// Каталог со статическими файлами, удаляемый после теста
+class StaticRoot {
+  public:
+    StaticRoot() :
+        path_(fs::temp_directory_path() /
+              ("static_handler_" + std::to_string(std::random_device()()))) {
+        fs::create_directories(path_);
+        std::ofstream(path_ / "index.html", std::ios::binary)
+            << "<html></html>";
+    }
+
+    ~StaticRoot() {
+        fs::remove_all(path_);
+    }
+
+    std::string GetPath() const {
+        return path_.string();
+    }
+
+  private:
+    fs::path path_;
+};
+
+web::StringRequest Parse(const std::string& text, web::RequestAllocator alloc) {
+    web::RequestParser parser(
+        std::piecewise_construct, std::make_tuple(alloc), std::make_tuple(alloc)
+    );
+
+    web::beast::error_code ec;
+    auto buffer = boost::asio::buffer(text);
+    while (!ec && !parser.is_done()) {
+        const size_t used = parser.put(buffer, ec);
+        buffer += used;
+    }
+    REQUIRE_FALSE(ec);
+    return parser.release();
+}
+
+} // namespace
+
+SCENARIO("Static requests are destroyed before the response is sent", TAG) {
+    GIVEN("a request larger than the inline arena buffer") {
+        StaticRoot root;
+        const handlers::StaticHandler handler(root.GetPath());
+
+        PoisoningResource heap;
+        web::RequestArenaPool pool(&heap);
+        auto& arena = pool.Acquire(0);
+        const std::string cookie(web::RequestArena::inline_size + 1024, 'c');
+        auto req = Parse(
+            "GET /index.html HTTP/1.1\r\n"
+            "Host: localhost:8080\r\n"
+            "Cookie: " + cookie + "\r\n"
+            "Accept: */*\r\n"
+            "\r\n",
+            arena.GetAllocator()
+        );
+
+        WHEN("the arena is released as soon as the response is sent") {
+            // Так поступает web::SessionBase, получив ответ
+            unsigned status = 0;
+            handler(std::move(req), [&](auto&& res) {
+                pool.Release(0);
+                status = res.result_int();
+            });
+
+            THEN("the request no longer refers to the released arena") {
+                CHECK(status == 200);
+            }
+        }
+    }
+}
@@ -0,0 +1,132 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "utils/timing_wheel.h"
+
+using namespace std::literals;
+using Time = utils::TimingWheel<size_t>::Time;
+
+namespace {
+
+const std::string TAG = "[TimingWheel]";
+
+} // namespace
+
+SCENARIO("Timing wheel", TAG) {
+    GIVEN("a wheel") {
+        utils::TimingWheel<size_t> wheel;
+
+        WHEN("entries are scheduled over a wide range of deadlines") {
+            std::mt19937_64 engine(42);
+            std::vector<Time> deadlines;
+            for (size_t i = 0; i < 5000; ++i) {
+                // До десяти часов, то есть дальше верхнего уровня колеса
+                const auto bits = engine() % 26;
+                deadlines.push_back(Time(engine() % (uint64_t(1) << bits)));
+                wheel.Schedule(deadlines.back(), i);
+            }
+
+            THEN("each entry expires once, on the step covering its deadline") {
+                std::vector<int> expired_count(deadlines.size());
+                Time previous = wheel.GetNow();
+                size_t wrong_step = 0;
+                while (wheel.Size() > 0) {
+                    const Time now = previous + Time(1 + engine() % 200'000);
+                    wheel.Advance(now, [&](size_t index) {
+                        ++expired_count[index];
+                        const bool in_step =
+                            (deadlines[index] > previous ||
+                             deadlines[index] == 0ms) &&
+                            deadlines[index] <= now;
+                        wrong_step += !in_step;
+                    });
+                    CHECK(wheel.GetNow() == now);
+                    previous = now;
+                }
+
+                CHECK(wrong_step == 0);
+                CHECK(
+                    std::count(expired_count.begin(), expired_count.end(), 1)
+                    == static_cast<long>(deadlines.size())
+                );
+            }
+        }
+
+        WHEN("an entry is rescheduled while the wheel advances") {
+            wheel.Advance(1000ms, [](size_t) {});
+            wheel.Schedule(1500ms, 1);
+
+            std::vector<Time> expired_at;
+            wheel.Advance(10s, [&](size_t value) {
+                expired_at.push_back(wheel.GetNow());
+                if (value < 3) {
+                    wheel.Schedule(wheel.GetNow() + 2s, value + 1);
+                }
+            });
+
+            THEN("the new entry expires in the same call") {
+                CHECK(expired_at == std::vector {1500ms, 3500ms, 5500ms});
+                CHECK(wheel.Size() == 0);
+            }
+        }
+
+        WHEN("an entry is scheduled in the past") {
+            wheel.Advance(1s, [](size_t) {});
+            wheel.Schedule(500ms, 7);
+
+            THEN("it expires on the next advance") {
+                std::vector<size_t> expired;
+                wheel.Advance(1s, [&](size_t value) {
+                    expired.push_back(value);
+                });
+                CHECK(expired == std::vector<size_t> {7});
+            }
+        }
+    }
+}
+
+TEST_CASE("Inactivity check cost per tick", TAG + "[.][benchmark]") {
+    constexpr size_t dogs_count = 50'000;
+    constexpr auto tick = 50ms;
+    constexpr auto max_inactive_time = 60s;
+
+    // Бездействие собак равномерно распределено в пределах лимита
+    std::mt19937_64 engine(1);
+    std::vector<int64_t> inactive_ms(dogs_count);
+    for (auto& value : inactive_ms) {
+        value = engine() % max_inactive_time.count();
+    }
+
+    BENCHMARK("scan of all dogs") {
+        size_t expired = 0;
+        for (auto& value : inactive_ms) {
+            value += tick.count();
+            if (value >= max_inactive_time.count()) {
+                value = 0;
+                ++expired;
+            }
+        }
+        return expired;
+    };
+
+    utils::TimingWheel<size_t> wheel;
+    for (size_t i = 0; i < dogs_count; ++i) {
+        wheel.Schedule(max_inactive_time - Time(inactive_ms[i]), i);
+    }
+
+    BENCHMARK("timing wheel") {
+        size_t expired = 0;
+        const Time now = wheel.GetNow() + tick;
+        wheel.Advance(now, [&](size_t index) {
+            wheel.Schedule(now + max_inactive_time, index);
+            ++expired;
+        });
+        return expired;
+    };
+}
@@ -0,0 +1,253 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "app/token_table.h"
+#include "utils/epoch.h"
+
+using namespace app;
+
+namespace {
+
+const std::string TAG = "[TokenTable]";
+
+std::vector<Token> MakeKeys(size_t count, uint64_t seed) {
+    std::mt19937_64 engine(seed);
+    std::vector<Token> keys(count);
+    for (auto& key : keys) {
+        key = Token {engine(), engine()};
+    }
+    return keys;
+}
+
+// Таблица токенов на std::unordered_map со строковыми ключами под
+// разделяемой блокировкой - для сравнения в бенчмарках
+class LockedStringTable {
+  public:
+    void InsertOrAssign(const Token& key, size_t value) {
+        std::lock_guard lock(mutex_);
+        values_[key.ToString()] = value;
+    }
+
+    bool Erase(const Token& key) {
+        std::lock_guard lock(mutex_);
+        return values_.erase(key.ToString()) != 0;
+    }
+
+    std::optional<size_t> Find(const std::string& token) const {
+        std::shared_lock lock(mutex_);
+        if (auto it = values_.find(token); it != values_.end()) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+  private:
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, size_t> values_;
+};
+
+// Запускает readers потоков, каждый из которых ищет lookups_per_reader
+// ключей, пока писатель добавляет и удаляет другие ключи. Возвращает
+// количество найденных ключей
+template <typename Table, typename Lookup>
+size_t RunConcurrentLookups(
+    Table& table, const std::vector<Token>& churn_keys, unsigned readers,
+    size_t lookups_per_reader, Lookup&& lookup
+) {
+    std::atomic_bool stop = false;
+    std::atomic<size_t> found = 0;
+
+    std::jthread writer([&] {
+        size_t i = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            const Token& key = churn_keys[i % churn_keys.size()];
+            table.InsertOrAssign(key, i);
+            table.Erase(key);
+            ++i;
+        }
+    });
+
+    {
+        std::vector<std::jthread> threads;
+        for (unsigned r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r] {
+                size_t local_found = 0;
+                for (size_t i = 0; i < lookups_per_reader; ++i) {
+                    local_found += lookup(r + i * readers);
+                }
+                found += local_found;
+            });
+        }
+    }
+
+    stop = true;
+    return found;
+}
+
+} // namespace
+
+SCENARIO("Token table", TAG) {
+    GIVEN("an empty table") {
+        TokenTable<std::string> table;
+        const Token key {1, 2};
+
+        THEN("nothing is found") {
+            CHECK_FALSE(table.Find(key));
+            CHECK(table.Size() == 0);
+        }
+
+        WHEN("a value is inserted") {
+            table.InsertOrAssign(key, "value");
+
+            THEN("it is found by its key only") {
+                CHECK(table.Find(key) == "value");
+                CHECK_FALSE(table.Find(Token {2, 1}));
+                CHECK(table.Size() == 1);
+            }
+
+            AND_WHEN("it is reassigned") {
+                table.InsertOrAssign(key, "other");
+
+                THEN("the new value is found") {
+                    CHECK(table.Find(key) == "other");
+                    CHECK(table.Size() == 1);
+                }
+            }
+
+            AND_WHEN("it is erased") {
+                CHECK(table.Erase(key));
+
+                THEN("it is not found anymore") {
+                    CHECK_FALSE(table.Find(key));
+                    CHECK_FALSE(table.Erase(key));
+                    CHECK(table.Size() == 0);
+                }
+            }
+        }
+
+        WHEN("many values are inserted and some of them erased") {
+            const auto keys = MakeKeys(10'000, 42);
+            for (size_t i = 0; i < keys.size(); ++i) {
+                table.InsertOrAssign(keys[i], std::to_string(i));
+            }
+            for (size_t i = 0; i < keys.size(); i += 2) {
+                table.Erase(keys[i]);
+            }
+
+            THEN("the rest is found") {
+                CHECK(table.Size() == keys.size() / 2);
+                for (size_t i = 0; i < keys.size(); ++i) {
+                    INFO("key index: " << i);
+                    if (i % 2 == 0) {
+                        CHECK_FALSE(table.Find(keys[i]));
+                    } else {
+                        CHECK(table.Find(keys[i]) == std::to_string(i));
+                    }
+                }
+
+                size_t visited = 0;
+                table.ForEach([&](const Token&, const std::string&) {
+                    ++visited;
+                });
+                CHECK(visited == keys.size() / 2);
+            }
+        }
+    }
+}
+
+TEST_CASE("Token table is read while being modified", TAG) {
+    TokenTable<size_t> table;
+    const auto stable_keys = MakeKeys(1000, 1);
+    const auto churn_keys = MakeKeys(1000, 2);
+    for (size_t i = 0; i < stable_keys.size(); ++i) {
+        table.InsertOrAssign(stable_keys[i], i);
+    }
+
+    std::atomic<size_t> mismatches = 0;
+    const size_t found = RunConcurrentLookups(
+        table, churn_keys, 4, 50'000,
+        [&](size_t i) {
+            const size_t index = i % stable_keys.size();
+            const auto value = table.Find(stable_keys[index]);
+            if (value != index) {
+                ++mismatches;
+            }
+            return value.has_value();
+        }
+    );
+
+    CHECK(mismatches == 0);
+    CHECK(found == 4 * 50'000);
+    CHECK(table.Size() == stable_keys.size());
+
+    // Без читателей все отложенные объекты освобождаются за две эпохи
+    utils::epoch::CollectAll();
+    CHECK(utils::epoch::PendingCount() == 0);
+}
+
+TEST_CASE("Erased values are released by the table destructor", TAG) {
+    auto value = std::make_shared<int>(1);
+    const std::weak_ptr<int> observer = value;
+    {
+        TokenTable<std::shared_ptr<int>> table;
+        table.InsertOrAssign(Token {1, 2}, std::move(value));
+        CHECK(table.Erase(Token {1, 2}));
+        CHECK_FALSE(observer.expired());
+    }
+    CHECK(observer.expired());
+    CHECK(utils::epoch::PendingCount() == 0);
+}
+
+TEST_CASE("Token lookup under concurrent readers", TAG + "[.][benchmark]") {
+    constexpr size_t players_count = 50'000;
+    constexpr size_t lookups_per_reader = 100'000;
+
+    const auto keys = MakeKeys(players_count, 1);
+    const auto churn_keys = MakeKeys(1000, 2);
+    std::vector<std::string> tokens;
+    for (const auto& key : keys) {
+        tokens.push_back(key.ToString());
+    }
+
+    TokenTable<size_t> table;
+    LockedStringTable locked_table;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        table.InsertOrAssign(keys[i], i);
+        locked_table.InsertOrAssign(keys[i], i);
+    }
+
+    for (unsigned readers : {1u, 2u, 4u, 8u}) {
+        const auto suffix = ", readers: " + std::to_string(readers);
+
+        BENCHMARK("token table" + suffix) {
+            return RunConcurrentLookups(
+                table, churn_keys, readers, lookups_per_reader,
+                [&](size_t i) {
+                    const auto& token = tokens[i % tokens.size()];
+                    const auto key = Token::Parse(token);
+                    return table.Find(*key).has_value();
+                }
+            );
+        };
+
+        BENCHMARK("shared_mutex + unordered_map<string>" + suffix) {
+            return RunConcurrentLookups(
+                locked_table, churn_keys, readers, lookups_per_reader,
+                [&](size_t i) {
+                    const auto& token = tokens[i % tokens.size()];
+                    return locked_table.Find(token).has_value();
+                }
+            );
+        };
+    }
+}
@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "app/controllers/player_controller.h"
+#include "app/token.h"
+
+using namespace app;
+
+namespace {
+
+const std::string TAG = "[Token]";
+
+// Прежний способ создания токена - для сравнения в бенчмарках
+std::string GenerateTokenString(std::mt19937_64& engine) {
+    std::stringstream ss;
+    for (int i = 0; i < 2; ++i) {
+        ss << std::setfill('0') << std::setw(16) << std::hex << engine();
+    }
+    return ss.str();
+}
+
+} // namespace
+
+TEST_CASE("Tokens are parsed from and formatted to hex", TAG) {
+    const std::string text = "0123456789abcdeffedcba9876543210";
+    const auto token = Token::Parse(text);
+
+    REQUIRE(token);
+    CHECK(token->GetHigh() == 0x0123456789abcdefull);
+    CHECK(token->GetLow() == 0xfedcba9876543210ull);
+    CHECK(token->ToString() == text);
+    CHECK(Token {0, 1}.ToString() == "00000000000000000000000000000001");
+
+    CHECK_FALSE(Token::Parse(""));
+    CHECK_FALSE(Token::Parse(text.substr(1)));
+    CHECK_FALSE(Token::Parse(text + "0"));
+    CHECK_FALSE(Token::Parse("0123456789ABCDEFfedcba9876543210"));
+    CHECK_FALSE(Token::Parse("0123456789abcdeffedcba987654321g"));
+
+    static_assert(
+        Token::Parse("0000000000000000000000000000002a") == Token {0, 42}
+    );
+}
+
+TEST_CASE("Tokens are found by their text", TAG) {
+    std::unordered_map<Token, int, TokenHasher, TokenEqual> values;
+    values[Token {1, 2}] = 3;
+
+    const std::string_view text = "00000000000000010000000000000002";
+    REQUIRE(values.find(text) != values.end());
+    CHECK(values.find(text)->second == 3);
+    CHECK(values.find(std::string_view("not a token")) == values.end());
+}
+
+TEST_CASE("Players controller generates unique tokens", TAG) {
+    PlayersController players;
+    std::unordered_map<Token, PlayerHolder, TokenHasher, TokenEqual> tokens;
+    for (size_t i = 0; i < 1000; ++i) {
+        auto player = std::make_shared<Player>(Player::Id(i), "player");
+        const Token token = players.AddPlayer(player);
+        CHECK(tokens.emplace(token, player).second);
+        CHECK(players.FindPlayerBy(token) == player);
+    }
+}
+
+TEST_CASE("Token hot paths", TAG + "[.][benchmark]") {
+    constexpr size_t players_count = 10'000;
+    constexpr std::string_view bearer_prefix = "Bearer ";
+
+    std::mt19937_64 engine(1);
+
+    BENCHMARK("join: stringstream token") {
+        return GenerateTokenString(engine);
+    };
+
+    BENCHMARK("join: 128-bit token") {
+        return Token {engine(), engine()};
+    };
+
+    BENCHMARK_ADVANCED("join: players controller")(
+        Catch::Benchmark::Chronometer meter
+    ) {
+        PlayersController players;
+        std::vector<PlayerHolder> joining;
+        for (int i = 0; i < meter.runs(); ++i) {
+            joining.push_back(
+                std::make_shared<Player>(Player::Id(i), "player")
+            );
+        }
+        meter.measure([&](int i) {
+            return players.AddPlayer(joining[i]);
+        });
+    };
+
+    // Заголовки Authorization и таблицы игроков для проверки токена
+    std::vector<std::string> headers;
+    std::unordered_map<std::string, size_t> string_players;
+    TokenTable<size_t> token_players;
+    for (size_t i = 0; i < players_count; ++i) {
+        const Token token {engine(), engine()};
+        headers.push_back(std::string(bearer_prefix) + token.ToString());
+        string_players.emplace(token.ToString(), i);
+        token_players.InsertOrAssign(token, i);
+    }
+
+    size_t request = 0;
+    BENCHMARK("auth: string copy + unordered_map<string>") {
+        std::string_view header = headers[request++ % headers.size()];
+        header.remove_prefix(bearer_prefix.size());
+        const std::string token(header);
+        return string_players.find(token) != string_players.end();
+    };
+
+    BENCHMARK("auth: parse + token table") {
+        std::string_view header = headers[request++ % headers.size()];
+        header.remove_prefix(bearer_prefix.size());
+        const auto token = Token::Parse(header);
+        return token && token_players.Find(*token).has_value();
+    };
+}
@@ -0,0 +1,136 @@
+import argparse
+import asyncio
+import multiprocessing
+import os
+import resource
+import shlex
+import socket
+import subprocess
+import time
+
+HOST = 'localhost'
+PORT = 8080
+
+REQUEST = (f'GET /api/v1/maps HTTP/1.1\r\n'
+           f'Host: {HOST}:{PORT}\r\n'
+           f'\r\n').encode()
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description='Compares throughput of the game server IO modes with '
+                    'many concurrent keep-alive connections')
+    parser.add_argument('server', type=str,
+                        help='command line that starts the server, '
+                             'without --io-mode')
+    parser.add_argument('--modes', type=str, default='shared,per-core',
+                        help='comma separated IO modes to measure')
+    parser.add_argument('--connections', type=int, default=10000)
+    parser.add_argument('--clients', type=int,
+                        default=max(2, os.cpu_count() // 2))
+    parser.add_argument('--duration', type=float, default=10.0)
+    return parser.parse_args()
+
+
+def raise_open_files_limit(count):
+    soft, hard = resource.getrlimit(resource.RLIMIT_NOFILE)
+    wanted = count + 100
+    if soft < wanted:
+        resource.setrlimit(resource.RLIMIT_NOFILE, (min(wanted, hard), hard))
+
+
+def run_server(command, mode):
+    return subprocess.Popen(
+        shlex.split(command) + ['--io-mode', mode],
+        stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+
+def stop_server(server):
+    server.terminate()
+    server.wait()
+
+
+def wait_for_port(timeout=10.0):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        try:
+            with socket.create_connection((HOST, PORT), timeout=0.5):
+                return
+        except OSError:
+            time.sleep(0.1)
+    raise RuntimeError('Server has not started')
+
+
+async def read_response(reader):
+    headers = await reader.readuntil(b'\r\n\r\n')
+    length = 0
+    for line in headers.split(b'\r\n'):
+        name, _, value = line.partition(b':')
+        if name.strip().lower() == b'content-length':
+            length = int(value)
+    await reader.readexactly(length)
+
+
+async def connection(deadline, counter):
+    reader, writer = await asyncio.open_connection(HOST, PORT)
+    try:
+        while time.monotonic() < deadline:
+            writer.write(REQUEST)
+            await read_response(reader)
+            counter[0] += 1
+    finally:
+        writer.close()
+
+
+async def run_connections(count, duration):
+    counter = [0]
+    deadline = time.monotonic() + duration
+    results = await asyncio.gather(
+        *(connection(deadline, counter) for _ in range(count)),
+        return_exceptions=True)
+    errors = sum(isinstance(result, Exception) for result in results)
+    return counter[0], errors
+
+
+def client(count, duration, result):
+    raise_open_files_limit(count)
+    result.put(asyncio.run(run_connections(count, duration)))
+
+
+def measure(args, mode):
+    server = run_server(args.server, mode)
+    try:
+        wait_for_port()
+
+        result = multiprocessing.Queue()
+        per_client = [args.connections // args.clients] * args.clients
+        per_client[0] += args.connections % args.clients
+        clients = [
+            multiprocessing.Process(
+                target=client, args=(count, args.duration, result))
+            for count in per_client
+        ]
+        for process in clients:
+            process.start()
+        done, errors = 0, 0
+        for _ in clients:
+            client_done, client_errors = result.get()
+            done += client_done
+            errors += client_errors
+        for process in clients:
+            process.join()
+        return done / args.duration, errors
+    finally:
+        stop_server(server)
+
+
+def main():
+    args = parse_args()
+    print(f'{"mode":>8} {"connections":>11} {"rps":>10} {"errors":>7}')
+    for mode in args.modes.split(','):
+        rps, errors = measure(args, mode)
+        print(f'{mode:>8} {args.connections:>11} {rps:>10.0f} {errors:>7}')
+
+
+if __name__ == '__main__':
+    main()
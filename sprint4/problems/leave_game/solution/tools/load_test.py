@@ -0,0 +1,133 @@
+import argparse
+import http.client
+import json
+import multiprocessing
+import os
+import random
+import shlex
+import socket
+import subprocess
+import time
+
+HOST = 'localhost'
+PORT = 8080
+SEED = 123456789
+
+DIRECTIONS = ['L', 'R', 'U', 'D', '']
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description='Measures API throughput of the game server against the '
+                    'number of CPU cores it may use')
+    parser.add_argument('server', type=str,
+                        help='command line that starts the server')
+    parser.add_argument('--cores', type=str, default='1,2,4,8',
+                        help='comma separated core counts to measure')
+    parser.add_argument('--players', type=int, default=200)
+    parser.add_argument('--clients', type=int,
+                        default=max(2, os.cpu_count() // 2))
+    parser.add_argument('--duration', type=float, default=10.0)
+    return parser.parse_args()
+
+
+def run_server(command, cores):
+    cpu_list = f'0-{cores - 1}'
+    return subprocess.Popen(
+        ['taskset', '-c', cpu_list] + shlex.split(command),
+        stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+
+def stop_server(server):
+    server.terminate()
+    server.wait()
+
+
+def wait_for_port(timeout=10.0):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        try:
+            with socket.create_connection((HOST, PORT), timeout=0.5):
+                return
+        except OSError:
+            time.sleep(0.1)
+    raise RuntimeError('Server has not started')
+
+
+def request(conn, method, target, body=None, token=None):
+    headers = {'Content-Type': 'application/json'}
+    if token:
+        headers['Authorization'] = f'Bearer {token}'
+    conn.request(method, target, body=body, headers=headers)
+    response = conn.getresponse()
+    data = response.read()
+    return response.status, data
+
+
+def join_players(count):
+    conn = http.client.HTTPConnection(HOST, PORT)
+    _, data = request(conn, 'GET', '/api/v1/maps')
+    maps = [m['id'] for m in json.loads(data)]
+
+    tokens = []
+    for i in range(count):
+        body = json.dumps(
+            {'userName': f'player{i}', 'mapId': maps[i % len(maps)]})
+        _, data = request(conn, 'POST', '/api/v1/game/join', body)
+        tokens.append(json.loads(data)['authToken'])
+    conn.close()
+    return tokens
+
+
+def client(tokens, duration, seed, result):
+    rng = random.Random(seed)
+    conn = http.client.HTTPConnection(HOST, PORT)
+    done = 0
+    deadline = time.monotonic() + duration
+    while time.monotonic() < deadline:
+        token = rng.choice(tokens)
+        if rng.random() < 0.5:
+            request(conn, 'GET', '/api/v1/game/state', token=token)
+        else:
+            body = json.dumps({'move': rng.choice(DIRECTIONS)})
+            request(conn, 'POST', '/api/v1/game/player/action', body, token)
+        done += 1
+    conn.close()
+    result.put(done)
+
+
+def measure(args, cores):
+    server = run_server(args.server, cores)
+    try:
+        wait_for_port()
+        tokens = join_players(args.players)
+
+        result = multiprocessing.Queue()
+        clients = [
+            multiprocessing.Process(
+                target=client,
+                args=(tokens, args.duration, SEED + i, result))
+            for i in range(args.clients)
+        ]
+        for process in clients:
+            process.start()
+        total = sum(result.get() for _ in clients)
+        for process in clients:
+            process.join()
+        return total / args.duration
+    finally:
+        stop_server(server)
+
+
+def main():
+    args = parse_args()
+    print(f'{"cores":>5} {"rps":>10} {"speedup":>8}')
+    base = None
+    for cores in map(int, args.cores.split(',')):
+        rps = measure(args, cores)
+        base = base or rps
+        print(f'{cores:>5} {rps:>10.0f} {rps / base:>8.2f}')
+
+
+if __name__ == '__main__':
+    main()